@@ -1,9 +1,16 @@
 #define _POSIX_C_SOURCE 200809L 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h> 
 #include <ctype.h>  
 #include <errno.h>  
+#include <stdarg.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
 struct RoutineInfo
 {
     char day[30];      
@@ -30,19 +37,413 @@ struct StudentResult
     float gpa;
     char grade[5];
 };
+struct StudentFileHeader
+{
+    char magic[8];
+    unsigned int version;
+    unsigned int recordSize; // sizeof(struct StudentRecord) of the writer
+    long long deadCount;     // tombstoned records awaiting compaction
+};
+struct StudentRecord
+{
+    unsigned int state; // STUDENT_RECORD_LIVE or STUDENT_RECORD_DELETED
+    char name[201];
+    char fatherName[100];
+    char motherName[100];
+    char studentID[100];
+    char department[20];
+    char intake[100];
+    char section[100];
+    char presentAddress[200];
+    char permanentAddress[200];
+    char bloodGroup[20];
+    char mobileNumber[20];
+    char backupMobileNumber[20];
+    char email[100];
+};
+#define STUDENT_DATA_FILE "students.dat"
+#define STUDENT_TEXT_FILE "test.txt"
+#define STUDENT_EXPORT_FILE "students_export.txt"
+#define STUDENT_STORE_MAGIC "STUDAT"
+#define STUDENT_STORE_VERSION 1
+#define STUDENT_RECORD_LIVE 1
+#define STUDENT_RECORD_DELETED 2
+#define STUDENT_COMPACT_THRESHOLD 0.25
+#define STUDENT_IMPORT_BATCH 4096
+#define STUDENT_CSV_LINE_SIZE 4096
+#define RESULT_IMPORT_BATCH 4096
+#define RESULT_CSV_COLUMNS 5
+#define RESULT_CSV_LINE_SIZE 1024
+#define EXPORT_BUFFER_SIZE (1 << 20)
+#define EXPORT_CSV 1
+#define EXPORT_JSONL 2
+#define BENCH_SAMPLES 1024
+#define STATS_MAX_OPERATIONS 64
+#define STATS_FILE_ENV "PROJECT_SHOW_STATS_FILE"
+#define SCREEN_BUFFER_SIZE (64 * 1024)
+#define FREE_SLOTS_MAGIC "FREESL"
+#define SCHEDULE_DATA_FILE "schedules.dat"
+#define SCHEDULE_FREE_FILE "schedules.free"
+#define SCHEDULE_STORE_MAGIC "SCHDAT"
+#define SCHEDULE_STORE_VERSION 2 // version 1 was a bare array of AcademicSchedule
+#define SCHEDULE_FREE_MAGIC "SCHFRE"
+#define SCHEDULE_RECORD_LIVE 1
+#define SCHEDULE_TYPE_NAMED 0
+#define SCHEDULE_FIELD_COUNT 9
+#define SCHEDULE_FIELD_TYPE 2
+#define SCHEDULE_HEAP_MAX (SCHEDULE_FIELD_COUNT * 2 + sizeof(struct AcademicSchedule))
+#define SCHEDULE_HEAP_ALIGN 16
+#define RESULT_INDEX_FILE "results.idx"
+#define RESULT_INDEX_MAGIC "RESIDX"
+#define RESULT_STATS_FILE "results.agg"
+#define RESULT_STATS_MAGIC "RESAGG"
+#define GPA_BINS 401
+#define GRADE_COUNT 10
+#define GPA_HISTOGRAM_BUCKETS 17
+#define STUDENT_INDEX_FILE "students.idx"
+#define STUDENT_INDEX_MAGIC "STUIDX"
+#define ROSTER_INDEX_FILE "students.ros"
+#define ROSTER_INDEX_MAGIC "STUROS"
+#define SCHEDULE_INDEX_FILE "schedules.idx"
+#define SCHEDULE_INDEX_MAGIC "SCHIDX"
+#define CLASH_INDEX_FILE "schedules.clash"
+#define CLASH_INDEX_MAGIC "SCHCL2" // "SCHCLS" files had no timetable bookings
+#define CLASH_DELTA_MAX 256
+#define CLASH_DEFAULT_MINUTES 60
+#define CLASH_DATED_BASE 1000000LL // first day of the dated timeline, well past the weekly one
+#define MINUTES_PER_DAY 1440
+#define BOOKING_ROOM 'R'
+#define BOOKING_FACULTY 'F'
+#define BOOKING_SLOT 'T' // every routine entry's time, whatever its room and faculty
+#define SCHEDULE_BOOKINGS_MAX 21 // a room, a faculty and a slot on each of seven days
+#define BOOKING_TIMELINE_END ((CLASH_DATED_BASE + 5000000LL) * MINUTES_PER_DAY)
+#define ROSTER_KEY_SIZE 256
+#define ROSTER_MIN_ENTRIES 64
+#define ROSTER_MIN_BLOCK 8
+#define ADMIN_PASSWORD 5455778081LL
+#define PASSWORD_ENV "PROJECT_SHOW_PASSWORD"
+#define KEY_FILE_ENV "PROJECT_SHOW_KEY_FILE"
+#define DEFAULT_KEY_FILE "project_show.key"
+#define COMMAND_MAX_ARGS 64
+#define COMMAND_LINE_SIZE 8192
+#define INDEX_VERSION 1
+#define INDEX_KEY_SIZE 128
+#define INDEX_MIN_SLOTS 1024
+#define INDEX_SLOT_EMPTY 0
+#define INDEX_SLOT_USED 1
+#define INDEX_SLOT_DELETED 2
+#define STUDENT_TABLE_MIN_ROWS 1024
+#define TABLE_ROW_NONE -1
+#define TABLE_ROW_DELETED -2
+#define FIELD_ARGS(f) (int)(f).len, (f).ptr
+// Results open with their key field and schedule records with their state byte; a dead one starts with a zero byte.
+#define FIXED_RECORD_DEAD(record) (*(const char *)(record) == '\0')
+#define TABLE_TEXT(t, column, row) ((t)->heap + (t)->column[row])
+#define TABLE_CODE(t, column, row) ((t)->codes.values[(t)->column[row]])
+enum StudentField
+{
+    FIELD_NAME,
+    FIELD_FATHER,
+    FIELD_MOTHER,
+    FIELD_ID,
+    FIELD_DEPARTMENT,
+    FIELD_INTAKE,
+    FIELD_SECTION,
+    FIELD_PRESENT_ADDRESS,
+    FIELD_PERMANENT_ADDRESS,
+    FIELD_BLOOD_GROUP,
+    FIELD_MOBILE,
+    FIELD_BACKUP_MOBILE,
+    FIELD_EMAIL,
+    STUDENT_FIELD_COUNT
+};
+struct FieldView
+{
+    const char *ptr; // points into a mapped file or a StudentRecord, not NUL-terminated
+    size_t len;
+};
+struct StudentRecordView
+{
+    struct FieldView field[STUDENT_FIELD_COUNT];
+    const char *raw; // record lines without the blank separator, inside the mapped text file
+    size_t rawLen;
+    long offset;     // byte offset of raw in the text file
+};
+struct StudentMap
+{
+    char *data;
+    size_t length;
+    int mapped; // 0 when mmap was unavailable and data is a heap copy
+};
+struct StudentScanner
+{
+    struct StudentMap map;
+    size_t pos;
+};
+struct IndexHeader
+{
+    char magic[8];
+    unsigned int version;
+    unsigned int slotCount; // always a power of two
+    unsigned int usedCount;
+    unsigned int deletedCount; // tombstoned slots in a hash index; 0 in the other layouts
+    long long dataSize;     // size and mtime of the data file when the index was last written
+    long long dataModified;
+};
+struct IndexSlot
+{
+    unsigned int hash;
+    unsigned int state;
+    char key[INDEX_KEY_SIZE];
+    long long offset;
+    long long length;
+};
+struct IndexTable
+{
+    struct IndexHeader header;
+    struct IndexSlot *slots;
+};
+struct DiskIndex
+{
+    FILE *file;
+    const char *path;
+    const char *dataPath;
+    struct IndexHeader header;
+};
+// students.ros (and schedules.idx, in the same layout with record offsets) is an IndexHeader, a directory of
+// slotCount RosterEntry (usedCount in use), then one block of record numbers per roster. The directory is
+// small enough to hold in memory and search linearly.
+struct RosterEntry
+{
+    char key[ROSTER_KEY_SIZE]; // "DEPARTMENT|INTAKE|SECTION", or "INTAKE|SECTION|TYPE" for schedules
+    long long blockPos;        // file offset of the roster's record numbers
+    long long count;
+    long long capacity;
+};
+struct RosterIndex
+{
+    FILE *file;
+    const char *dataPath; // the file the index is stamped against
+    struct IndexHeader header;
+    struct RosterEntry *entries;
+};
+// schedules.clash is an IndexHeader, slotCount Booking sorted by resource then start, then usedCount Booking
+// appended since the last rebuild. Weekly bookings start at weekday * 1440 + minute, Sunday first; dated exams
+// at (CLASH_DATED_BASE + days since 1970-01-01) * 1440 + minute.
+struct Booking
+{
+    unsigned int resource; // hashIndexKey of the kind letter and the folded room or faculty name
+    int kind;              // BOOKING_ROOM, BOOKING_FACULTY or BOOKING_SLOT
+    long long start, end;  // minutes on the booking timeline, end exclusive
+    long long maxEnd;      // latest end in this resource's sorted run up to here
+    long long recordPos;   // the schedule record, or -1 once removed
+};
+struct ClashIndex
+{
+    FILE *file;
+    struct IndexHeader header;
+    struct StudentMap map;
+    const struct Booking *sorted; // followed in the map by the usedCount appended bookings
+};
+struct ScheduleClash
+{
+    int kind;
+    long long start, end;               // the overlap
+    long recordPos[2];                  // -1 for an entry not saved yet
+    struct AcademicSchedule entries[2]; // entries[0] is the one checked
+};
+struct TimetableEntry
+{
+    long long start, end; // on the booking timeline
+    long recordPos;
+    struct AcademicSchedule schedule;
+};
+struct FacultyLoad
+{
+    char faculty[100];
+    long long minutes; // taught per week
+    long classes;
+};
+struct CodePool
+{
+    char **values; // code -> interned string
+    unsigned int count;
+    unsigned int capacity;
+    int *slots; // open-addressed hash over values, -1 when empty
+    unsigned int slotCount;
+};
+struct PostingList
+{
+    unsigned int *rows; // ascending
+    unsigned int count;
+    unsigned int capacity;
+};
+// Inverted index from every three-byte run of a student name to the rows whose name contains it.
+struct TrigramIndex
+{
+    unsigned int *slotGram; // gram + 1, so 0 marks an empty slot
+    unsigned int *slotList; // index into lists
+    unsigned int slotCount;
+    struct PostingList *lists;
+    unsigned int listCount;
+    unsigned int listCapacity;
+};
+// Column-per-field view of students.dat kept for the length of a department session.
+struct StudentTable
+{
+    size_t count; // rows ever appended, including deleted ones
+    size_t capacity;
+    size_t liveCount;
+    size_t *idText; // offsets into heap
+    size_t *nameText;
+    size_t *mobileText;
+    unsigned int *deptCode; // codes into the pool
+    unsigned int *intakeCode;
+    unsigned int *sectionCode;
+    long long *recordNumber; // where the row's full record lives in students.dat
+    unsigned char *live;
+    char *heap;
+    size_t heapUsed;
+    size_t heapCapacity;
+    struct CodePool codes;
+    struct TrigramIndex names;
+    long *idSlots; // (department, ID) -> row, or TABLE_ROW_NONE / TABLE_ROW_DELETED
+    size_t idSlotCount;
+    size_t idSlotUsed;
+    long long dataSize; // stamp of students.dat the table reflects
+    long long dataModified;
+    int loaded;
+};
+// A file of fixed-size records whose deleted slots are reused, and the file listing those slots.
+struct FixedStore
+{
+    const char *path;
+    const char *freePath;
+    size_t recordSize;
+};
+struct FreeSlots
+{
+    FILE *file;
+    struct IndexHeader header;
+};
+// schedules.dat is a ScheduleFileHeader followed by variable-length records: a ScheduleRecordHeader, then a heap
+// of SCHEDULE_FIELD_COUNT length-prefixed strings. A record whose state is 0 is a hole listed in schedules.free.
+struct ScheduleFileHeader
+{
+    char magic[8];
+    unsigned int version;
+    unsigned int recordHeaderSize; // sizeof(struct ScheduleRecordHeader) of the writer
+};
+struct ScheduleRecordHeader
+{
+    unsigned char state;     // SCHEDULE_RECORD_LIVE, or 0 for a hole
+    unsigned char type;      // 1 + index into scheduleTypes, or SCHEDULE_TYPE_NAMED with the name in the heap
+    unsigned short length;   // heap bytes in use
+    unsigned short capacity; // heap bytes reserved; the next record starts after them
+};
+struct ScheduleHole
+{
+    long long offset;
+    long long capacity;
+};
+struct RankedResult
+{
+    struct StudentResult result;
+    long rank;
+};
+// results.agg is an IndexHeader (usedCount groups, stamped with results.dat) followed by one GpaStats per
+// intake and section. GPAs are counted in hundredths, so adding and removing a result is exact.
+struct GpaStats
+{
+    char intake[20];
+    char section[20];
+    long long count;
+    long long sum;        // of GPA * 100
+    long long sumSquares; // of (GPA * 100)^2
+    long long grades[GRADE_COUNT]; // in gradeNames order
+    unsigned int bins[GPA_BINS];   // results per GPA hundredth, 0.00 to 4.00
+};
+struct ResultStats
+{
+    FILE *file;
+    struct IndexHeader header;
+    struct GpaStats *groups;
+};
+struct ExportWriter
+{
+    FILE *out;
+    char *buffer; // EXPORT_BUFFER_SIZE bytes, written out whenever it fills
+    size_t used;
+    int format;   // EXPORT_CSV or EXPORT_JSONL
+    int column;   // fields written on the current row
+    int ok;
+    long long rows;
+};
+struct ExportFilter
+{
+    const char *department; // NULL matches anything
+    const char *intake;
+    const char *section;
+};
+struct HotPathCounters
+{
+    long long recordsScanned;
+    long long bytesRead;    // via readData, plus whole files mapped for a scan
+    long long parseCalls;   // text records, CSV rows and command lines parsed
+    long long seeks;
+    long long rewriteBytes; // written to temp files that replace a data file
+};
+struct OperationStats
+{
+    char name[48];
+    long long calls;
+    struct HotPathCounters counters;
+    double wallSeconds, cpuSeconds;
+};
+struct OperationTimer
+{
+    const char *name; // NULL for an operation nested inside another
+    struct HotPathCounters start;
+    double wall, cpu;
+};
+// State shared by the commands of one invocation or command file, so a batch opens each data file once.
+struct CommandContext
+{
+    FILE *students;
+    FILE *schedules;
+    FILE *results;
+    const char *area;
+    const char *action;
+    int argc; // the command's "--name value" options
+    char **argv;
+    long line; // command-file line, 0 for a command given on the command line
+    struct StudentTable names; // loaded by the first "student search", then kept in step with the batch's writes
+};
+struct CommandSpec
+{
+    const char *area;
+    const char *action;
+    const char *options; // space-separated option names the command accepts
+    int (*run)(struct CommandContext *ctx);
+};
 void handleAdmissionPhase(FILE **P_ptr);
-void searchStudentByName(FILE **P_ptr, const char *departmentName);
+void searchStudentByName(FILE **P_ptr, struct StudentTable *table, const char *departmentName);
 void viewStudentsByIntakeSection(FILE **P_ptr, const char *departmentName);
-void deleteStudentById(FILE **P_ptr, const char *departmentName);
-void updateStudentById(FILE **P_ptr, const char *departmentName);
-void addStudent(FILE **P_ptr, const char *departmentName);
-void viewAllStudents(FILE **P_ptr, const char *departmentName);
-void searchStudentById(FILE **P_ptr, const char *departmentName);
+void deleteStudentById(FILE **P_ptr, struct StudentTable *table, const char *departmentName);
+void updateStudentById(FILE **P_ptr, struct StudentTable *table, const char *departmentName);
+void addStudent(FILE **P_ptr, struct StudentTable *table, const char *departmentName);
+void viewAllStudents(FILE **P_ptr, struct StudentTable *table, const char *departmentName);
+void searchStudentById(FILE **P_ptr, struct StudentTable *table, const char *departmentName);
+void compactStudents(FILE **P_ptr, struct StudentTable *table);
+void importStudents(FILE **P_ptr, struct StudentTable *table, const char *departmentName);
 void manageAcademicSchedules(FILE **scheduleFile_ptr);
 void addSchedule(FILE **scheduleFile_ptr);
 void viewSchedule(FILE **scheduleFile_ptr); 
 void updateSchedule(FILE **scheduleFile_ptr);
 void deleteSchedule(FILE **scheduleFile_ptr);
+void viewScheduleClashes(FILE **scheduleFile_ptr);
+void viewTimetable(FILE **scheduleFile_ptr);
+void viewFacultyLoad(FILE **scheduleFile_ptr);
 int isRoutineType(const char *scheduleType); 
 void manageResults(FILE **resultFile_ptr);
 void addResult(FILE **resultFile_ptr);
@@ -50,73 +451,285 @@ void viewIndividualResult(FILE **resultFile_ptr);
 void viewResultList(FILE **resultFile_ptr);
 void updateResult(FILE **resultFile_ptr);
 void deleteResult(FILE **resultFile_ptr);
+void importResults(FILE **resultFile_ptr);
+void viewResultStatistics(FILE **resultFile_ptr);
 void calculateGrade(float gpa, char *grade);
+int gradeIndex(float gpa);
 void pressEnterToContinue();
 void trimWhitespace(char *str);
 void clearInputBuffer();
-int main()
+void initTerminal(void);
+void clearScreen(void);
+char *readLine(char *buffer, int size);
+int readChar(void);
+int scanInput(const char *format, ...);
+int fieldEquals(struct FieldView field, const char *text);
+int fieldContains(struct FieldView field, const char *needle);
+void copyField(struct FieldView field, char *dest, size_t destSize);
+void splitStudentName(struct FieldView name, char *first, size_t firstSize, char *last, size_t lastSize);
+size_t parseStudentRecord(const char *buffer, size_t length, struct StudentRecordView *record);
+int mapStudentFile(FILE *file, struct StudentMap *map, int advice);
+void unmapStudentFile(struct StudentMap *map);
+int openStudentScanner(struct StudentScanner *scanner, FILE *file);
+int nextStudentRecord(struct StudentScanner *scanner, struct StudentRecordView *record);
+void closeStudentScanner(struct StudentScanner *scanner);
+void printStudentDetails(const struct StudentRecordView *record);
+size_t formatStudentRecord(char *dest, size_t destSize, const struct StudentRecordView *record);
+void studentRecordView(const struct StudentRecord *student, struct StudentRecordView *record);
+int fillStudentRecord(struct StudentRecord *student, const struct StudentRecordView *record);
+int fillStudentValues(struct StudentRecord *student, const char *values[STUDENT_FIELD_COUNT]);
+long long studentRecordPos(long long recordNumber);
+FILE *openStudentStore(const char *path);
+int readStudentAt(FILE *file, long long recordNumber, struct StudentRecord *student);
+int writeStudentAt(FILE *file, long long recordNumber, const struct StudentRecord *student);
+int replaceStudentAt(FILE *file, long long recordNumber, const struct StudentRecord *expected, const struct StudentRecord *student);
+long long appendStudent(FILE *file, const struct StudentRecord *student);
+int mapStudentStore(FILE *file, struct StudentMap *map, int advice, const struct StudentRecord **records, long long *count);
+int convertStudentText(const char *textPath, const char *dataPath);
+int exportStudentText(FILE *store, const char *textPath);
+int openExportWriter(struct ExportWriter *writer, FILE *out, int format);
+int closeExportWriter(struct ExportWriter *writer);
+int exportStudents(FILE *store, const struct ExportFilter *filter, struct ExportWriter *writer);
+int exportSchedules(FILE *scheduleFile, const struct ExportFilter *filter, struct ExportWriter *writer);
+int exportResults(FILE *resultFile, const struct ExportFilter *filter, struct ExportWriter *writer);
+unsigned int hashIndexKey(const char *key);
+int getFileStamp(const char *path, long long *size, long long *modified);
+int initIndexTable(struct IndexTable *table, const char *magic, unsigned int expectedEntries);
+void freeIndexTable(struct IndexTable *table);
+struct IndexSlot *indexTableFind(struct IndexTable *table, const char *key);
+int indexTablePut(struct IndexTable *table, const char *key, long long offset, long long length, int replace);
+int indexTableRemove(struct IndexTable *table, const char *key);
+int loadIndexTable(struct IndexTable *table, const char *path, const char *magic);
+int saveIndexTable(struct IndexTable *table, const char *path, const char *dataPath);
+int openDiskIndex(struct DiskIndex *index, const char *path, const char *magic, const char *dataPath);
+void closeDiskIndex(struct DiskIndex *index);
+int diskIndexFind(struct DiskIndex *index, const char *key, struct IndexSlot *found);
+int diskIndexPut(struct DiskIndex *index, const char *key, long long offset, long long length);
+int diskIndexRemove(struct DiskIndex *index, const char *key);
+int makeStudentKey(char *key, const char *departmentName, const char *studentID);
+int rebuildStudentIndex(FILE *studentFile);
+int openStudentIndex(struct DiskIndex *index, FILE *studentFile);
+int fetchStudentRecord(FILE *studentFile, const char *departmentName, const char *studentID, struct StudentRecord *student,
+                       long long *recordNumber);
+int compactStudentStore(FILE **P_ptr, double threshold);
+long findStudentCode(const struct StudentTable *table, const char *value);
+long studentTableAppend(struct StudentTable *table, const struct StudentRecordView *record, long long recordNumber);
+long studentTableFind(const struct StudentTable *table, const char *departmentName, const char *studentID);
+long searchStudentNames(const struct StudentTable *table, long deptCode, const char *needle, unsigned int **rows);
+void studentTableRemove(struct StudentTable *table, long row);
+int studentTableReplace(struct StudentTable *table, long row, const struct StudentRecordView *record);
+void stampStudentTable(struct StudentTable *table);
+int loadStudentTable(struct StudentTable *table, FILE *studentFile);
+void freeStudentTable(struct StudentTable *table);
+int ensureStudentTable(struct StudentTable *table, FILE *studentFile);
+int readStudentRow(const struct StudentTable *table, FILE *studentFile, long row, struct StudentRecord *student);
+int makeRosterKey(char *key, const char *departmentName, const char *intake, const char *section);
+int rebuildRosterIndex(FILE *studentFile);
+int openRosterIndex(struct RosterIndex *roster, FILE *studentFile);
+void closeRosterIndex(struct RosterIndex *roster);
+int stampRosterIndex(struct RosterIndex *roster);
+int rosterIndexAdd(struct RosterIndex *roster, const char *key, long long recordNumber);
+int rosterIndexRemove(struct RosterIndex *roster, const char *key, long long recordNumber);
+long long rosterIndexCollect(struct RosterIndex *roster, const char *key, int prefix, long long **recordNumbers);
+long long insertStudentRecord(FILE *studentFile, const struct StudentRecord *student);
+int updateStudentRecord(FILE *studentFile, long long recordNumber, const struct StudentRecord *original,
+                        const struct StudentRecord *student);
+int tombstoneStudentRecord(FILE *studentFile, long long recordNumber, const struct StudentRecord *student);
+int readCsvRecord(const char *data, size_t length, size_t *pos, char *scratch, size_t scratchSize,
+                  char **fields, int maxFields, long *line);
+int importStudentCsv(FILE *studentFile, const char *departmentName, const char *csvPath, FILE *rejects,
+                     long *imported, long *rejected);
+int benchmarkStudentParser(const char *filename);
+int generateBenchData(long students, unsigned int seed);
+int runBenchmark(long iterations);
+void notice(const char *format, ...);
+void reportError(const char *format, ...);
+void reportSystemError(const char *what);
+int seekData(FILE *file, long long offset, int whence);
+void rewindData(FILE *file);
+size_t readData(void *data, size_t size, size_t count, FILE *file);
+void beginOperation(struct OperationTimer *timer, const char *name);
+void endOperation(struct OperationTimer *timer);
+void resetOperationStats(void);
+void writeOperationStats(FILE *out);
+void dumpOperationStats(void);
+FILE *openDataFile(const char *path);
+FILE *openStudentData(void);
+const char *checkSchedule(const struct AcademicSchedule *schedule);
+int matchSchedule(const void *record, const void *key);
+int matchResult(const void *record, const void *key);
+int findFixedRecord(FILE *file, size_t recordSize, int (*matches)(const void *, const void *), const void *key,
+                    void *record, long *recordPos);
+int writeFixedRecord(FILE *file, long recordPos, const void *record, size_t recordSize);
+int openFreeSlots(struct FreeSlots *slots, FILE *file, const struct FixedStore *store);
+void closeFreeSlots(struct FreeSlots *slots);
+long insertFixedRecord(FILE *file, const struct FixedStore *store, const void *record);
+int deleteFixedRecords(FILE *file, const struct FixedStore *store, const long *positions, long count);
+int appendScheduleRecord(FILE *file, const struct AcademicSchedule *schedule);
+int readScheduleAt(FILE *file, long recordPos, struct ScheduleRecordHeader *header, struct AcademicSchedule *schedule);
+int migrateScheduleStore(const char *path);
+FILE *openScheduleStore(const char *path);
+int mapScheduleStore(FILE *file, struct StudentMap *map, int advice, size_t *pos);
+int nextScheduleRecord(const struct StudentMap *map, size_t *pos, struct AcademicSchedule *schedule, long *recordPos);
+long placeScheduleRecord(FILE *file, const struct AcademicSchedule *schedule);
+int freeScheduleRecords(FILE *file, const long *positions, long count);
+long rewriteScheduleRecord(FILE *file, long recordPos, const struct AcademicSchedule *schedule);
+int makeScheduleKey(char *key, const char *intake, const char *section, const char *scheduleType);
+int rebuildScheduleIndex(FILE *scheduleFile);
+int openScheduleIndex(struct RosterIndex *index, FILE *scheduleFile);
+long fetchScheduleRecords(FILE *scheduleFile, const struct AcademicSchedule *key, int withType,
+                          struct AcademicSchedule **schedules, long **positions);
+int findScheduleRecord(FILE *scheduleFile, const struct AcademicSchedule *key, struct AcademicSchedule *schedule,
+                       long *recordPos);
+int rebuildClashIndex(FILE *scheduleFile);
+int openClashIndex(struct ClashIndex *index, FILE *scheduleFile);
+void closeClashIndex(struct ClashIndex *index);
+long findScheduleClashes(FILE *scheduleFile, const struct AcademicSchedule *schedule, long recordPos,
+                         struct ScheduleClash **clashes);
+long collectScheduleClashes(FILE *scheduleFile, struct ScheduleClash **clashes);
+int timetableRanges(const char *day, long long ranges[][2]);
+long fetchTimetable(FILE *scheduleFile, const char *room, const char *faculty, const char *day,
+                    struct TimetableEntry **entries);
+long collectFacultyLoad(FILE *scheduleFile, const char *faculty, struct FacultyLoad **loads);
+void formatBookingTime(long long start, long long end, char *out, size_t size);
+long insertScheduleRecord(FILE *scheduleFile, const struct AcademicSchedule *schedule);
+long updateScheduleRecord(FILE *scheduleFile, long recordPos, const struct AcademicSchedule *schedule);
+int deleteScheduleRecords(FILE *scheduleFile, const struct AcademicSchedule *key);
+int importResultCsv(FILE *resultFile, const char *csvPath, int upsert, FILE *rejects, long *added, long *updated,
+                    long *rejected);
+long rankResults(FILE *resultFile, const char *intake, const char *section, long topK, struct RankedResult **ranked);
+int makeResultKey(char *key, const struct StudentResult *result);
+int rebuildResultIndex(FILE *resultFile);
+int openResultIndex(struct DiskIndex *index, FILE *resultFile);
+int fetchResultRecord(FILE *resultFile, const struct StudentResult *key, struct StudentResult *result, long *recordPos);
+int rebuildResultStats(FILE *resultFile);
+int openResultStats(struct ResultStats *stats, FILE *resultFile);
+void closeResultStats(struct ResultStats *stats);
+int resultStatsApply(struct ResultStats *stats, const struct StudentResult *removed, const struct StudentResult *added);
+int collectGpaStats(FILE *resultFile, const char *intake, const char *section, struct GpaStats *total);
+double gpaStatsMedian(const struct GpaStats *stats);
+double gpaStatsDeviation(const struct GpaStats *stats);
+void gpaStatsHistogram(const struct GpaStats *stats, long long buckets[GPA_HISTOGRAM_BUCKETS], char labels[][16]);
+int saveResult(FILE *resultFile, long recordPos, const struct StudentResult *original, const struct StudentResult *result);
+int deleteResultRecord(FILE *resultFile, const struct StudentResult *key);
+int isCommandWord(const char *word);
+int runCommand(struct CommandContext *ctx, int argc, char *argv[]);
+int runCommandFile(struct CommandContext *ctx, FILE *input);
+int runCommandMode(int argc, char *argv[]);
+int commandAuthorized(void);
+int flagAuthorized(const char *flag);
+int main(int argc, char *argv[])
 {
+    struct stat dataInfo;
+    if (getenv(STATS_FILE_ENV) != NULL)
+        atexit(dumpOperationStats);
+    if (argc > 1 && isCommandWord(argv[1]))
+    {
+        return runCommandMode(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-parser") == 0)
+    {
+        return benchmarkStudentParser(argc > 2 ? argv[2] : STUDENT_TEXT_FILE);
+    }
+    if (argc > 1 && strcmp(argv[1], "--generate") == 0)
+    {
+        long students = argc > 2 ? strtol(argv[2], NULL, 10) : 10000;
+        if (students <= 0)
+        {
+            reportError("Usage: %s --generate <students> [seed]\n", argv[0]);
+            return 1;
+        }
+        return generateBenchData(students, argc > 3 ? (unsigned int)strtoul(argv[3], NULL, 10) : 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+    {
+        long iterations = argc > 2 ? strtol(argv[2], NULL, 10) : 200;
+        if (iterations <= 0)
+        {
+            reportError("Usage: %s --bench [iterations]\n", argv[0]);
+            return 1;
+        }
+        if (!flagAuthorized(argv[1]))
+            return 1;
+        return runBenchmark(iterations);
+    }
+    if (argc > 1 && strcmp(argv[1], "--convert-students") == 0)
+    {
+        if (stat(STUDENT_DATA_FILE, &dataInfo) == 0)
+        {
+            reportError("Error: %s already exists; move it away before converting again.\n", STUDENT_DATA_FILE);
+            return 1;
+        }
+        return convertStudentText(argc > 2 ? argv[2] : STUDENT_TEXT_FILE, STUDENT_DATA_FILE) ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "--compact-students") == 0)
+    {
+        char *end = NULL;
+        double threshold = argc > 2 ? strtod(argv[2], &end) : STUDENT_COMPACT_THRESHOLD;
+        if (argc > 2 && (end == argv[2] || *end != '\0' || threshold < 0.0 || threshold > 1.0))
+        {
+            reportError("Usage: %s --compact-students [threshold from 0 to 1]\n", argv[0]);
+            return 1;
+        }
+        if (!flagAuthorized(argv[1]))
+            return 1;
+        FILE *store = openStudentStore(STUDENT_DATA_FILE);
+        if (store == NULL)
+        {
+            reportSystemError("Error opening student data file (" STUDENT_DATA_FILE ")");
+            return 1;
+        }
+        int compacted = compactStudentStore(&store, threshold);
+        fclose(store);
+        return compacted < 0 ? 1 : 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--export-students") == 0)
+    {
+        if (!flagAuthorized(argv[1]))
+            return 1;
+        FILE *store = openStudentStore(STUDENT_DATA_FILE);
+        if (store == NULL)
+        {
+            reportSystemError("Error opening student data file (" STUDENT_DATA_FILE ")");
+            return 1;
+        }
+        int ok = exportStudentText(store, argc > 2 ? argv[2] : STUDENT_EXPORT_FILE);
+        fclose(store);
+        return ok ? 0 : 1;
+    }
     FILE *P = NULL;
     FILE *scheduleFile = NULL;
     FILE *resultFile = NULL;
-    P = fopen("test.txt", "a+"); 
+    P = openStudentData();
     if (P == NULL)
     {
-        perror("FATAL: Error opening student data file (test.txt)");
+        reportSystemError("FATAL: Error opening student data file (" STUDENT_DATA_FILE ")");
         return 1;
     }
-    scheduleFile = fopen("schedules.dat", "rb+"); 
+    scheduleFile = openScheduleStore(SCHEDULE_DATA_FILE);
     if (scheduleFile == NULL)
     {
-        if (errno == ENOENT)
-        {                                            
-            scheduleFile = fopen("schedules.dat", "wb+"); 
-            if (scheduleFile == NULL)
-            {
-                perror("FATAL: Error creating schedule data file (schedules.dat)");
-                fclose(P);
-                return 1;
-            }
-        }
-        else
-        { 
-            perror("FATAL: Error opening schedule data file (schedules.dat)");
-            fclose(P);
-            return 1;
-        }
+        reportSystemError("FATAL: Error opening schedule data file (" SCHEDULE_DATA_FILE ")");
+        fclose(P);
+        return 1;
     }
-    resultFile = fopen("results.dat", "rb+"); 
+    resultFile = openDataFile("results.dat");
     if (resultFile == NULL)
     {
-        if (errno == ENOENT)
-        {                                
-            resultFile = fopen("results.dat", "wb+"); 
-            if (resultFile == NULL)
-            {
-                perror("FATAL: Error creating result data file (results.dat)");
-                fclose(P);
-                if (scheduleFile)
-                    fclose(scheduleFile);
-                return 1;
-            }
-        }
-        else
-        { 
-            perror("FATAL: Error opening result data file (results.dat)");
-            fclose(P);
-            if (scheduleFile)
-                fclose(scheduleFile);
-            return 1;
-        }
+        reportSystemError("FATAL: Error opening result data file (results.dat)");
+        fclose(P);
+        fclose(scheduleFile);
+        return 1;
     }
 
     int select;
     long long int pass;
     int running = 1;
 
-    system("clear || cls"); 
+    initTerminal();
+    clearScreen();
     printf("Enter Password: ");
-    if (scanf("%lld", &pass) != 1)
+    if (scanInput("%lld", &pass) != 1)
     {
         printf("Invalid password input format.\n");
         clearInputBuffer(); 
@@ -130,11 +743,11 @@ int main()
     }
     clearInputBuffer(); 
 
-    if (pass == 5455778081)
+    if (pass == ADMIN_PASSWORD)
     {
         while (running)
         {
-            system("clear || cls");
+            clearScreen();
             printf("\n\n\n------------------------ What Do You Want ------------------------\n\n");
             printf("1. Admission Phase Info\n");
             printf("2. Academic Schedule Management\n");
@@ -142,7 +755,7 @@ int main()
             printf("4. Exit\n");
             printf("\nEnter Choice: ");
 
-            if (scanf("%d", &select) != 1)
+            if (scanInput("%d", &select) != 1)
             {
                 printf("Invalid input. Please enter a number (1-4).\n");
                 clearInputBuffer(); 
@@ -159,12 +772,10 @@ int main()
             case 2:
                 if (scheduleFile == NULL)
                 {
-                    scheduleFile = fopen("schedules.dat", "rb+"); 
-                    if (scheduleFile == NULL)
-                        scheduleFile = fopen("schedules.dat", "wb+");
+                    scheduleFile = openScheduleStore(SCHEDULE_DATA_FILE);
                     if (scheduleFile == NULL)
                     {
-                        perror("ERROR: Cannot access schedule file in main loop");
+                        reportSystemError("ERROR: Cannot access schedule file in main loop");
                         pressEnterToContinue();
                         continue; 
                     }
@@ -179,7 +790,7 @@ int main()
                         resultFile = fopen("results.dat", "wb+");
                     if (resultFile == NULL)
                     {
-                        perror("ERROR: Cannot access result file in main loop");
+                        reportSystemError("ERROR: Cannot access result file in main loop");
                         pressEnterToContinue();
                         continue; 
                     }
@@ -190,6 +801,11 @@ int main()
                 printf("Exiting program.\n");
                 running = 0;
                 break;
+            case 99: // unlisted: per-operation counters for this session
+                clearScreen();
+                writeOperationStats(stdout);
+                pressEnterToContinue();
+                break;
             default:
                 printf("Invalid choice (%d). Please enter a number between 1 and 4.\n", select);
                 pressEnterToContinue();
@@ -206,21 +822,21 @@ int main()
     if (P != NULL)
     {
         if (fclose(P) != 0)
-            perror("Error closing student file");
+            reportSystemError("Error closing student file");
         else
             printf("Student file closed.\n");
     }
     if (scheduleFile != NULL)
     {
         if (fclose(scheduleFile) != 0)
-            perror("Error closing schedule file");
+            reportSystemError("Error closing schedule file");
         else
             printf("Schedule file closed.\n");
     }
     if (resultFile != NULL)
     {
         if (fclose(resultFile) != 0)
-            perror("Error closing result file");
+            reportSystemError("Error closing result file");
         else
             printf("Result file closed.\n");
     }
@@ -231,10 +847,51 @@ int main()
 void clearInputBuffer()
 {
     int c;
-    while ((c = getchar()) != '\n' && c != EOF)
+    while ((c = readChar()) != '\n' && c != EOF)
         ;
 }
 
+// Interactive screens are composed in stdout's buffer and reach the terminal in one write, made when the
+// program next waits for input. Every read from stdin therefore goes through the wrappers below.
+static char screenBuffer[SCREEN_BUFFER_SIZE];
+static int terminalIsTty = 0;
+
+void initTerminal(void)
+{
+    terminalIsTty = isatty(STDOUT_FILENO);
+    if (terminalIsTty)
+        setvbuf(stdout, screenBuffer, _IOFBF, sizeof(screenBuffer));
+}
+
+// Starts a new screen: home the cursor and clear with ANSI escapes on a terminal; plain output otherwise.
+void clearScreen(void)
+{
+    if (terminalIsTty)
+        fputs("\033[H\033[2J", stdout);
+}
+
+char *readLine(char *buffer, int size)
+{
+    fflush(stdout);
+    return fgets(buffer, size, stdin);
+}
+
+int readChar(void)
+{
+    fflush(stdout);
+    return getchar();
+}
+
+int scanInput(const char *format, ...)
+{
+    va_list args;
+    fflush(stdout);
+    va_start(args, format);
+    int n = vscanf(format, args);
+    va_end(args);
+    return n;
+}
+
 void trimWhitespace(char *str)
 {
     if (str == NULL || *str == '\0')
@@ -263,1869 +920,6925 @@ void trimWhitespace(char *str)
     }
 }
 
+// Set in command mode so housekeeping messages stay out of the machine-readable output on stdout.
+static int noticesToStderr = 0;
+
+void notice(const char *format, ...)
+{
+    va_list args;
+    if (noticesToStderr)
+        fflush(stdout);
+    va_start(args, format);
+    vfprintf(noticesToStderr ? stderr : stdout, format, args);
+    va_end(args);
+}
+
+// stderr is unbuffered while an interactive screen may still sit in stdout's buffer, so diagnostics flush it
+// first. Otherwise they would print ahead of the text they follow and be wiped by its pending clear.
+void reportError(const char *format, ...)
+{
+    va_list args;
+    fflush(stdout);
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+void reportSystemError(const char *what)
+{
+    int saved = errno;
+    fflush(stdout);
+    errno = saved;
+    perror(what);
+}
+
+// Process-wide hot-path counters. The I/O helpers below and the record loops bump them; beginOperation and
+// endOperation charge the difference to a named operation.
+struct HotPathCounters hotPath;
+static struct OperationStats operationStats[STATS_MAX_OPERATIONS];
+static int operationCount = 0;
+static int operationDepth = 0;
+
+int seekData(FILE *file, long long offset, int whence)
+{
+    hotPath.seeks++;
+    return fseeko(file, (off_t)offset, whence);
+}
+
+void rewindData(FILE *file)
+{
+    hotPath.seeks++;
+    rewind(file);
+}
+
+size_t readData(void *data, size_t size, size_t count, FILE *file)
+{
+    size_t n = fread(data, size, count, file);
+    hotPath.bytesRead += (long long)(size * n);
+    return n;
+}
+
+static double cpuSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static double wallSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// Only the outermost operation is charged, so menu items that call other operations are not counted twice.
+void beginOperation(struct OperationTimer *timer, const char *name)
+{
+    timer->name = operationDepth++ == 0 ? name : NULL;
+    timer->start = hotPath;
+    timer->wall = wallSeconds();
+    timer->cpu = cpuSeconds();
+}
+
+void endOperation(struct OperationTimer *timer)
+{
+    operationDepth--;
+    if (timer->name == NULL)
+        return;
+    struct OperationStats *stats = NULL;
+    for (int i = 0; i < operationCount && stats == NULL; i++)
+    {
+        if (strcmp(operationStats[i].name, timer->name) == 0)
+            stats = &operationStats[i];
+    }
+    if (stats == NULL)
+    {
+        if (operationCount == STATS_MAX_OPERATIONS)
+            return;
+        stats = &operationStats[operationCount++];
+        snprintf(stats->name, sizeof(stats->name), "%s", timer->name);
+    }
+    stats->calls++;
+    stats->counters.recordsScanned += hotPath.recordsScanned - timer->start.recordsScanned;
+    stats->counters.bytesRead += hotPath.bytesRead - timer->start.bytesRead;
+    stats->counters.parseCalls += hotPath.parseCalls - timer->start.parseCalls;
+    stats->counters.seeks += hotPath.seeks - timer->start.seeks;
+    stats->counters.rewriteBytes += hotPath.rewriteBytes - timer->start.rewriteBytes;
+    stats->wallSeconds += wallSeconds() - timer->wall;
+    stats->cpuSeconds += cpuSeconds() - timer->cpu;
+}
+
+void resetOperationStats(void)
+{
+    operationCount = 0;
+    memset(&hotPath, 0, sizeof(hotPath));
+}
+
+// One tab-separated row per operation after a header row. Menu operations include the time spent waiting at
+// prompts in wall_ms; cpu_ms does not.
+void writeOperationStats(FILE *out)
+{
+    fprintf(out, "operation\tcalls\trecords_scanned\tbytes_read\tparse_calls\tseeks\trewrite_bytes\twall_ms\tcpu_ms\n");
+    for (int i = 0; i < operationCount; i++)
+    {
+        const struct OperationStats *s = &operationStats[i];
+        fprintf(out, "%s\t%lld\t%lld\t%lld\t%lld\t%lld\t%lld\t%.3f\t%.3f\n", s->name, s->calls,
+                s->counters.recordsScanned, s->counters.bytesRead, s->counters.parseCalls, s->counters.seeks,
+                s->counters.rewriteBytes, s->wallSeconds * 1000.0, s->cpuSeconds * 1000.0);
+    }
+}
+
+// Registered with atexit when PROJECT_SHOW_STATS_FILE names a file to receive the counters.
+void dumpOperationStats(void)
+{
+    const char *path = getenv(STATS_FILE_ENV);
+    FILE *out = path != NULL ? fopen(path, "w") : NULL;
+    if (out == NULL)
+        return;
+    writeOperationStats(out);
+    fclose(out);
+}
+
 void pressEnterToContinue()
 {
     printf("\nPress Enter to continue...");
     clearInputBuffer();
-    getchar();
+    readChar();
+}
+
+static const char *const gradeNames[GRADE_COUNT] = {"A+", "A", "A-", "B+", "B", "B-", "C+", "C", "D", "F"};
+static const float gradeFloors[GRADE_COUNT - 1] = {4.0f, 3.75f, 3.50f, 3.25f, 3.00f, 2.75f, 2.50f, 2.25f, 2.00f};
+
+// Position of gpa's grade in gradeNames.
+int gradeIndex(float gpa)
+{
+    int g = 0;
+    while (g < GRADE_COUNT - 1 && !(gpa >= gradeFloors[g]))
+        g++;
+    return g;
 }
 
 void calculateGrade(float gpa, char *grade)
 {
-    if (gpa > 4.0)
-        gpa = 4.0; 
-    if (gpa < 0.0)
-        gpa = 0.0;
-    if (gpa >= 4.0)
-        strcpy(grade, "A+");
-    else if (gpa >= 3.75)
-        strcpy(grade, "A");
-    else if (gpa >= 3.50)
-        strcpy(grade, "A-");
-    else if (gpa >= 3.25)
-        strcpy(grade, "B+");
-    else if (gpa >= 3.00)
-        strcpy(grade, "B");
-    else if (gpa >= 2.75)
-        strcpy(grade, "B-");
-    else if (gpa >= 2.50)
-        strcpy(grade, "C+");
-    else if (gpa >= 2.25)
-        strcpy(grade, "C");
-    else if (gpa >= 2.00)
-        strcpy(grade, "D");
-    else
-        strcpy(grade, "F");
+    strcpy(grade, gradeNames[gradeIndex(gpa)]);
 }
-void handleAdmissionPhase(FILE **P_ptr)
+int fieldEquals(struct FieldView field, const char *text)
 {
-    char user[100];
-    system("clear || cls");
-    printf("Enter your username: ");
-    // Use fgets safely
-    if (fgets(user, sizeof(user), stdin) == NULL)
+    size_t textLen = strlen(text);
+    return field.len == textLen && memcmp(field.ptr, text, textLen) == 0;
+}
+
+int fieldContains(struct FieldView field, const char *needle)
+{
+    size_t needleLen = strlen(needle);
+    if (needleLen == 0)
+        return 1;
+    if (needleLen > field.len)
+        return 0;
+    const char *cursor = field.ptr;
+    const char *last = field.ptr + field.len - needleLen;
+    while (cursor <= last)
     {
-        printf("Error reading username.\n");
+        cursor = memchr(cursor, needle[0], (size_t)(last - cursor) + 1);
+        if (cursor == NULL)
+            return 0;
+        if (memcmp(cursor, needle, needleLen) == 0)
+            return 1;
+        cursor++;
+    }
+    return 0;
+}
+
+void copyField(struct FieldView field, char *dest, size_t destSize)
+{
+    if (destSize == 0)
+        return;
+    size_t n = field.len < destSize - 1 ? field.len : destSize - 1;
+    if (n > 0)
+        memcpy(dest, field.ptr, n);
+    dest[n] = '\0';
+}
+
+void splitStudentName(struct FieldView name, char *first, size_t firstSize, char *last, size_t lastSize)
+{
+    const char *space = name.len > 0 ? memchr(name.ptr, ' ', name.len) : NULL;
+    if (space == NULL)
+    {
+        copyField(name, first, firstSize);
+        copyField((struct FieldView){name.ptr + name.len, 0}, last, lastSize);
         return;
     }
-    trimWhitespace(user);
+    struct FieldView head = {name.ptr, (size_t)(space - name.ptr)};
+    struct FieldView tail = {space + 1, name.len - head.len - 1};
+    while (tail.len > 0 && *tail.ptr == ' ')
+    {
+        tail.ptr++;
+        tail.len--;
+    }
+    copyField(head, first, firstSize);
+    copyField(tail, last, lastSize);
+}
 
-    if (strcmp(user, "A") == 0)
+// Keys are told apart by length and first character; one memcmp confirms the match.
+static int classifyStudentKey(const char *key, size_t len)
+{
+    const char *expected = NULL;
+    int field = -1;
+    switch (len)
     {
-        system("clear || cls");
-        printf("========================================================================================\n");
-        printf("      =============== Bangladesh University of Business and Technology =============\n");
-        printf("========================================================================================\n\n");
-        printf(":::::::::::::::::::::::: Information of Departments ::::::::::::::::::::::::\n");
-        printf("   1. CSE (GPA: 9.50, Fees: 5,80,000/=)\n");
-        printf("   2. BBA (GPA: 9.25, Fees: 5,70,000/=)\n");
-        printf("   3. EEE (GPA: 9.00, Fees: 5,40,000/=)\n");
-        printf("   4. ENGLISH (GPA: 8.50, Fees: 5,50,000/=)\n\n");
+    case 5:
+        expected = "Email", field = FIELD_EMAIL;
+        break;
+    case 6:
+        expected = "Intake", field = FIELD_INTAKE;
+        break;
+    case 7:
+        expected = "Section", field = FIELD_SECTION;
+        break;
+    case 10:
+        if (key[0] == 'S')
+            expected = "Student ID", field = FIELD_ID;
+        else
+            expected = "Department", field = FIELD_DEPARTMENT;
+        break;
+    case 11:
+        expected = "Blood Group", field = FIELD_BLOOD_GROUP;
+        break;
+    case 12:
+        expected = "Student Name", field = FIELD_NAME;
+        break;
+    case 13:
+        if (key[0] == 'F')
+            expected = "Father's name", field = FIELD_FATHER;
+        else if (key[2] == 't')
+            expected = "Mother's name", field = FIELD_MOTHER;
+        else
+            expected = "Mobile number", field = FIELD_MOBILE;
+        break;
+    case 15:
+        expected = "Present Address", field = FIELD_PRESENT_ADDRESS;
+        break;
+    case 17:
+        expected = "Permanent Address", field = FIELD_PERMANENT_ADDRESS;
+        break;
+    case 20:
+        expected = "Backup Mobile Number", field = FIELD_BACKUP_MOBILE;
+        break;
+    default:
+        return -1;
+    }
+    return memcmp(key, expected, len) == 0 ? field : -1;
+}
 
-        printf("                  Which Department do you want to manage?                 \n\n");
-        printf("1.CSE   2.EEE   3.BBA   4.ENGLISH\n\n");
-        printf("Enter choice (1-4): ");
+size_t parseStudentRecord(const char *buffer, size_t length, struct StudentRecordView *record)
+{
+    memset(record, 0, sizeof(*record));
+    size_t pos = 0;
+    size_t recordEnd = 0;
+    while (pos < length)
+    {
+        const char *newline = memchr(buffer + pos, '\n', length - pos);
+        size_t lineEnd = newline ? (size_t)(newline - buffer) + 1 : length;
+        const char *start = buffer + pos;
+        const char *end = newline ? newline : buffer + length;
+        while (start < end && isspace((unsigned char)*start))
+            start++;
+        while (end > start && isspace((unsigned char)end[-1]))
+            end--;
+
+        if (start == end)
+        {
+            if (record->raw != NULL)
+            {
+                record->rawLen = recordEnd - (size_t)(record->raw - buffer);
+                return lineEnd;
+            }
+            pos = lineEnd;
+            continue;
+        }
+        if (record->raw == NULL)
+            record->raw = buffer + pos;
 
-        int deptChoice;
-        if (scanf("%d", &deptChoice) != 1)
+        const char *colon = memchr(start, ':', (size_t)(end - start));
+        if (colon != NULL && colon > start)
         {
-            printf("Invalid input. Please enter a number.\n");
-            clearInputBuffer();
-            pressEnterToContinue();
+            int field = classifyStudentKey(start, (size_t)(colon - start));
+            if (field >= 0)
+            {
+                const char *value = colon + 1;
+                while (value < end && isspace((unsigned char)*value))
+                    value++;
+                record->field[field].ptr = value;
+                record->field[field].len = (size_t)(end - value);
+            }
+        }
+        recordEnd = lineEnd;
+        pos = lineEnd;
+    }
+    if (record->raw != NULL)
+        record->rawLen = recordEnd - (size_t)(record->raw - buffer);
+    return length;
+}
+
+// Maps the whole student file read-only. advice is a POSIX_MADV_* hint for the access pattern that follows.
+int mapStudentFile(FILE *file, struct StudentMap *map, int advice)
+{
+    struct stat info;
+    memset(map, 0, sizeof(*map));
+    fflush(file);
+    int fd = fileno(file);
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        reportSystemError("Error inspecting student file");
+        return 0;
+    }
+    if (info.st_size == 0)
+        return 1;
+    map->length = (size_t)info.st_size;
+    void *data = mmap(NULL, map->length, PROT_READ, MAP_SHARED, fd, 0);
+    if (data != MAP_FAILED)
+    {
+        map->data = data;
+        map->mapped = 1;
+        posix_madvise(data, map->length, advice);
+        if (advice == POSIX_MADV_SEQUENTIAL)
+            hotPath.bytesRead += (long long)map->length;
+        return 1;
+    }
+
+    map->data = malloc(map->length);
+    if (map->data == NULL)
+    {
+        reportError("ERROR: Out of memory while reading student file.\n");
+        map->length = 0;
+        return 0;
+    }
+    rewindData(file);
+    if (readData(map->data, 1, map->length, file) != map->length)
+    {
+        reportSystemError("Error reading student file");
+        clearerr(file);
+        unmapStudentFile(map);
+        return 0;
+    }
+    return 1;
+}
+
+void unmapStudentFile(struct StudentMap *map)
+{
+    if (map->mapped)
+        munmap(map->data, map->length);
+    else
+        free(map->data);
+    memset(map, 0, sizeof(*map));
+}
+
+int openStudentScanner(struct StudentScanner *scanner, FILE *file)
+{
+    scanner->pos = 0;
+    return mapStudentFile(file, &scanner->map, POSIX_MADV_SEQUENTIAL);
+}
+
+int nextStudentRecord(struct StudentScanner *scanner, struct StudentRecordView *record)
+{
+    while (scanner->pos < scanner->map.length)
+    {
+        scanner->pos += parseStudentRecord(scanner->map.data + scanner->pos, scanner->map.length - scanner->pos, record);
+        hotPath.parseCalls++;
+        if (record->raw != NULL)
+        {
+            record->offset = (long)(record->raw - scanner->map.data);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void closeStudentScanner(struct StudentScanner *scanner)
+{
+    unmapStudentFile(&scanner->map);
+}
+
+void printStudentDetails(const struct StudentRecordView *record)
+{
+    printf("Name: %.*s\n", FIELD_ARGS(record->field[FIELD_NAME]));
+    printf("Father's Name: %.*s\n", FIELD_ARGS(record->field[FIELD_FATHER]));
+    printf("Mother's Name: %.*s\n", FIELD_ARGS(record->field[FIELD_MOTHER]));
+    printf("Student ID: %.*s\n", FIELD_ARGS(record->field[FIELD_ID]));
+    printf("Department: %.*s\n", FIELD_ARGS(record->field[FIELD_DEPARTMENT]));
+    printf("Intake: %.*s\n", FIELD_ARGS(record->field[FIELD_INTAKE]));
+    printf("Section: %.*s\n", FIELD_ARGS(record->field[FIELD_SECTION]));
+    printf("Present Address: %.*s\n", FIELD_ARGS(record->field[FIELD_PRESENT_ADDRESS]));
+    printf("Permanent Address: %.*s\n", FIELD_ARGS(record->field[FIELD_PERMANENT_ADDRESS]));
+    printf("Blood Group: %.*s\n", FIELD_ARGS(record->field[FIELD_BLOOD_GROUP]));
+    printf("Mobile Number: %.*s\n", FIELD_ARGS(record->field[FIELD_MOBILE]));
+    printf("Backup Mobile: %.*s\n", FIELD_ARGS(record->field[FIELD_BACKUP_MOBILE]));
+    printf("Email: %.*s\n", FIELD_ARGS(record->field[FIELD_EMAIL]));
+}
+
+static const char *studentFieldKeys[STUDENT_FIELD_COUNT] = {
+    "Student Name", "Father's name", "Mother's name", "Student ID", "Department", "Intake", "Section",
+    "Present Address", "Permanent Address", "Blood Group", "Mobile number", "Backup Mobile Number", "Email"};
+
+static const char *const studentColumns[STUDENT_FIELD_COUNT] = {
+    "name", "father", "mother", "id", "dept", "intake", "section",
+    "present", "permanent", "blood", "mobile", "backup", "email"};
+
+size_t formatStudentRecord(char *dest, size_t destSize, const struct StudentRecordView *record)
+{
+    size_t used = 0;
+    for (int i = 0; i < STUDENT_FIELD_COUNT; i++)
+    {
+        int n = snprintf(dest + used, destSize - used, "%s: %.*s\n", studentFieldKeys[i], FIELD_ARGS(record->field[i]));
+        if (n < 0 || (size_t)n >= destSize - used)
+            return 0;
+        used += (size_t)n;
+    }
+    return used;
+}
+
+#define STUDENT_COLUMN(member) {offsetof(struct StudentRecord, member), sizeof(((struct StudentRecord *)0)->member)}
+static const struct
+{
+    size_t offset;
+    size_t size;
+} studentRecordLayout[STUDENT_FIELD_COUNT] = {
+    STUDENT_COLUMN(name), STUDENT_COLUMN(fatherName), STUDENT_COLUMN(motherName), STUDENT_COLUMN(studentID),
+    STUDENT_COLUMN(department), STUDENT_COLUMN(intake), STUDENT_COLUMN(section), STUDENT_COLUMN(presentAddress),
+    STUDENT_COLUMN(permanentAddress), STUDENT_COLUMN(bloodGroup), STUDENT_COLUMN(mobileNumber),
+    STUDENT_COLUMN(backupMobileNumber), STUDENT_COLUMN(email)};
+
+void studentRecordView(const struct StudentRecord *student, struct StudentRecordView *record)
+{
+    memset(record, 0, sizeof(*record));
+    for (int i = 0; i < STUDENT_FIELD_COUNT; i++)
+    {
+        const char *value = (const char *)student + studentRecordLayout[i].offset;
+        record->field[i].ptr = value;
+        record->field[i].len = strnlen(value, studentRecordLayout[i].size);
+    }
+}
+
+// Copies each field into its fixed-width slot; returns how many fields had to be truncated.
+int fillStudentRecord(struct StudentRecord *student, const struct StudentRecordView *record)
+{
+    int truncated = 0;
+    memset(student, 0, sizeof(*student));
+    student->state = STUDENT_RECORD_LIVE;
+    for (int i = 0; i < STUDENT_FIELD_COUNT; i++)
+    {
+        copyField(record->field[i], (char *)student + studentRecordLayout[i].offset, studentRecordLayout[i].size);
+        if (record->field[i].len >= studentRecordLayout[i].size)
+            truncated++;
+    }
+    return truncated;
+}
+
+int fillStudentValues(struct StudentRecord *student, const char *values[STUDENT_FIELD_COUNT])
+{
+    struct StudentRecordView record;
+    memset(&record, 0, sizeof(record));
+    for (int i = 0; i < STUDENT_FIELD_COUNT; i++)
+    {
+        record.field[i].ptr = values[i];
+        record.field[i].len = strlen(values[i]);
+    }
+    return fillStudentRecord(student, &record);
+}
+
+long long studentRecordPos(long long recordNumber)
+{
+    return (long long)sizeof(struct StudentFileHeader) + recordNumber * (long long)sizeof(struct StudentRecord);
+}
+
+static void initStudentHeader(struct StudentFileHeader *header)
+{
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, STUDENT_STORE_MAGIC, sizeof(STUDENT_STORE_MAGIC) - 1);
+    header->version = STUDENT_STORE_VERSION;
+    header->recordSize = sizeof(struct StudentRecord);
+}
+
+static int checkStudentHeader(const struct StudentFileHeader *header)
+{
+    return strncmp(header->magic, STUDENT_STORE_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == STUDENT_STORE_VERSION && header->recordSize == sizeof(struct StudentRecord);
+}
+
+static int readStudentHeader(FILE *file, struct StudentFileHeader *header)
+{
+    return seekData(file, 0, SEEK_SET) == 0 && readData(header, sizeof(*header), 1, file) == 1;
+}
+
+static int writeStudentHeader(FILE *file, const struct StudentFileHeader *header)
+{
+    return seekData(file, 0, SEEK_SET) == 0 && fwrite(header, sizeof(*header), 1, file) == 1 && fflush(file) == 0;
+}
+
+// Opens the student store for update, creating it with a fresh header when it does not exist yet.
+FILE *openStudentStore(const char *path)
+{
+    struct StudentFileHeader header;
+    FILE *file = fopen(path, "rb+");
+    if (file == NULL && errno == ENOENT)
+    {
+        file = fopen(path, "wb+");
+        if (file == NULL)
+            return NULL;
+        initStudentHeader(&header);
+        if (!writeStudentHeader(file, &header))
+        {
+            fclose(file);
+            return NULL;
+        }
+    }
+    if (file == NULL)
+        return NULL;
+    if (!readStudentHeader(file, &header) || !checkStudentHeader(&header))
+    {
+        reportError("ERROR: '%s' is not a version %d student store.\n", path, STUDENT_STORE_VERSION);
+        fclose(file);
+        errno = EINVAL;
+        return NULL;
+    }
+    return file;
+}
+
+int readStudentAt(FILE *file, long long recordNumber, struct StudentRecord *student)
+{
+    hotPath.recordsScanned++;
+    return seekData(file, (off_t)studentRecordPos(recordNumber), SEEK_SET) == 0 &&
+           readData(student, sizeof(*student), 1, file) == 1;
+}
+
+int writeStudentAt(FILE *file, long long recordNumber, const struct StudentRecord *student)
+{
+    return seekData(file, (off_t)studentRecordPos(recordNumber), SEEK_SET) == 0 &&
+           fwrite(student, sizeof(*student), 1, file) == 1 && fflush(file) == 0;
+}
+
+// Rewrites recordNumber in place, but only if it still holds expected. Fixed-width slots mean an edited record
+// always fits, so an update never has to relocate. Returns 1 if written, 0 if the record changed underneath, -1 on error.
+int replaceStudentAt(FILE *file, long long recordNumber, const struct StudentRecord *expected, const struct StudentRecord *student)
+{
+    struct StudentRecord current;
+    if (!readStudentAt(file, recordNumber, &current))
+        return -1;
+    if (memcmp(&current, expected, sizeof(current)) != 0)
+        return 0;
+    return writeStudentAt(file, recordNumber, student) ? 1 : -1;
+}
+
+// Writes student after the last whole record (overwriting any torn tail) and returns its record number, or -1.
+long long appendStudent(FILE *file, const struct StudentRecord *student)
+{
+    if (seekData(file, 0, SEEK_END) != 0)
+        return -1;
+    long long end = (long long)ftello(file);
+    if (end < (long long)sizeof(struct StudentFileHeader))
+        return -1;
+    long long recordNumber = (end - (long long)sizeof(struct StudentFileHeader)) / (long long)sizeof(struct StudentRecord);
+    return writeStudentAt(file, recordNumber, student) ? recordNumber : -1;
+}
+
+// Maps the student store read-only and points *records at its first record; a torn tail is not counted.
+int mapStudentStore(FILE *file, struct StudentMap *map, int advice, const struct StudentRecord **records, long long *count)
+{
+    *records = NULL;
+    *count = 0;
+    if (!mapStudentFile(file, map, advice))
+        return 0;
+    if (map->length < sizeof(struct StudentFileHeader) || !checkStudentHeader((const struct StudentFileHeader *)map->data))
+    {
+        reportError("ERROR: Student store header is missing or corrupt.\n");
+        unmapStudentFile(map);
+        return 0;
+    }
+    *records = (const struct StudentRecord *)(map->data + sizeof(struct StudentFileHeader));
+    *count = (long long)((map->length - sizeof(struct StudentFileHeader)) / sizeof(struct StudentRecord));
+    if (advice == POSIX_MADV_SEQUENTIAL)
+        hotPath.recordsScanned += *count;
+    return 1;
+}
+
+// One-shot conversion of the legacy text store. Records stream from the mapped text file into a temp store
+// that is renamed over dataPath only once every record has been written.
+int convertStudentText(const char *textPath, const char *dataPath)
+{
+    char tempPath[256];
+    struct StudentFileHeader header;
+    struct StudentScanner scanner;
+    struct StudentRecordView record;
+    struct StudentRecord student;
+    long converted = 0, truncated = 0;
+
+    FILE *text = fopen(textPath, "r");
+    if (text == NULL)
+    {
+        reportSystemError("Error opening student text file");
+        return 0;
+    }
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", dataPath);
+    FILE *out = fopen(tempPath, "wb");
+    if (out == NULL)
+    {
+        reportSystemError("Error creating student store");
+        fclose(text);
+        return 0;
+    }
+    initStudentHeader(&header);
+    int ok = fwrite(&header, sizeof(header), 1, out) == 1 && openStudentScanner(&scanner, text);
+    if (ok)
+    {
+        while (ok && nextStudentRecord(&scanner, &record))
+        {
+            if (fillStudentRecord(&student, &record) > 0)
+                truncated++;
+            ok = fwrite(&student, sizeof(student), 1, out) == 1;
+            converted++;
+        }
+        closeStudentScanner(&scanner);
+    }
+    fclose(text);
+    if (fclose(out) != 0)
+        ok = 0;
+    if (!ok || rename(tempPath, dataPath) != 0)
+    {
+        reportSystemError("Error writing student store");
+        remove(tempPath);
+        return 0;
+    }
+    notice("Converted %ld student records from %s to %s.\n", converted, textPath, dataPath);
+    if (truncated > 0)
+        notice("Warning: %ld records had fields longer than their fixed-width slots and were truncated.\n", truncated);
+    return 1;
+}
+
+// Writes the live records back out in the "Key: value" text layout, which convertStudentText reads.
+int exportStudentText(FILE *store, const char *textPath)
+{
+    struct StudentMap map;
+    const struct StudentRecord *records;
+    long long count;
+    if (!mapStudentStore(store, &map, POSIX_MADV_SEQUENTIAL, &records, &count))
+        return 0;
+    FILE *out = fopen(textPath, "w");
+    if (out == NULL)
+    {
+        reportSystemError("Error creating student export file");
+        unmapStudentFile(&map);
+        return 0;
+    }
+    char text[4096];
+    long exported = 0;
+    int ok = 1;
+    for (long long i = 0; ok && i < count; i++)
+    {
+        struct StudentRecordView record;
+        if (records[i].state != STUDENT_RECORD_LIVE)
+            continue;
+        studentRecordView(&records[i], &record);
+        size_t len = formatStudentRecord(text, sizeof(text), &record);
+        ok = len > 0 && fwrite(text, 1, len, out) == len && fputc('\n', out) != EOF;
+        exported++;
+    }
+    unmapStudentFile(&map);
+    if (fclose(out) != 0)
+        ok = 0;
+    if (!ok)
+    {
+        reportSystemError("Error writing student export file");
+        return 0;
+    }
+    notice("Exported %ld student records to %s.\n", exported, textPath);
+    return 1;
+}
+
+int openExportWriter(struct ExportWriter *writer, FILE *out, int format)
+{
+    writer->out = out;
+    writer->format = format;
+    writer->used = 0;
+    writer->column = 0;
+    writer->rows = 0;
+    writer->buffer = malloc(EXPORT_BUFFER_SIZE);
+    writer->ok = writer->buffer != NULL;
+    if (!writer->ok)
+        reportSystemError("Error allocating export buffer");
+    return writer->ok;
+}
+
+static void flushExportWriter(struct ExportWriter *writer)
+{
+    if (writer->ok && writer->used > 0)
+        writer->ok = fwrite(writer->buffer, 1, writer->used, writer->out) == writer->used;
+    writer->used = 0;
+}
+
+// Room for n more bytes; n is bounded by the widest escaped field, far below EXPORT_BUFFER_SIZE.
+static char *reserveExport(struct ExportWriter *writer, size_t n)
+{
+    if (writer->used + n > EXPORT_BUFFER_SIZE)
+        flushExportWriter(writer);
+    return writer->buffer + writer->used;
+}
+
+// Appends one field of at most maxLen bytes. CSV fields are quoted only when they hold a comma, quote or
+// line break; JSONL fields become "name":"text", or "name":text when raw is set (numbers).
+static void exportField(struct ExportWriter *writer, const char *name, const char *text, size_t maxLen, int raw)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t len = strnlen(text, maxLen);
+    size_t nameLen = strlen(name);
+    char *start = reserveExport(writer, len * 6 + nameLen + 8);
+    char *p = start;
+
+    if (writer->format == EXPORT_CSV)
+    {
+        int quote = 0;
+        if (writer->column > 0)
+            *p++ = ',';
+        for (size_t i = 0; i < len && !quote; i++)
+            quote = text[i] == ',' || text[i] == '"' || text[i] == '\n' || text[i] == '\r';
+        if (!quote)
+        {
+            memcpy(p, text, len);
+            p += len;
+        }
+        else
+        {
+            *p++ = '"';
+            for (size_t i = 0; i < len; i++)
+            {
+                if (text[i] == '"')
+                    *p++ = '"';
+                *p++ = text[i];
+            }
+            *p++ = '"';
+        }
+    }
+    else
+    {
+        *p++ = writer->column > 0 ? ',' : '{';
+        *p++ = '"';
+        memcpy(p, name, nameLen);
+        p += nameLen;
+        *p++ = '"';
+        *p++ = ':';
+        if (!raw)
+            *p++ = '"';
+        for (size_t i = 0; i < len; i++)
+        {
+            unsigned char c = (unsigned char)text[i];
+            if (c == '"' || c == '\\')
+            {
+                *p++ = '\\';
+                *p++ = (char)c;
+            }
+            else if (c < 0x20)
+            {
+                memcpy(p, "\\u00", 4);
+                p[4] = hex[c >> 4];
+                p[5] = hex[c & 15];
+                p += 6;
+            }
+            else
+                *p++ = (char)c;
+        }
+        if (!raw)
+            *p++ = '"';
+    }
+    writer->used += (size_t)(p - start);
+    writer->column++;
+}
+
+static void endExportRow(struct ExportWriter *writer)
+{
+    char *p = reserveExport(writer, 2);
+    if (writer->format == EXPORT_JSONL)
+        *p++ = '}';
+    *p++ = '\n';
+    writer->used = (size_t)(p - writer->buffer);
+    writer->column = 0;
+    writer->rows++;
+}
+
+// CSV output starts with a header row; JSONL rows carry their own field names.
+static void exportHeader(struct ExportWriter *writer, const char *const *columns, int count)
+{
+    if (writer->format != EXPORT_CSV)
+        return;
+    for (int i = 0; i < count; i++)
+        exportField(writer, columns[i], columns[i], strlen(columns[i]), 0);
+    endExportRow(writer);
+    writer->rows--;
+}
+
+// Flushes what is left and frees the buffer. Returns 0 if any write failed.
+int closeExportWriter(struct ExportWriter *writer)
+{
+    flushExportWriter(writer);
+    if (writer->ok && fflush(writer->out) != 0)
+        writer->ok = 0;
+    free(writer->buffer);
+    writer->buffer = NULL;
+    if (!writer->ok)
+        reportSystemError("Error writing export");
+    return writer->ok;
+}
+
+static int exportFilterMatches(const struct ExportFilter *filter, const char *department, const char *intake,
+                               const char *section)
+{
+    return (filter->department == NULL || (department != NULL && strcmp(filter->department, department) == 0)) &&
+           (filter->intake == NULL || strcmp(filter->intake, intake) == 0) &&
+           (filter->section == NULL || strcmp(filter->section, section) == 0);
+}
+
+// GPA with two decimals, e.g. "3.75", without going through printf.
+static void formatGpa(float gpa, char *text)
+{
+    long hundredths = gpa > 0.0f ? (long)(gpa * 100.0f + 0.5f) : 0;
+    text[0] = (char)('0' + hundredths / 100 % 10);
+    text[1] = '.';
+    text[2] = (char)('0' + hundredths / 10 % 10);
+    text[3] = (char)('0' + hundredths % 10);
+    text[4] = '\0';
+}
+
+// The export functions stream one store through writer from a read-only mapping, so memory use does not
+// grow with the file. Each returns 0 if the store could not be read.
+int exportStudents(FILE *store, const struct ExportFilter *filter, struct ExportWriter *writer)
+{
+    struct StudentMap map;
+    const struct StudentRecord *records;
+    long long count;
+    if (!mapStudentStore(store, &map, POSIX_MADV_SEQUENTIAL, &records, &count))
+        return 0;
+    exportHeader(writer, studentColumns, STUDENT_FIELD_COUNT);
+    for (long long i = 0; writer->ok && i < count; i++)
+    {
+        const struct StudentRecord *student = &records[i];
+        if (student->state != STUDENT_RECORD_LIVE ||
+            !exportFilterMatches(filter, student->department, student->intake, student->section))
+            continue;
+        for (int f = 0; f < STUDENT_FIELD_COUNT; f++)
+            exportField(writer, studentColumns[f], (const char *)student + studentRecordLayout[f].offset,
+                        studentRecordLayout[f].size, 0);
+        endExportRow(writer);
+    }
+    unmapStudentFile(&map);
+    return 1;
+}
+
+int exportSchedules(FILE *scheduleFile, const struct ExportFilter *filter, struct ExportWriter *writer)
+{
+    static const char *const columns[] = {"intake", "section", "type", "day", "date", "time", "room", "faculty", "details"};
+    struct StudentMap map;
+    struct AcademicSchedule schedule;
+    const struct AcademicSchedule *s = &schedule;
+    size_t pos;
+    int got;
+    if (fflush(scheduleFile) != 0 || !mapScheduleStore(scheduleFile, &map, POSIX_MADV_SEQUENTIAL, &pos))
+        return 0;
+    exportHeader(writer, columns, 9);
+    while (writer->ok && (got = nextScheduleRecord(&map, &pos, &schedule, NULL)) != 0)
+    {
+        if (got < 0 || !exportFilterMatches(filter, NULL, s->intake, s->section))
+            continue;
+        exportField(writer, columns[0], s->intake, sizeof(s->intake), 0);
+        exportField(writer, columns[1], s->section, sizeof(s->section), 0);
+        exportField(writer, columns[2], s->scheduleType, sizeof(s->scheduleType), 0);
+        exportField(writer, columns[3], s->routineData.day, sizeof(s->routineData.day), 0);
+        exportField(writer, columns[4], s->routineData.date, sizeof(s->routineData.date), 0);
+        exportField(writer, columns[5], s->routineData.time, sizeof(s->routineData.time), 0);
+        exportField(writer, columns[6], s->routineData.room, sizeof(s->routineData.room), 0);
+        exportField(writer, columns[7], s->routineData.faculty, sizeof(s->routineData.faculty), 0);
+        exportField(writer, columns[8], s->otherDetails, sizeof(s->otherDetails), 0);
+        endExportRow(writer);
+    }
+    unmapStudentFile(&map);
+    return 1;
+}
+
+int exportResults(FILE *resultFile, const struct ExportFilter *filter, struct ExportWriter *writer)
+{
+    static const char *const columns[] = {"id", "name", "intake", "section", "gpa", "grade"};
+    struct StudentMap map;
+    char gpa[8];
+    if (fflush(resultFile) != 0 || !mapStudentFile(resultFile, &map, POSIX_MADV_SEQUENTIAL))
+        return 0;
+    const struct StudentResult *results = (const struct StudentResult *)map.data;
+    size_t count = map.length / sizeof(struct StudentResult);
+    hotPath.recordsScanned += (long long)count;
+    exportHeader(writer, columns, 6);
+    for (size_t i = 0; writer->ok && i < count; i++)
+    {
+        const struct StudentResult *r = &results[i];
+        if (FIXED_RECORD_DEAD(r) || !exportFilterMatches(filter, NULL, r->intake, r->section))
+            continue;
+        formatGpa(r->gpa, gpa);
+        exportField(writer, columns[0], r->studentID, sizeof(r->studentID), 0);
+        exportField(writer, columns[1], r->name, sizeof(r->name), 0);
+        exportField(writer, columns[2], r->intake, sizeof(r->intake), 0);
+        exportField(writer, columns[3], r->section, sizeof(r->section), 0);
+        exportField(writer, columns[4], gpa, sizeof(gpa), 1);
+        exportField(writer, columns[5], r->grade, sizeof(r->grade), 0);
+        endExportRow(writer);
+    }
+    unmapStudentFile(&map);
+    return 1;
+}
+
+// Opens a data file for update, creating it empty if it does not exist yet.
+FILE *openDataFile(const char *path)
+{
+    FILE *file = fopen(path, "rb+");
+    if (file == NULL && errno == ENOENT)
+        file = fopen(path, "wb+");
+    return file;
+}
+
+// Opens students.dat, converting test.txt first when only the text file exists.
+FILE *openStudentData(void)
+{
+    struct stat dataInfo;
+    if (stat(STUDENT_DATA_FILE, &dataInfo) != 0 && errno == ENOENT && stat(STUDENT_TEXT_FILE, &dataInfo) == 0)
+    {
+        notice("INFO: Converting %s to %s...\n", STUDENT_TEXT_FILE, STUDENT_DATA_FILE);
+        if (!convertStudentText(STUDENT_TEXT_FILE, STUDENT_DATA_FILE))
+            return NULL;
+    }
+    return openStudentStore(STUDENT_DATA_FILE);
+}
+
+static unsigned int hashBytes(const char *data, size_t len)
+{
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 16777619u;
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+unsigned int hashIndexKey(const char *key)
+{
+    return hashBytes(key, strlen(key));
+}
+
+int getFileStamp(const char *path, long long *size, long long *modified)
+{
+    struct stat info;
+    if (stat(path, &info) != 0)
+        return 0;
+    *size = (long long)info.st_size;
+    *modified = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+    return 1;
+}
+
+int initIndexTable(struct IndexTable *table, const char *magic, unsigned int expectedEntries)
+{
+    unsigned int slotCount = INDEX_MIN_SLOTS;
+    while (slotCount < expectedEntries * 2)
+        slotCount *= 2;
+    memset(table, 0, sizeof(*table));
+    strncpy(table->header.magic, magic, sizeof(table->header.magic) - 1);
+    table->header.version = INDEX_VERSION;
+    table->header.slotCount = slotCount;
+    table->slots = calloc(slotCount, sizeof(struct IndexSlot));
+    if (table->slots == NULL)
+    {
+        reportError("ERROR: Out of memory while building index.\n");
+        return 0;
+    }
+    return 1;
+}
+
+void freeIndexTable(struct IndexTable *table)
+{
+    free(table->slots);
+    table->slots = NULL;
+}
+
+struct IndexSlot *indexTableFind(struct IndexTable *table, const char *key)
+{
+    unsigned int hash = hashIndexKey(key);
+    unsigned int mask = table->header.slotCount - 1;
+    for (unsigned int i = hash & mask, probes = 0; probes < table->header.slotCount; i = (i + 1) & mask, probes++)
+    {
+        struct IndexSlot *slot = &table->slots[i];
+        if (slot->state == INDEX_SLOT_EMPTY)
+            return NULL;
+        if (slot->state == INDEX_SLOT_USED && slot->hash == hash && strcmp(slot->key, key) == 0)
+            return slot;
+    }
+    return NULL;
+}
+
+// Rebuilds the table without its tombstones, doubling it only when the live entries alone need the room.
+static int rehashIndexTable(struct IndexTable *table)
+{
+    struct IndexTable grown;
+    unsigned int expected = table->header.usedCount + 1;
+    if (expected < table->header.slotCount / 2)
+        expected = table->header.slotCount / 2;
+    if (!initIndexTable(&grown, table->header.magic, expected))
+        return 0;
+    for (unsigned int i = 0; i < table->header.slotCount; i++)
+    {
+        struct IndexSlot *slot = &table->slots[i];
+        if (slot->state == INDEX_SLOT_USED)
+            indexTablePut(&grown, slot->key, slot->offset, slot->length, 1);
+    }
+    freeIndexTable(table);
+    *table = grown;
+    return 1;
+}
+
+// Returns 1 when stored, 0 when the key exists and replace is off, -1 on error.
+int indexTablePut(struct IndexTable *table, const char *key, long long offset, long long length, int replace)
+{
+    if (strlen(key) >= INDEX_KEY_SIZE)
+        return -1;
+    struct IndexSlot *existing = indexTableFind(table, key);
+    if (existing != NULL)
+    {
+        if (!replace)
+            return 0;
+        existing->offset = offset;
+        existing->length = length;
+        return 1;
+    }
+    if ((table->header.usedCount + table->header.deletedCount + 1) * 10 > table->header.slotCount * 7 &&
+        !rehashIndexTable(table))
+        return -1;
+    unsigned int hash = hashIndexKey(key);
+    unsigned int mask = table->header.slotCount - 1;
+    unsigned int i = hash & mask;
+    while (table->slots[i].state == INDEX_SLOT_USED)
+        i = (i + 1) & mask;
+    struct IndexSlot *slot = &table->slots[i];
+    if (slot->state == INDEX_SLOT_DELETED && table->header.deletedCount > 0)
+        table->header.deletedCount--;
+    memset(slot, 0, sizeof(*slot));
+    slot->hash = hash;
+    slot->state = INDEX_SLOT_USED;
+    strcpy(slot->key, key);
+    slot->offset = offset;
+    slot->length = length;
+    table->header.usedCount++;
+    return 1;
+}
+
+int indexTableRemove(struct IndexTable *table, const char *key)
+{
+    struct IndexSlot *slot = indexTableFind(table, key);
+    if (slot == NULL)
+        return 0;
+    slot->state = INDEX_SLOT_DELETED;
+    table->header.usedCount--;
+    table->header.deletedCount++;
+    return 1;
+}
+
+int loadIndexTable(struct IndexTable *table, const char *path, const char *magic)
+{
+    memset(table, 0, sizeof(*table));
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+        return 0;
+    int ok = readData(&table->header, sizeof(table->header), 1, file) == 1 &&
+             strncmp(table->header.magic, magic, sizeof(table->header.magic)) == 0 &&
+             table->header.version == INDEX_VERSION &&
+             table->header.slotCount >= INDEX_MIN_SLOTS &&
+             (table->header.slotCount & (table->header.slotCount - 1)) == 0;
+    if (ok)
+    {
+        table->slots = malloc((size_t)table->header.slotCount * sizeof(struct IndexSlot));
+        ok = table->slots != NULL &&
+             readData(table->slots, sizeof(struct IndexSlot), table->header.slotCount, file) == table->header.slotCount;
+    }
+    fclose(file);
+    if (!ok)
+        freeIndexTable(table);
+    return ok;
+}
+
+// Stamps the table with the data file's current size and mtime, then replaces the index file atomically.
+int saveIndexTable(struct IndexTable *table, const char *path, const char *dataPath)
+{
+    char tempPath[256];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    if (!getFileStamp(dataPath, &table->header.dataSize, &table->header.dataModified))
+    {
+        table->header.dataSize = 0;
+        table->header.dataModified = 0;
+    }
+    FILE *file = fopen(tempPath, "wb");
+    if (file == NULL)
+    {
+        reportSystemError("Error creating index file");
+        return 0;
+    }
+    int ok = fwrite(&table->header, sizeof(table->header), 1, file) == 1 &&
+             fwrite(table->slots, sizeof(struct IndexSlot), table->header.slotCount, file) == table->header.slotCount;
+    if (fclose(file) != 0)
+        ok = 0;
+    if (!ok || rename(tempPath, path) != 0)
+    {
+        reportSystemError("Error writing index file");
+        remove(tempPath);
+        return 0;
+    }
+    return 1;
+}
+
+// Opens an index for point lookups; returns 0 if it is missing, corrupt or older than dataPath.
+int openDiskIndex(struct DiskIndex *index, const char *path, const char *magic, const char *dataPath)
+{
+    memset(index, 0, sizeof(*index));
+    index->path = path;
+    index->dataPath = dataPath;
+    index->file = fopen(path, "rb+");
+    if (index->file == NULL)
+        return 0;
+    long long dataSize = 0, dataModified = 0;
+    if (readData(&index->header, sizeof(index->header), 1, index->file) != 1 ||
+        strncmp(index->header.magic, magic, sizeof(index->header.magic)) != 0 ||
+        index->header.version != INDEX_VERSION ||
+        index->header.slotCount < INDEX_MIN_SLOTS ||
+        (index->header.slotCount & (index->header.slotCount - 1)) != 0 ||
+        !getFileStamp(dataPath, &dataSize, &dataModified) ||
+        dataSize != index->header.dataSize || dataModified != index->header.dataModified)
+    {
+        closeDiskIndex(index);
+        return 0;
+    }
+    return 1;
+}
+
+void closeDiskIndex(struct DiskIndex *index)
+{
+    if (index->file != NULL)
+        fclose(index->file);
+    index->file = NULL;
+}
+
+static int readIndexSlot(struct DiskIndex *index, unsigned int i, struct IndexSlot *slot)
+{
+    long long pos = (long long)sizeof(struct IndexHeader) + (long long)i * (long long)sizeof(struct IndexSlot);
+    return seekData(index->file, (off_t)pos, SEEK_SET) == 0 && readData(slot, sizeof(*slot), 1, index->file) == 1;
+}
+
+static int writeIndexSlot(struct DiskIndex *index, unsigned int i, const struct IndexSlot *slot)
+{
+    long long pos = (long long)sizeof(struct IndexHeader) + (long long)i * (long long)sizeof(struct IndexSlot);
+    return seekData(index->file, (off_t)pos, SEEK_SET) == 0 && fwrite(slot, sizeof(*slot), 1, index->file) == 1;
+}
+
+// Probes the on-disk table for key; returns the slot number, or -1 when absent. *emptySlot receives the first
+// free slot seen and *emptyState whether it is empty or a tombstone.
+static long probeDiskIndex(struct DiskIndex *index, const char *key, struct IndexSlot *found, long *emptySlot,
+                           unsigned int *emptyState)
+{
+    unsigned int hash = hashIndexKey(key);
+    unsigned int mask = index->header.slotCount - 1;
+    struct IndexSlot slot;
+    if (emptySlot != NULL)
+        *emptySlot = -1;
+    for (unsigned int i = hash & mask, probes = 0; probes < index->header.slotCount; i = (i + 1) & mask, probes++)
+    {
+        if (!readIndexSlot(index, i, &slot))
+            return -1;
+        if (slot.state != INDEX_SLOT_USED && emptySlot != NULL && *emptySlot < 0)
+        {
+            *emptySlot = (long)i;
+            *emptyState = slot.state;
+        }
+        if (slot.state == INDEX_SLOT_EMPTY)
+            return -1;
+        if (slot.state == INDEX_SLOT_USED && slot.hash == hash && strcmp(slot.key, key) == 0)
+        {
+            if (found != NULL)
+                *found = slot;
+            return (long)i;
+        }
+    }
+    return -1;
+}
+
+int diskIndexFind(struct DiskIndex *index, const char *key, struct IndexSlot *found)
+{
+    return probeDiskIndex(index, key, found, NULL, NULL) >= 0;
+}
+
+static int stampDiskIndex(struct DiskIndex *index)
+{
+    if (!getFileStamp(index->dataPath, &index->header.dataSize, &index->header.dataModified))
+        return 0;
+    return seekData(index->file, 0, SEEK_SET) == 0 &&
+           fwrite(&index->header, sizeof(index->header), 1, index->file) == 1 &&
+           fflush(index->file) == 0;
+}
+
+// Adds or replaces one entry in place, reusing the first tombstone on its probe path. The table is rewritten,
+// without its tombstones, only when a new key would push live and deleted slots together past 70%.
+int diskIndexPut(struct DiskIndex *index, const char *key, long long offset, long long length)
+{
+    if (strlen(key) >= INDEX_KEY_SIZE)
+        return 0;
+    long emptySlot = -1;
+    unsigned int emptyState = INDEX_SLOT_EMPTY;
+    struct IndexSlot slot;
+    long existing = probeDiskIndex(index, key, &slot, &emptySlot, &emptyState);
+    int reuse = existing < 0 && emptySlot >= 0 && emptyState == INDEX_SLOT_DELETED;
+    if (existing < 0 && !reuse &&
+        (emptySlot < 0 ||
+         (index->header.usedCount + index->header.deletedCount + 1) * 10 > index->header.slotCount * 7))
+    {
+        struct IndexTable table;
+        char magic[sizeof(index->header.magic) + 1] = "";
+        memcpy(magic, index->header.magic, sizeof(index->header.magic));
+        closeDiskIndex(index);
+        if (!loadIndexTable(&table, index->path, magic))
+            return 0;
+        int ok = rehashIndexTable(&table) && indexTablePut(&table, key, offset, length, 1) > 0 &&
+                 saveIndexTable(&table, index->path, index->dataPath);
+        freeIndexTable(&table);
+        return ok && openDiskIndex(index, index->path, magic, index->dataPath);
+    }
+    memset(&slot, 0, sizeof(slot));
+    slot.hash = hashIndexKey(key);
+    slot.state = INDEX_SLOT_USED;
+    strcpy(slot.key, key);
+    slot.offset = offset;
+    slot.length = length;
+    if (!writeIndexSlot(index, (unsigned int)(existing >= 0 ? existing : emptySlot), &slot))
+        return 0;
+    if (existing < 0)
+        index->header.usedCount++;
+    if (reuse && index->header.deletedCount > 0) // indexes written before the count was kept start at 0
+        index->header.deletedCount--;
+    return stampDiskIndex(index);
+}
+
+int diskIndexRemove(struct DiskIndex *index, const char *key)
+{
+    struct IndexSlot slot;
+    long existing = probeDiskIndex(index, key, &slot, NULL, NULL);
+    if (existing >= 0)
+    {
+        slot.state = INDEX_SLOT_DELETED;
+        if (!writeIndexSlot(index, (unsigned int)existing, &slot))
+            return 0;
+        index->header.usedCount--;
+        index->header.deletedCount++;
+    }
+    return stampDiskIndex(index);
+}
+
+int makeStudentKey(char *key, const char *departmentName, const char *studentID)
+{
+    size_t deptLen = strlen(departmentName);
+    size_t idLen = strlen(studentID);
+    if (deptLen + idLen + 2 > INDEX_KEY_SIZE)
+        return 0;
+    memcpy(key, departmentName, deptLen);
+    key[deptLen] = '|';
+    memcpy(key + deptLen + 1, studentID, idLen + 1);
+    return 1;
+}
+
+static int makeStudentKeyFromView(char *key, const struct StudentRecordView *record)
+{
+    struct FieldView dept = record->field[FIELD_DEPARTMENT];
+    struct FieldView id = record->field[FIELD_ID];
+    if (dept.len == 0 || id.len == 0 || dept.len + id.len + 2 > INDEX_KEY_SIZE)
+        return 0;
+    snprintf(key, INDEX_KEY_SIZE, "%.*s|%.*s", FIELD_ARGS(dept), FIELD_ARGS(id));
+    return 1;
+}
+
+// Student index entries hold record numbers in students.dat rather than byte offsets.
+int rebuildStudentIndex(FILE *studentFile)
+{
+    struct StudentMap map;
+    const struct StudentRecord *records;
+    long long count;
+    struct IndexTable table;
+    char key[INDEX_KEY_SIZE];
+    long indexed = 0, duplicates = 0;
+
+    if (!mapStudentStore(studentFile, &map, POSIX_MADV_SEQUENTIAL, &records, &count))
+        return 0;
+    if (!initIndexTable(&table, STUDENT_INDEX_MAGIC, (unsigned int)count))
+    {
+        unmapStudentFile(&map);
+        return 0;
+    }
+    for (long long i = 0; i < count; i++)
+    {
+        struct StudentRecordView record;
+        if (records[i].state != STUDENT_RECORD_LIVE)
+            continue;
+        studentRecordView(&records[i], &record);
+        if (!makeStudentKeyFromView(key, &record))
+            continue;
+        int added = indexTablePut(&table, key, i, (long long)sizeof(struct StudentRecord), 0);
+        if (added > 0)
+            indexed++;
+        else if (added == 0)
+            duplicates++;
+    }
+    unmapStudentFile(&map);
+    int ok = saveIndexTable(&table, STUDENT_INDEX_FILE, STUDENT_DATA_FILE);
+    freeIndexTable(&table);
+    if (ok)
+    {
+        notice("Student ID index rebuilt: %ld records indexed.\n", indexed);
+        if (duplicates > 0)
+            notice("Warning: %ld duplicate ID entries skipped; the first occurrence of each is indexed.\n", duplicates);
+    }
+    return ok;
+}
+
+int openStudentIndex(struct DiskIndex *index, FILE *studentFile)
+{
+    fflush(studentFile);
+    if (openDiskIndex(index, STUDENT_INDEX_FILE, STUDENT_INDEX_MAGIC, STUDENT_DATA_FILE))
+        return 1;
+    notice("INFO: Student ID index is missing or stale. Rebuilding...\n");
+    if (!rebuildStudentIndex(studentFile))
+        return 0;
+    return openDiskIndex(index, STUDENT_INDEX_FILE, STUDENT_INDEX_MAGIC, STUDENT_DATA_FILE);
+}
+
+// Looks a student up through the index and reads that one record, reporting where it lives when recordNumber
+// is not NULL. Returns 1 if found, 0 if absent, -1 on error.
+int fetchStudentRecord(FILE *studentFile, const char *departmentName, const char *studentID, struct StudentRecord *student,
+                       long long *recordNumber)
+{
+    char key[INDEX_KEY_SIZE];
+    if (!makeStudentKey(key, departmentName, studentID))
+        return 0;
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        struct DiskIndex index;
+        struct IndexSlot slot;
+        if (!openStudentIndex(&index, studentFile))
+            return -1;
+        int found = diskIndexFind(&index, key, &slot);
+        closeDiskIndex(&index);
+        if (!found)
+            return 0;
+        if (readStudentAt(studentFile, slot.offset, student) && student->state == STUDENT_RECORD_LIVE &&
+            strcmp(student->studentID, studentID) == 0 && strcmp(student->department, departmentName) == 0)
+        {
+            if (recordNumber != NULL)
+                *recordNumber = slot.offset;
+            return 1;
+        }
+
+        notice("INFO: Student ID index points at the wrong record. Rebuilding...\n");
+        if (!rebuildStudentIndex(studentFile))
+            return -1;
+    }
+    return -1;
+}
+
+// Copies the live records into a temp store and swaps it in, but only once tombstones make up at least
+// threshold of the records. Returns 1 if the store was compacted, 0 if it was left alone, -1 on error.
+int compactStudentStore(FILE **P_ptr, double threshold)
+{
+    const char *originalFilename = STUDENT_DATA_FILE;
+    const char *tempFilename = "temp_student.tmp";
+    struct StudentMap map;
+    const struct StudentRecord *records;
+    long long count;
+
+    if (!mapStudentStore(*P_ptr, &map, POSIX_MADV_SEQUENTIAL, &records, &count))
+        return -1;
+    struct StudentFileHeader header = *(const struct StudentFileHeader *)map.data;
+    double ratio = count > 0 ? (double)header.deadCount / (double)count : 0.0;
+    notice("Student store: %lld records, %lld deleted (%.1f%% dead space).\n", count, header.deadCount, ratio * 100.0);
+    if (header.deadCount <= 0 || ratio < threshold)
+    {
+        notice("Below the %.1f%% compaction threshold; nothing to do.\n", threshold * 100.0);
+        unmapStudentFile(&map);
+        return 0;
+    }
+
+    FILE *tempFile = fopen(tempFilename, "wb");
+    if (tempFile == NULL)
+    {
+        reportSystemError("Error creating temporary file");
+        unmapStudentFile(&map);
+        return -1;
+    }
+    long long kept = 0;
+    header.deadCount = 0;
+    int ok = fwrite(&header, sizeof(header), 1, tempFile) == 1;
+    for (long long i = 0; ok && i < count; i++)
+    {
+        if (records[i].state != STUDENT_RECORD_LIVE)
+            continue;
+        ok = fwrite(&records[i], sizeof(records[i]), 1, tempFile) == 1;
+        kept++;
+        hotPath.rewriteBytes += (long long)sizeof(records[i]);
+    }
+    if (fclose(tempFile) != 0)
+        ok = 0;
+    unmapStudentFile(&map);
+    if (!ok)
+    {
+        reportSystemError("Error writing temp student file");
+        remove(tempFilename);
+        return -1;
+    }
+
+    fclose(*P_ptr);
+    *P_ptr = NULL;
+    if (remove(originalFilename) != 0)
+    {
+        reportSystemError("Error deleting original student file");
+        reportError("Error: Original file could not be deleted. Temp data in '%s'\n", tempFilename);
+        ok = 0;
+    }
+    else if (rename(tempFilename, originalFilename) != 0)
+    {
+        reportSystemError("Error renaming temp file to original");
+        reportError("CRITICAL Error: Original deleted, temp rename failed. Data potentially lost. Temp file is '%s'\n", tempFilename);
+        ok = 0;
+    }
+    *P_ptr = fopen(originalFilename, "rb+");
+    if (*P_ptr == NULL)
+    {
+        reportSystemError("FATAL: Could not reopen student file after compaction");
+        exit(EXIT_FAILURE);
+    }
+    if (!ok)
+        return -1;
+    notice("Compacted: %lld live records kept, %lld bytes reclaimed.\n", kept,
+           (count - kept) * (long long)sizeof(struct StudentRecord));
+    // Record numbers changed, so both indexes are rebuilt from the compacted store.
+    rebuildStudentIndex(*P_ptr);
+    rebuildRosterIndex(*P_ptr);
+    return 1;
+}
+
+static int growCodeSlots(struct CodePool *pool)
+{
+    unsigned int slotCount = pool->slotCount ? pool->slotCount * 2 : 64;
+    int *slots = malloc(slotCount * sizeof(int));
+    if (slots == NULL)
+        return 0;
+    for (unsigned int i = 0; i < slotCount; i++)
+        slots[i] = -1;
+    for (unsigned int code = 0; code < pool->count; code++)
+    {
+        unsigned int i = hashBytes(pool->values[code], strlen(pool->values[code])) & (slotCount - 1);
+        while (slots[i] >= 0)
+            i = (i + 1) & (slotCount - 1);
+        slots[i] = (int)code;
+    }
+    free(pool->slots);
+    pool->slots = slots;
+    pool->slotCount = slotCount;
+    return 1;
+}
+
+// Returns the code for value, or -1 with *emptySlot set to where it would be inserted.
+static long lookupCode(const struct CodePool *pool, const char *value, size_t len, unsigned int *emptySlot)
+{
+    if (pool->slotCount == 0)
+        return -1;
+    unsigned int mask = pool->slotCount - 1;
+    unsigned int i = hashBytes(value, len) & mask;
+    while (pool->slots[i] >= 0)
+    {
+        const char *candidate = pool->values[pool->slots[i]];
+        if (strncmp(candidate, value, len) == 0 && candidate[len] == '\0')
+            return pool->slots[i];
+        i = (i + 1) & mask;
+    }
+    if (emptySlot != NULL)
+        *emptySlot = i;
+    return -1;
+}
+
+static long internCode(struct CodePool *pool, struct FieldView value)
+{
+    if (value.ptr == NULL)
+        value.ptr = "";
+    if ((pool->count + 1) * 2 > pool->slotCount && !growCodeSlots(pool))
+        return -1;
+    unsigned int slot = 0;
+    long code = lookupCode(pool, value.ptr, value.len, &slot);
+    if (code >= 0)
+        return code;
+    if (pool->count == pool->capacity)
+    {
+        unsigned int capacity = pool->capacity ? pool->capacity * 2 : 16;
+        char **values = realloc(pool->values, capacity * sizeof(char *));
+        if (values == NULL)
+            return -1;
+        pool->values = values;
+        pool->capacity = capacity;
+    }
+    char *copy = malloc(value.len + 1);
+    if (copy == NULL)
+        return -1;
+    memcpy(copy, value.ptr, value.len);
+    copy[value.len] = '\0';
+    pool->values[pool->count] = copy;
+    pool->slots[slot] = (int)pool->count;
+    return pool->count++;
+}
+
+static void freeCodePool(struct CodePool *pool)
+{
+    for (unsigned int code = 0; code < pool->count; code++)
+        free(pool->values[code]);
+    free(pool->values);
+    free(pool->slots);
+    memset(pool, 0, sizeof(*pool));
+}
+
+long findStudentCode(const struct StudentTable *table, const char *value)
+{
+    return lookupCode(&table->codes, value, strlen(value), NULL);
+}
+
+static size_t addTableText(struct StudentTable *table, struct FieldView value)
+{
+    size_t needed = table->heapUsed + value.len + 1;
+    if (needed > table->heapCapacity)
+    {
+        size_t capacity = table->heapCapacity ? table->heapCapacity : 65536;
+        while (capacity < needed)
+            capacity *= 2;
+        char *heap = realloc(table->heap, capacity);
+        if (heap == NULL)
+            return (size_t)-1;
+        table->heap = heap;
+        table->heapCapacity = capacity;
+    }
+    size_t offset = table->heapUsed;
+    if (value.len > 0)
+        memcpy(table->heap + offset, value.ptr, value.len);
+    table->heap[offset + value.len] = '\0';
+    table->heapUsed = needed;
+    return offset;
+}
+
+static void *growColumn(void *column, size_t elementSize, size_t capacity, int *ok)
+{
+    void *grown = realloc(column, elementSize * capacity);
+    if (grown == NULL)
+    {
+        *ok = 0;
+        return column;
+    }
+    return grown;
+}
+
+static int growStudentTable(struct StudentTable *table)
+{
+    size_t capacity = table->capacity ? table->capacity * 2 : STUDENT_TABLE_MIN_ROWS;
+    int ok = 1;
+    table->idText = growColumn(table->idText, sizeof(*table->idText), capacity, &ok);
+    table->nameText = growColumn(table->nameText, sizeof(*table->nameText), capacity, &ok);
+    table->mobileText = growColumn(table->mobileText, sizeof(*table->mobileText), capacity, &ok);
+    table->deptCode = growColumn(table->deptCode, sizeof(*table->deptCode), capacity, &ok);
+    table->intakeCode = growColumn(table->intakeCode, sizeof(*table->intakeCode), capacity, &ok);
+    table->sectionCode = growColumn(table->sectionCode, sizeof(*table->sectionCode), capacity, &ok);
+    table->recordNumber = growColumn(table->recordNumber, sizeof(*table->recordNumber), capacity, &ok);
+    table->live = growColumn(table->live, sizeof(*table->live), capacity, &ok);
+    if (ok)
+        table->capacity = capacity;
+    return ok;
+}
+
+// Returns the slot holding (deptCode, id), or -1 with *emptySlot set to the first reusable slot.
+static long probeStudentRow(const struct StudentTable *table, unsigned int deptCode, const char *id, size_t len, size_t *emptySlot)
+{
+    size_t mask = table->idSlotCount - 1;
+    size_t i = (hashBytes(id, len) ^ deptCode * 2654435761u) & mask;
+    long reusable = -1;
+    while (table->idSlots[i] != TABLE_ROW_NONE)
+    {
+        long row = table->idSlots[i];
+        if (row == TABLE_ROW_DELETED)
+        {
+            if (reusable < 0)
+                reusable = (long)i;
+        }
+        else if (table->deptCode[row] == deptCode && strncmp(TABLE_TEXT(table, idText, row), id, len) == 0 &&
+                 TABLE_TEXT(table, idText, row)[len] == '\0')
+        {
+            return (long)i;
+        }
+        i = (i + 1) & mask;
+    }
+    if (emptySlot != NULL)
+        *emptySlot = reusable >= 0 ? (size_t)reusable : i;
+    return -1;
+}
+
+// Makes row findable by ID unless an earlier row already holds its key; the first occurrence wins, as in test.idx.
+static void linkStudentRow(struct StudentTable *table, size_t row)
+{
+    const char *id = TABLE_TEXT(table, idText, row);
+    size_t slot = 0;
+    if (probeStudentRow(table, table->deptCode[row], id, strlen(id), &slot) >= 0)
+        return;
+    if (table->idSlots[slot] == TABLE_ROW_NONE)
+        table->idSlotUsed++;
+    table->idSlots[slot] = (long)row;
+}
+
+static int rehashStudentRows(struct StudentTable *table, size_t expectedRows)
+{
+    size_t slotCount = STUDENT_TABLE_MIN_ROWS;
+    while (slotCount < expectedRows * 2)
+        slotCount *= 2;
+    long *slots = malloc(slotCount * sizeof(long));
+    if (slots == NULL)
+        return 0;
+    for (size_t i = 0; i < slotCount; i++)
+        slots[i] = TABLE_ROW_NONE;
+    free(table->idSlots);
+    table->idSlots = slots;
+    table->idSlotCount = slotCount;
+    table->idSlotUsed = 0;
+    for (size_t row = 0; row < table->count; row++)
+    {
+        if (table->live[row])
+            linkStudentRow(table, row);
+    }
+    return 1;
+}
+
+#define TRIGRAM(p) (((unsigned int)(unsigned char)(p)[0] << 16) | ((unsigned int)(unsigned char)(p)[1] << 8) | (unsigned char)(p)[2])
+
+static long findTrigramList(const struct TrigramIndex *index, unsigned int gram, unsigned int *emptySlot)
+{
+    if (index->slotCount == 0)
+        return -1;
+    unsigned int mask = index->slotCount - 1;
+    unsigned int i = (gram * 2654435761u) & mask;
+    while (index->slotGram[i] != 0)
+    {
+        if (index->slotGram[i] == gram + 1)
+            return index->slotList[i];
+        i = (i + 1) & mask;
+    }
+    if (emptySlot != NULL)
+        *emptySlot = i;
+    return -1;
+}
+
+static int growTrigramSlots(struct TrigramIndex *index)
+{
+    unsigned int slotCount = index->slotCount ? index->slotCount * 2 : 4096;
+    unsigned int *slotGram = calloc(slotCount, sizeof(unsigned int));
+    unsigned int *slotList = malloc(slotCount * sizeof(unsigned int));
+    if (slotGram == NULL || slotList == NULL)
+    {
+        free(slotGram);
+        free(slotList);
+        return 0;
+    }
+    for (unsigned int j = 0; j < index->slotCount; j++)
+    {
+        if (index->slotGram[j] == 0)
+            continue;
+        unsigned int i = ((index->slotGram[j] - 1) * 2654435761u) & (slotCount - 1);
+        while (slotGram[i] != 0)
+            i = (i + 1) & (slotCount - 1);
+        slotGram[i] = index->slotGram[j];
+        slotList[i] = index->slotList[j];
+    }
+    free(index->slotGram);
+    free(index->slotList);
+    index->slotGram = slotGram;
+    index->slotList = slotList;
+    index->slotCount = slotCount;
+    return 1;
+}
+
+// Rows mostly arrive in ascending order and are appended; an updated row is inserted in place instead.
+static int addPosting(struct PostingList *list, unsigned int row)
+{
+    unsigned int at = list->count;
+    if (list->count > 0 && list->rows[list->count - 1] >= row)
+    {
+        unsigned int lo = 0, hi = list->count;
+        while (lo < hi)
+        {
+            unsigned int mid = lo + (hi - lo) / 2;
+            if (list->rows[mid] < row)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (list->rows[lo] == row)
+            return 1;
+        at = lo;
+    }
+    if (list->count == list->capacity)
+    {
+        unsigned int capacity = list->capacity ? list->capacity * 2 : 4;
+        unsigned int *rows = realloc(list->rows, capacity * sizeof(unsigned int));
+        if (rows == NULL)
+            return 0;
+        list->rows = rows;
+        list->capacity = capacity;
+    }
+    memmove(list->rows + at + 1, list->rows + at, (list->count - at) * sizeof(unsigned int));
+    list->rows[at] = row;
+    list->count++;
+    return 1;
+}
+
+// Adds row under every trigram of name. Old names are never removed: searches re-check each candidate.
+static int indexStudentName(struct TrigramIndex *index, const char *name, unsigned int row)
+{
+    size_t len = strlen(name);
+    for (size_t i = 0; i + 3 <= len; i++)
+    {
+        unsigned int gram = TRIGRAM(name + i);
+        unsigned int slot = 0;
+        if ((index->listCount + 1) * 2 > index->slotCount && !growTrigramSlots(index))
+            return 0;
+        long list = findTrigramList(index, gram, &slot);
+        if (list < 0)
+        {
+            if (index->listCount == index->listCapacity)
+            {
+                unsigned int capacity = index->listCapacity ? index->listCapacity * 2 : 1024;
+                struct PostingList *lists = realloc(index->lists, capacity * sizeof(struct PostingList));
+                if (lists == NULL)
+                    return 0;
+                index->lists = lists;
+                index->listCapacity = capacity;
+            }
+            list = index->listCount++;
+            memset(&index->lists[list], 0, sizeof(struct PostingList));
+            index->slotGram[slot] = gram + 1;
+            index->slotList[slot] = (unsigned int)list;
+        }
+        if (!addPosting(&index->lists[list], row))
+            return 0;
+    }
+    return 1;
+}
+
+static void freeTrigramIndex(struct TrigramIndex *index)
+{
+    for (unsigned int i = 0; i < index->listCount; i++)
+        free(index->lists[i].rows);
+    free(index->lists);
+    free(index->slotGram);
+    free(index->slotList);
+    memset(index, 0, sizeof(*index));
+}
+
+static int containsRow(const struct PostingList *list, unsigned int row)
+{
+    unsigned int lo = 0, hi = list->count;
+    while (lo < hi)
+    {
+        unsigned int mid = lo + (hi - lo) / 2;
+        if (list->rows[mid] < row)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < list->count && list->rows[lo] == row;
+}
+
+// Collects the live rows of deptCode whose name contains needle, in file order, into a malloc'd *rows.
+// Needles of three or more bytes intersect trigram posting lists, smallest first, and only the surviving
+// candidates are checked with strstr. Returns the match count, or -1 when memory runs out.
+long searchStudentNames(const struct StudentTable *table, long deptCode, const char *needle, unsigned int **rows)
+{
+    const struct TrigramIndex *index = &table->names;
+    size_t len = strlen(needle);
+    size_t gramCount = len >= 3 ? len - 2 : 0;
+    const struct PostingList *smallest = NULL;
+    *rows = NULL;
+    if (deptCode < 0)
+        return 0;
+    const struct PostingList **grams = malloc((gramCount ? gramCount : 1) * sizeof(*grams));
+    if (grams == NULL)
+        return -1;
+    for (size_t i = 0; i < gramCount; i++)
+    {
+        long list = findTrigramList(index, TRIGRAM(needle + i), NULL);
+        if (list < 0)
+        {
+            free(grams);
+            return 0;
+        }
+        grams[i] = &index->lists[list];
+        if (smallest == NULL || grams[i]->count < smallest->count)
+            smallest = grams[i];
+    }
+
+    size_t candidates = smallest ? smallest->count : table->count;
+    unsigned int *matches = malloc((candidates ? candidates : 1) * sizeof(unsigned int));
+    if (matches == NULL)
+    {
+        free(grams);
+        return -1;
+    }
+    long found = 0;
+    hotPath.recordsScanned += (long long)candidates;
+    for (size_t c = 0; c < candidates; c++)
+    {
+        unsigned int row = smallest ? smallest->rows[c] : (unsigned int)c;
+        if (!table->live[row] || table->deptCode[row] != (unsigned int)deptCode)
+            continue;
+        int inAll = 1;
+        for (size_t i = 0; inAll && i < gramCount; i++)
+        {
+            if (grams[i] != smallest)
+                inAll = containsRow(grams[i], row);
+        }
+        if (inAll && strstr(TABLE_TEXT(table, nameText, row), needle) != NULL)
+            matches[found++] = row;
+    }
+    free(grams);
+    *rows = matches;
+    return found;
+}
+
+// Appends a record as a new row. Returns the row number, or -1 when memory runs out.
+long studentTableAppend(struct StudentTable *table, const struct StudentRecordView *record, long long recordNumber)
+{
+    if (table->count == table->capacity && !growStudentTable(table))
+        return -1;
+    if ((table->idSlotUsed + 1) * 2 > table->idSlotCount && !rehashStudentRows(table, table->liveCount + 1))
+        return -1;
+    long dept = internCode(&table->codes, record->field[FIELD_DEPARTMENT]);
+    long intake = internCode(&table->codes, record->field[FIELD_INTAKE]);
+    long section = internCode(&table->codes, record->field[FIELD_SECTION]);
+    size_t id = addTableText(table, record->field[FIELD_ID]);
+    size_t name = addTableText(table, record->field[FIELD_NAME]);
+    size_t mobile = addTableText(table, record->field[FIELD_MOBILE]);
+    if (dept < 0 || intake < 0 || section < 0 || id == (size_t)-1 || name == (size_t)-1 || mobile == (size_t)-1)
+        return -1;
+
+    size_t row = table->count++;
+    table->idText[row] = id;
+    table->nameText[row] = name;
+    table->mobileText[row] = mobile;
+    table->deptCode[row] = (unsigned int)dept;
+    table->intakeCode[row] = (unsigned int)intake;
+    table->sectionCode[row] = (unsigned int)section;
+    table->recordNumber[row] = recordNumber;
+    table->live[row] = 1;
+    table->liveCount++;
+    linkStudentRow(table, row);
+    if (!indexStudentName(&table->names, TABLE_TEXT(table, nameText, row), (unsigned int)row))
+        return -1;
+    return (long)row;
+}
+
+long studentTableFind(const struct StudentTable *table, const char *departmentName, const char *studentID)
+{
+    long dept = findStudentCode(table, departmentName);
+    if (dept < 0 || table->idSlotCount == 0)
+        return -1;
+    long slot = probeStudentRow(table, (unsigned int)dept, studentID, strlen(studentID), NULL);
+    return slot < 0 ? -1 : table->idSlots[slot];
+}
+
+void studentTableRemove(struct StudentTable *table, long row)
+{
+    const char *id = TABLE_TEXT(table, idText, row);
+    long slot = probeStudentRow(table, table->deptCode[row], id, strlen(id), NULL);
+    if (slot >= 0 && table->idSlots[slot] == row)
+        table->idSlots[slot] = TABLE_ROW_DELETED;
+    table->live[row] = 0;
+    table->liveCount--;
+}
+
+// Refreshes the columns an update can change; department, ID and record number stay fixed.
+int studentTableReplace(struct StudentTable *table, long row, const struct StudentRecordView *record)
+{
+    long intake = internCode(&table->codes, record->field[FIELD_INTAKE]);
+    long section = internCode(&table->codes, record->field[FIELD_SECTION]);
+    size_t name = addTableText(table, record->field[FIELD_NAME]);
+    size_t mobile = addTableText(table, record->field[FIELD_MOBILE]);
+    if (intake < 0 || section < 0 || name == (size_t)-1 || mobile == (size_t)-1)
+        return 0;
+    table->nameText[row] = name;
+    table->mobileText[row] = mobile;
+    table->intakeCode[row] = (unsigned int)intake;
+    table->sectionCode[row] = (unsigned int)section;
+    return indexStudentName(&table->names, TABLE_TEXT(table, nameText, row), (unsigned int)row);
+}
+
+void stampStudentTable(struct StudentTable *table)
+{
+    if (!getFileStamp(STUDENT_DATA_FILE, &table->dataSize, &table->dataModified))
+    {
+        table->dataSize = 0;
+        table->dataModified = 0;
+    }
+}
+
+int loadStudentTable(struct StudentTable *table, FILE *studentFile)
+{
+    struct StudentMap map;
+    const struct StudentRecord *records;
+    long long count;
+    memset(table, 0, sizeof(*table));
+    if (!mapStudentStore(studentFile, &map, POSIX_MADV_SEQUENTIAL, &records, &count))
+        return 0;
+    for (long long i = 0; i < count; i++)
+    {
+        struct StudentRecordView record;
+        if (records[i].state != STUDENT_RECORD_LIVE)
+            continue;
+        studentRecordView(&records[i], &record);
+        if (studentTableAppend(table, &record, i) < 0)
+        {
+            reportError("ERROR: Out of memory while loading student table.\n");
+            unmapStudentFile(&map);
+            freeStudentTable(table);
+            return 0;
+        }
+    }
+    unmapStudentFile(&map);
+    stampStudentTable(table);
+    table->loaded = 1;
+    return 1;
+}
+
+void freeStudentTable(struct StudentTable *table)
+{
+    freeCodePool(&table->codes);
+    freeTrigramIndex(&table->names);
+    free(table->idText);
+    free(table->nameText);
+    free(table->mobileText);
+    free(table->deptCode);
+    free(table->intakeCode);
+    free(table->sectionCode);
+    free(table->recordNumber);
+    free(table->live);
+    free(table->heap);
+    free(table->idSlots);
+    memset(table, 0, sizeof(*table));
+}
+
+// Reloads the table only if students.dat changed behind the session's back; otherwise costs one stat().
+int ensureStudentTable(struct StudentTable *table, FILE *studentFile)
+{
+    long long size = 0, modified = 0;
+    fflush(studentFile);
+    if (table->loaded && getFileStamp(STUDENT_DATA_FILE, &size, &modified) &&
+        size == table->dataSize && modified == table->dataModified)
+        return 1;
+    if (table->loaded)
+        notice("INFO: %s changed outside this session. Reloading student table...\n", STUDENT_DATA_FILE);
+    freeStudentTable(table);
+    return loadStudentTable(table, studentFile);
+}
+
+// Reads row's full record from students.dat. Returns 0 if the file no longer holds that student there.
+int readStudentRow(const struct StudentTable *table, FILE *studentFile, long row, struct StudentRecord *student)
+{
+    return readStudentAt(studentFile, table->recordNumber[row], student) && student->state == STUDENT_RECORD_LIVE &&
+           strcmp(student->studentID, TABLE_TEXT(table, idText, row)) == 0 &&
+           strcmp(student->department, TABLE_CODE(table, deptCode, row)) == 0;
+}
+
+int makeRosterKey(char *key, const char *departmentName, const char *intake, const char *section)
+{
+    int n = snprintf(key, ROSTER_KEY_SIZE, "%s|%s|%s", departmentName, intake, section);
+    return n > 0 && n < ROSTER_KEY_SIZE;
+}
+
+static int writeZeroBytes(FILE *file, long long bytes)
+{
+    static const char zeros[4096];
+    while (bytes > 0)
+    {
+        size_t chunk = bytes < (long long)sizeof(zeros) ? (size_t)bytes : sizeof(zeros);
+        if (fwrite(zeros, 1, chunk, file) != chunk)
+            return 0;
+        bytes -= (long long)chunk;
+    }
+    return 1;
+}
+
+// Writes a roster file from scratch: header, directory, then one record-number block per group with room
+// to grow. groupOf[i] is record i's group in groups, or -1 for a record that is not filed; what gets filed
+// is values[i], or i itself when values is NULL.
+static int writeRosterFile(const char *path, const char *magic, const char *dataPath, const struct CodePool *groups,
+                           const long *groupOf, const long long *values, long long count)
+{
+    char tempPath[256];
+    unsigned int dirCapacity = ROSTER_MIN_ENTRIES;
+    while (dirCapacity < groups->count * 2)
+        dirCapacity *= 2;
+    struct RosterEntry *entries = calloc(dirCapacity, sizeof(struct RosterEntry));
+    long long *start = calloc(groups->count + 1, sizeof(long long));
+    long long *numbers = malloc((count > 0 ? (size_t)count : 1) * sizeof(long long));
+    int ok = entries != NULL && start != NULL && numbers != NULL;
+    if (ok)
+    {
+        for (long long i = 0; i < count; i++)
+        {
+            if (groupOf[i] >= 0)
+                entries[groupOf[i]].count++;
+        }
+        long long pos = (long long)sizeof(struct IndexHeader) + (long long)dirCapacity * (long long)sizeof(struct RosterEntry);
+        for (unsigned int g = 0; g < groups->count; g++)
+        {
+            strcpy(entries[g].key, groups->values[g]);
+            entries[g].capacity = entries[g].count * 2 > ROSTER_MIN_BLOCK ? entries[g].count * 2 : ROSTER_MIN_BLOCK;
+            entries[g].blockPos = pos;
+            pos += entries[g].capacity * (long long)sizeof(long long);
+            start[g + 1] = start[g] + entries[g].count;
+        }
+        for (long long i = 0; i < count; i++)
+        {
+            if (groupOf[i] >= 0)
+                numbers[start[groupOf[i]]++] = values != NULL ? values[i] : i;
+        }
+    }
+
+    struct IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    strncpy(header.magic, magic, sizeof(header.magic) - 1);
+    header.version = INDEX_VERSION;
+    header.slotCount = dirCapacity;
+    header.usedCount = groups->count;
+    getFileStamp(dataPath, &header.dataSize, &header.dataModified);
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE *file = ok ? fopen(tempPath, "wb") : NULL;
+    if (ok && file == NULL)
+        reportSystemError("Error creating index file");
+    ok = ok && file != NULL && fwrite(&header, sizeof(header), 1, file) == 1 &&
+         fwrite(entries, sizeof(struct RosterEntry), dirCapacity, file) == dirCapacity;
+    for (unsigned int g = 0; ok && g < groups->count; g++)
+    {
+        // start[g] was advanced to the end of the group while filling numbers.
+        const long long *block = numbers + start[g] - entries[g].count;
+        ok = fwrite(block, sizeof(long long), (size_t)entries[g].count, file) == (size_t)entries[g].count &&
+             writeZeroBytes(file, (entries[g].capacity - entries[g].count) * (long long)sizeof(long long));
+    }
+    if (file != NULL && fclose(file) != 0)
+        ok = 0;
+    if (file != NULL && (!ok || rename(tempPath, path) != 0))
+    {
+        reportSystemError("Error writing index file");
+        remove(tempPath);
+        ok = 0;
+    }
+    free(entries);
+    free(start);
+    free(numbers);
+    return ok;
+}
+
+// Groups the live records by (department, intake, section) and writes students.ros from scratch.
+int rebuildRosterIndex(FILE *studentFile)
+{
+    struct StudentMap map;
+    const struct StudentRecord *records;
+    long long count;
+    struct CodePool groups;
+    char key[ROSTER_KEY_SIZE];
+
+    memset(&groups, 0, sizeof(groups));
+    if (!mapStudentStore(studentFile, &map, POSIX_MADV_SEQUENTIAL, &records, &count))
+        return 0;
+    long *groupOf = malloc((count > 0 ? (size_t)count : 1) * sizeof(long));
+    int ok = groupOf != NULL;
+    for (long long i = 0; ok && i < count; i++)
+    {
+        groupOf[i] = -1;
+        if (records[i].state != STUDENT_RECORD_LIVE)
+            continue;
+        ok = makeRosterKey(key, records[i].department, records[i].intake, records[i].section) &&
+             (groupOf[i] = internCode(&groups, (struct FieldView){key, strlen(key)})) >= 0;
+    }
+    unmapStudentFile(&map);
+    ok = ok && writeRosterFile(ROSTER_INDEX_FILE, ROSTER_INDEX_MAGIC, STUDENT_DATA_FILE, &groups, groupOf, NULL, count);
+    if (ok)
+        notice("Roster index rebuilt: %u rosters indexed.\n", groups.count);
+    else
+        reportError("ERROR: Could not rebuild roster index.\n");
+    free(groupOf);
+    freeCodePool(&groups);
+    return ok;
+}
+
+static int loadRosterDirectory(struct RosterIndex *roster, const char *path, const char *magic, const char *dataPath)
+{
+    long long dataSize = 0, dataModified = 0;
+    memset(roster, 0, sizeof(*roster));
+    roster->dataPath = dataPath;
+    roster->file = fopen(path, "rb+");
+    if (roster->file == NULL)
+        return 0;
+    int ok = readData(&roster->header, sizeof(roster->header), 1, roster->file) == 1 &&
+             strncmp(roster->header.magic, magic, sizeof(roster->header.magic)) == 0 &&
+             roster->header.version == INDEX_VERSION && roster->header.usedCount <= roster->header.slotCount &&
+             getFileStamp(dataPath, &dataSize, &dataModified) &&
+             dataSize == roster->header.dataSize && dataModified == roster->header.dataModified;
+    if (ok)
+    {
+        // Slots past usedCount are empty; rosterIndexAdd fills them in memory before writing them out.
+        roster->entries = malloc((roster->header.slotCount ? roster->header.slotCount : 1) * sizeof(struct RosterEntry));
+        ok = roster->entries != NULL &&
+             readData(roster->entries, sizeof(struct RosterEntry), roster->header.usedCount, roster->file) == roster->header.usedCount;
+    }
+    if (!ok)
+        closeRosterIndex(roster);
+    return ok;
+}
+
+int openRosterIndex(struct RosterIndex *roster, FILE *studentFile)
+{
+    fflush(studentFile);
+    if (loadRosterDirectory(roster, ROSTER_INDEX_FILE, ROSTER_INDEX_MAGIC, STUDENT_DATA_FILE))
+        return 1;
+    notice("INFO: Roster index is missing or stale. Rebuilding...\n");
+    return rebuildRosterIndex(studentFile) &&
+           loadRosterDirectory(roster, ROSTER_INDEX_FILE, ROSTER_INDEX_MAGIC, STUDENT_DATA_FILE);
+}
+
+void closeRosterIndex(struct RosterIndex *roster)
+{
+    if (roster->file != NULL)
+        fclose(roster->file);
+    free(roster->entries);
+    memset(roster, 0, sizeof(*roster));
+}
+
+static long findRosterEntry(const struct RosterIndex *roster, const char *key)
+{
+    for (unsigned int e = 0; e < roster->header.usedCount; e++)
+    {
+        if (strcmp(roster->entries[e].key, key) == 0)
+            return (long)e;
+    }
+    return -1;
+}
+
+static int writeRosterEntry(struct RosterIndex *roster, long e)
+{
+    long long pos = (long long)sizeof(struct IndexHeader) + e * (long long)sizeof(struct RosterEntry);
+    return seekData(roster->file, (off_t)pos, SEEK_SET) == 0 &&
+           fwrite(&roster->entries[e], sizeof(struct RosterEntry), 1, roster->file) == 1;
+}
+
+static int readRosterBlock(struct RosterIndex *roster, const struct RosterEntry *entry, long long *numbers)
+{
+    return entry->count == 0 ||
+           (seekData(roster->file, (off_t)entry->blockPos, SEEK_SET) == 0 &&
+            readData(numbers, sizeof(long long), (size_t)entry->count, roster->file) == (size_t)entry->count);
+}
+
+int stampRosterIndex(struct RosterIndex *roster)
+{
+    if (!getFileStamp(roster->dataPath, &roster->header.dataSize, &roster->header.dataModified))
+        return 0;
+    return seekData(roster->file, 0, SEEK_SET) == 0 &&
+           fwrite(&roster->header, sizeof(roster->header), 1, roster->file) == 1 &&
+           fflush(roster->file) == 0;
+}
+
+// Files recordNumber under key. A full block is copied to the end of the file at twice the size; a full
+// directory makes this fail, and the caller falls back to a rebuild.
+int rosterIndexAdd(struct RosterIndex *roster, const char *key, long long recordNumber)
+{
+    long e = findRosterEntry(roster, key);
+    if (e < 0)
+    {
+        if (roster->header.usedCount == roster->header.slotCount || strlen(key) >= ROSTER_KEY_SIZE)
+            return 0;
+        e = (long)roster->header.usedCount++;
+        memset(&roster->entries[e], 0, sizeof(struct RosterEntry));
+        strcpy(roster->entries[e].key, key);
+    }
+    struct RosterEntry *entry = &roster->entries[e];
+    if (entry->count == entry->capacity)
+    {
+        long long capacity = entry->capacity ? entry->capacity * 2 : ROSTER_MIN_BLOCK;
+        long long *numbers = calloc((size_t)capacity, sizeof(long long));
+        int ok = numbers != NULL && readRosterBlock(roster, entry, numbers) && seekData(roster->file, 0, SEEK_END) == 0;
+        long long blockPos = ok ? (long long)ftello(roster->file) : -1;
+        ok = ok && blockPos > 0 && fwrite(numbers, sizeof(long long), (size_t)capacity, roster->file) == (size_t)capacity;
+        free(numbers);
+        if (!ok)
+            return 0;
+        entry->blockPos = blockPos;
+        entry->capacity = capacity;
+    }
+    if (seekData(roster->file, (off_t)(entry->blockPos + entry->count * (long long)sizeof(long long)), SEEK_SET) != 0 ||
+        fwrite(&recordNumber, sizeof(recordNumber), 1, roster->file) != 1)
+        return 0;
+    entry->count++;
+    return writeRosterEntry(roster, e) && stampRosterIndex(roster);
+}
+
+// Drops recordNumber from key's block by moving the block's last number into its place.
+int rosterIndexRemove(struct RosterIndex *roster, const char *key, long long recordNumber)
+{
+    long e = findRosterEntry(roster, key);
+    if (e < 0)
+        return 0;
+    struct RosterEntry *entry = &roster->entries[e];
+    long long *numbers = malloc((entry->count > 0 ? (size_t)entry->count : 1) * sizeof(long long));
+    if (numbers == NULL || !readRosterBlock(roster, entry, numbers))
+    {
+        free(numbers);
+        return 0;
+    }
+    long long i = 0;
+    while (i < entry->count && numbers[i] != recordNumber)
+        i++;
+    int ok = i < entry->count &&
+             seekData(roster->file, (off_t)(entry->blockPos + i * (long long)sizeof(long long)), SEEK_SET) == 0 &&
+             fwrite(&numbers[entry->count - 1], sizeof(long long), 1, roster->file) == 1;
+    free(numbers);
+    if (!ok)
+        return 0;
+    entry->count--;
+    return writeRosterEntry(roster, e) && stampRosterIndex(roster);
+}
+
+static int compareRecordNumbers(const void *a, const void *b)
+{
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+// Collects the record numbers filed under key, or under every key starting with it when prefix is set,
+// sorted into store order. Returns the count with a malloc'd array in *recordNumbers, or -1 on error.
+long long rosterIndexCollect(struct RosterIndex *roster, const char *key, int prefix, long long **recordNumbers)
+{
+    size_t keyLen = strlen(key);
+    long long total = 0;
+    *recordNumbers = NULL;
+    for (unsigned int e = 0; e < roster->header.usedCount; e++)
+    {
+        if (prefix ? strncmp(roster->entries[e].key, key, keyLen) == 0 : strcmp(roster->entries[e].key, key) == 0)
+            total += roster->entries[e].count;
+    }
+    long long *numbers = malloc((total > 0 ? (size_t)total : 1) * sizeof(long long));
+    if (numbers == NULL)
+        return -1;
+    long long filled = 0;
+    for (unsigned int e = 0; e < roster->header.usedCount; e++)
+    {
+        const struct RosterEntry *entry = &roster->entries[e];
+        if (!(prefix ? strncmp(entry->key, key, keyLen) == 0 : strcmp(entry->key, key) == 0))
+            continue;
+        if (!readRosterBlock(roster, entry, numbers + filled))
+        {
+            free(numbers);
+            return -1;
+        }
+        filled += entry->count;
+    }
+    qsort(numbers, (size_t)filled, sizeof(long long), compareRecordNumbers);
+    *recordNumbers = numbers;
+    return filled;
+}
+
+// A roster index that could not be patched is simply rebuilt from the store, which already holds the change.
+static void settleRosterIndex(struct RosterIndex *roster, int patched, FILE *studentFile)
+{
+    closeRosterIndex(roster);
+    if (!patched)
+        rebuildRosterIndex(studentFile);
+}
+
+// Appends student and files it in the ID and roster indexes. Returns its record number, or -1 on error.
+long long insertStudentRecord(FILE *studentFile, const struct StudentRecord *student)
+{
+    char key[INDEX_KEY_SIZE];
+    char rosterKey[ROSTER_KEY_SIZE];
+    struct DiskIndex index;
+    struct RosterIndex roster;
+
+    if (!makeStudentKey(key, student->department, student->studentID) ||
+        !makeRosterKey(rosterKey, student->department, student->intake, student->section))
+        return -1;
+    if (!openStudentIndex(&index, studentFile))
+        return -1;
+    if (!openRosterIndex(&roster, studentFile))
+    {
+        closeDiskIndex(&index);
+        return -1;
+    }
+    long long recordNumber = appendStudent(studentFile, student);
+    if (recordNumber >= 0)
+    {
+        if (!diskIndexPut(&index, key, recordNumber, (long long)sizeof(struct StudentRecord)))
+            reportError("Warning: Student ID index could not be updated; it will be rebuilt on the next lookup.\n");
+        settleRosterIndex(&roster, rosterIndexAdd(&roster, rosterKey, recordNumber), studentFile);
+    }
+    else
+    {
+        closeRosterIndex(&roster);
+    }
+    closeDiskIndex(&index);
+    return recordNumber;
+}
+
+// Rewrites recordNumber in place through replaceStudentAt and moves it between rosters if its intake or
+// section changed. Returns 1 if written, 0 if the record changed underneath, -1 on error.
+int updateStudentRecord(FILE *studentFile, long long recordNumber, const struct StudentRecord *original,
+                        const struct StudentRecord *student)
+{
+    char key[INDEX_KEY_SIZE];
+    char oldRosterKey[ROSTER_KEY_SIZE], newRosterKey[ROSTER_KEY_SIZE];
+    struct DiskIndex index;
+    struct RosterIndex roster;
+
+    if (!makeStudentKey(key, student->department, student->studentID) ||
+        !makeRosterKey(oldRosterKey, original->department, original->intake, original->section) ||
+        !makeRosterKey(newRosterKey, student->department, student->intake, student->section))
+        return -1;
+    if (!openStudentIndex(&index, studentFile))
+        return -1;
+    if (!openRosterIndex(&roster, studentFile))
+    {
+        closeDiskIndex(&index);
+        return -1;
+    }
+    int written = replaceStudentAt(studentFile, recordNumber, original, student);
+    if (written > 0)
+    {
+        // Re-putting the unchanged entry restamps the ID index against the rewritten store.
+        diskIndexPut(&index, key, recordNumber, (long long)sizeof(struct StudentRecord));
+        int patched = strcmp(oldRosterKey, newRosterKey) == 0
+                          ? stampRosterIndex(&roster)
+                          : rosterIndexRemove(&roster, oldRosterKey, recordNumber) &&
+                                rosterIndexAdd(&roster, newRosterKey, recordNumber);
+        settleRosterIndex(&roster, patched, studentFile);
+    }
+    else
+    {
+        closeRosterIndex(&roster);
+    }
+    closeDiskIndex(&index);
+    return written;
+}
+
+// Marks recordNumber deleted in place and drops it from both indexes. Nothing else in the store moves, so
+// a delete costs one record-sized write however large the file is.
+int tombstoneStudentRecord(FILE *studentFile, long long recordNumber, const struct StudentRecord *student)
+{
+    char key[INDEX_KEY_SIZE];
+    char rosterKey[ROSTER_KEY_SIZE];
+    struct DiskIndex index;
+    struct RosterIndex roster;
+    struct StudentFileHeader header;
+    unsigned int state = STUDENT_RECORD_DELETED;
+
+    if (!makeStudentKey(key, student->department, student->studentID) ||
+        !makeRosterKey(rosterKey, student->department, student->intake, student->section))
+        return 0;
+    if (!openStudentIndex(&index, studentFile))
+    {
+        reportError("Error: Student ID index is unavailable for delete.\n");
+        return 0;
+    }
+    if (!openRosterIndex(&roster, studentFile))
+    {
+        closeDiskIndex(&index);
+        return 0;
+    }
+    int ok = seekData(studentFile, (off_t)(studentRecordPos(recordNumber) + offsetof(struct StudentRecord, state)), SEEK_SET) == 0 &&
+             fwrite(&state, sizeof(state), 1, studentFile) == 1 && readStudentHeader(studentFile, &header);
+    if (ok)
+    {
+        header.deadCount++;
+        ok = writeStudentHeader(studentFile, &header);
+    }
+    if (!ok)
+    {
+        reportSystemError("Error marking student record deleted");
+        clearerr(studentFile);
+        closeRosterIndex(&roster);
+        closeDiskIndex(&index);
+        return 0;
+    }
+    if (!diskIndexRemove(&index, key))
+        reportError("Warning: Student ID index could not be updated; it will be rebuilt on the next lookup.\n");
+    settleRosterIndex(&roster, rosterIndexRemove(&roster, rosterKey, recordNumber), studentFile);
+    closeDiskIndex(&index);
+    return 1;
+}
+
+// Reads one CSV record at *pos. Fields split on commas; a double-quoted field may hold commas, line breaks
+// and "" for a quote. Fields are unescaped into scratch and NUL-terminated. Returns the field count, or -1
+// if the record is malformed or overflows scratch or fields. *pos moves past the record and *line counts
+// the lines it spanned.
+int readCsvRecord(const char *data, size_t length, size_t *pos, char *scratch, size_t scratchSize,
+                  char **fields, int maxFields, long *line)
+{
+    size_t p = *pos, used = 0;
+    int count = 0, ok = 1;
+    (*line)++;
+    hotPath.parseCalls++;
+    while (1)
+    {
+        char *field = scratch + used;
+        int quoted = 0;
+        while (p < length && (data[p] == ' ' || data[p] == '\t'))
+            p++;
+        if (p < length && data[p] == '"')
+        {
+            quoted = 1;
+            p++;
+        }
+        while (p < length)
+        {
+            char c = data[p];
+            if (quoted && c == '"')
+            {
+                if (p + 1 >= length || data[p + 1] != '"')
+                {
+                    quoted = 0;
+                    p++;
+                    continue;
+                }
+                p++;
+            }
+            else if (quoted && c == '\n')
+            {
+                (*line)++;
+            }
+            else if (!quoted && (c == ',' || c == '\n' || c == '\r'))
+            {
+                break;
+            }
+            if (used < scratchSize - 1)
+                scratch[used++] = c;
+            else
+                ok = 0;
+            p++;
+        }
+        if (quoted)
+            ok = 0;
+        while (scratch + used > field && (scratch[used - 1] == ' ' || scratch[used - 1] == '\t'))
+            used--;
+        scratch[used] = '\0';
+        if (used < scratchSize - 1)
+            used++;
+        else
+            ok = 0;
+        if (count < maxFields)
+            fields[count] = field;
+        else
+            ok = 0;
+        count++;
+        if (p < length && data[p] == ',')
+        {
+            p++;
+            continue;
+        }
+        if (p < length && data[p] == '\r')
+            p++;
+        if (p < length && data[p] == '\n')
+            p++;
+        break;
+    }
+    *pos = p;
+    return ok ? count : -1;
+}
+
+static void rejectImportRow(FILE *rejects, long line, const char *reason, long *rejected)
+{
+    if (rejects != stdout)
+        fflush(stdout);
+    fprintf(rejects, "rejected\t%ld\t%s\n", line, reason);
+    (*rejected)++;
+}
+
+// Appends every valid row of a students CSV to the store for departmentName. The header row names the
+// columns with the studentColumns names; id and name are required and dept, if present, must match. Rows
+// with missing or oversized fields, or an ID the department already has, go to rejects with their line number. Accepted records are written in STUDENT_IMPORT_BATCH-sized fwrites with a
+// single flush, then both indexes are rebuilt once. Returns 0 if the file as a whole could not be imported.
+int importStudentCsv(FILE *studentFile, const char *departmentName, const char *csvPath, FILE *rejects,
+                     long *imported, long *rejected)
+{
+    struct StudentMap csvMap, storeMap;
+    const struct StudentRecord *records;
+    long long count;
+    struct IndexTable seen;
+    char scratch[STUDENT_CSV_LINE_SIZE];
+    char *fields[STUDENT_FIELD_COUNT + 1];
+    int columnField[STUDENT_FIELD_COUNT + 1];
+    long line = 0;
+
+    *imported = 0;
+    *rejected = 0;
+    FILE *csv = fopen(csvPath, "rb");
+    if (csv == NULL)
+    {
+        reportSystemError("Error opening student CSV file");
+        return 0;
+    }
+    int ok = mapStudentFile(csv, &csvMap, POSIX_MADV_SEQUENTIAL);
+    fclose(csv);
+    if (!ok)
+        return 0;
+
+    // IDs the department already holds, so duplicates are caught without touching the disk index per row.
+    if (!mapStudentStore(studentFile, &storeMap, POSIX_MADV_SEQUENTIAL, &records, &count))
+    {
+        unmapStudentFile(&csvMap);
+        return 0;
+    }
+    ok = initIndexTable(&seen, "IMPORT", (unsigned int)(count / 4 + csvMap.length / 128));
+    for (long long i = 0; ok && i < count; i++)
+    {
+        if (records[i].state == STUDENT_RECORD_LIVE && strcmp(records[i].department, departmentName) == 0)
+            ok = indexTablePut(&seen, records[i].studentID, i, 0, 0) >= 0;
+    }
+    unmapStudentFile(&storeMap);
+
+    size_t pos = 0;
+    int columns = 0, hasId = 0, hasName = 0;
+    while (ok && pos < csvMap.length && columns == 0)
+    {
+        int n = readCsvRecord(csvMap.data, csvMap.length, &pos, scratch, sizeof(scratch), fields, STUDENT_FIELD_COUNT + 1, &line);
+        if (n == 1 && fields[0][0] == '\0')
+            continue;
+        for (int c = 0; ok && c < n; c++)
+        {
+            columnField[c] = -1;
+            for (int f = 0; f < STUDENT_FIELD_COUNT; f++)
+            {
+                if (strcmp(fields[c], studentColumns[f]) == 0)
+                    columnField[c] = f;
+            }
+            if (columnField[c] < 0)
+            {
+                reportError("Error: Unknown CSV column '%s' on line %ld.\n", fields[c], line);
+                ok = 0;
+            }
+            hasId |= columnField[c] == FIELD_ID;
+            hasName |= columnField[c] == FIELD_NAME;
+        }
+        if (n < 0)
+        {
+            reportError("Error: Malformed CSV header on line %ld.\n", line);
+            ok = 0;
+        }
+        else if (ok && (!hasId || !hasName))
+        {
+            reportError("Error: CSV header needs at least the id and name columns.\n");
+            ok = 0;
+        }
+        columns = n;
+    }
+
+    struct StudentRecord *batch = ok ? malloc(STUDENT_IMPORT_BATCH * sizeof(struct StudentRecord)) : NULL;
+    int batchCount = 0;
+    long long originalSize = -1;
+    ok = ok && batch != NULL && seekData(studentFile, 0, SEEK_END) == 0 && (originalSize = (long long)ftello(studentFile)) >= 0;
+    while (ok && pos < csvMap.length)
+    {
+        const char *values[STUDENT_FIELD_COUNT];
+        int n = readCsvRecord(csvMap.data, csvMap.length, &pos, scratch, sizeof(scratch), fields, STUDENT_FIELD_COUNT + 1, &line);
+        if (n == 1 && fields[0][0] == '\0')
+            continue;
+        if (n < 0)
+        {
+            rejectImportRow(rejects, line, "malformed or oversized CSV row", rejected);
+            continue;
+        }
+        if (n != columns)
+        {
+            rejectImportRow(rejects, line, "wrong number of fields", rejected);
+            continue;
+        }
+        for (int f = 0; f < STUDENT_FIELD_COUNT; f++)
+            values[f] = "";
+        for (int c = 0; c < n; c++)
+            values[columnField[c]] = fields[c];
+        if (values[FIELD_DEPARTMENT][0] != '\0' && strcmp(values[FIELD_DEPARTMENT], departmentName) != 0)
+        {
+            rejectImportRow(rejects, line, "belongs to another department", rejected);
+            continue;
+        }
+        values[FIELD_DEPARTMENT] = departmentName;
+        if (values[FIELD_ID][0] == '\0' || values[FIELD_NAME][0] == '\0')
+        {
+            rejectImportRow(rejects, line, "id and name are required", rejected);
+            continue;
+        }
+        if (fillStudentValues(&batch[batchCount], values) > 0)
+        {
+            rejectImportRow(rejects, line, "a field is too long", rejected);
+            continue;
+        }
+        int added = indexTablePut(&seen, values[FIELD_ID], 0, 0, 0);
+        if (added <= 0)
+        {
+            if (added == 0)
+                rejectImportRow(rejects, line, "duplicate student ID", rejected);
+            ok = added == 0;
+            continue;
+        }
+        if (++batchCount == STUDENT_IMPORT_BATCH)
+        {
+            ok = fwrite(batch, sizeof(struct StudentRecord), (size_t)batchCount, studentFile) == (size_t)batchCount;
+            *imported += batchCount;
+            batchCount = 0;
+        }
+    }
+    if (ok && batchCount > 0)
+    {
+        ok = fwrite(batch, sizeof(struct StudentRecord), (size_t)batchCount, studentFile) == (size_t)batchCount;
+        *imported += batchCount;
+    }
+    ok = ok && fflush(studentFile) == 0;
+    if (!ok && originalSize >= 0)
+    {
+        // Leave the store as it was rather than holding half an import.
+        reportSystemError("Error writing imported students");
+        clearerr(studentFile);
+        fflush(studentFile);
+        if (ftruncate(fileno(studentFile), (off_t)originalSize) != 0)
+            reportSystemError("Error rolling back partial import");
+        *imported = 0;
+    }
+    free(batch);
+    freeIndexTable(&seen);
+    unmapStudentFile(&csvMap);
+    if (*imported > 0)
+    {
+        rebuildStudentIndex(studentFile);
+        rebuildRosterIndex(studentFile);
+    }
+    return ok;
+}
+
+void handleAdmissionPhase(FILE **P_ptr)
+{
+    char user[100];
+    clearScreen();
+    printf("Enter your username: ");
+    // Use fgets safely
+    if (readLine(user, sizeof(user)) == NULL)
+    {
+        printf("Error reading username.\n");
+        return;
+    }
+    trimWhitespace(user);
+
+    if (strcmp(user, "A") == 0)
+    {
+        clearScreen();
+        printf("========================================================================================\n");
+        printf("      =============== Bangladesh University of Business and Technology =============\n");
+        printf("========================================================================================\n\n");
+        printf(":::::::::::::::::::::::: Information of Departments ::::::::::::::::::::::::\n");
+        printf("   1. CSE (GPA: 9.50, Fees: 5,80,000/=)\n");
+        printf("   2. BBA (GPA: 9.25, Fees: 5,70,000/=)\n");
+        printf("   3. EEE (GPA: 9.00, Fees: 5,40,000/=)\n");
+        printf("   4. ENGLISH (GPA: 8.50, Fees: 5,50,000/=)\n\n");
+
+        printf("                  Which Department do you want to manage?                 \n\n");
+        printf("1.CSE   2.EEE   3.BBA   4.ENGLISH\n\n");
+        printf("Enter choice (1-4): ");
+
+        int deptChoice;
+        if (scanInput("%d", &deptChoice) != 1)
+        {
+            printf("Invalid input. Please enter a number.\n");
+            clearInputBuffer();
+            pressEnterToContinue();
+            return;
+        }
+        clearInputBuffer(); 
+
+        if (deptChoice >= 1 && deptChoice <= 4)
+        {
+            int departmentRunning = 1;
+            char departmentName[20];
+            switch (deptChoice)
+            {
+            case 1:
+                strcpy(departmentName, "CSE");
+                break;
+            case 2:
+                strcpy(departmentName, "EEE");
+                break;
+            case 3:
+                strcpy(departmentName, "BBA");
+                break;
+            case 4:
+                strcpy(departmentName, "ENGLISH");
+                break;
+            default:
+                printf("Internal error: Invalid department choice.\n");
+                return; 
+            }
+
+            struct StudentTable studentTable;
+            memset(&studentTable, 0, sizeof(studentTable));
+            if (!ensureStudentTable(&studentTable, *P_ptr))
+            {
+                reportError("Error: Could not load student records.\n");
+                pressEnterToContinue();
+                return;
+            }
+
+            while (departmentRunning)
+            {
+                clearScreen();
+                printf("\n--- Department: %s ---\n", departmentName);
+                printf("1. Add Student\n");
+                printf("2. View All Students\n");
+                printf("3. Search Student by ID\n");
+                printf("4. Search Student by Name\n");
+                printf("5. Delete Student by ID\n");
+                printf("6. Update Student Info by ID\n");
+                printf("7. View Students by Intake & Section\n");
+                printf("8. Rebuild Student Indexes\n");
+                printf("9. Compact Student Store\n");
+                printf("10. Import Students from CSV\n");
+                printf("11. Back to Main Menu\n");
+                printf("\nEnter choice (1-11): ");
+
+                int subSelect;
+                if (scanInput("%d", &subSelect) != 1)
+                {
+                    printf("Invalid input. Please enter a number (1-11).\n");
+                    clearInputBuffer();
+                    pressEnterToContinue();
+                    continue;
+                }
+                clearInputBuffer(); 
+                if (*P_ptr == NULL)
+                {
+                    reportError("ERROR: Student file pointer is NULL in handleAdmissionPhase.\n");
+                    *P_ptr = fopen(STUDENT_DATA_FILE, "rb+");
+                    if (*P_ptr == NULL)
+                    {
+                        reportSystemError("FATAL: Could not reopen student file");
+                        exit(EXIT_FAILURE);
+                    }
+                    printf("INFO: Student file pointer was reopened.\n");
+                }
+
+                static const char *const studentOperations[] = {
+                    NULL, "addStudent", "viewAllStudents", "searchStudentById", "searchStudentByName", "deleteStudentById",
+                    "updateStudentById", "viewStudentsByIntakeSection", "rebuildStudentIndexes", "compactStudents",
+                    "importStudents"};
+                struct OperationTimer timer;
+                const char *operation = subSelect >= 1 && subSelect <= 10 ? studentOperations[subSelect] : NULL;
+                if (operation != NULL)
+                    beginOperation(&timer, operation);
+                switch (subSelect)
+                {
+                case 1:
+                    addStudent(P_ptr, &studentTable, departmentName);
+                    break;
+                case 2:
+                    viewAllStudents(P_ptr, &studentTable, departmentName);
+                    break;
+                case 3:
+                    searchStudentById(P_ptr, &studentTable, departmentName);
+                    break;
+                case 4:
+                    searchStudentByName(P_ptr, &studentTable, departmentName);
+                    break;
+                case 5:
+                    deleteStudentById(P_ptr, &studentTable, departmentName);
+                    break;
+                case 6:
+                    updateStudentById(P_ptr, &studentTable, departmentName);
+                    break;
+                case 7:
+                    viewStudentsByIntakeSection(P_ptr, departmentName);
+                    break;
+                case 8:
+                    clearScreen();
+                    rebuildStudentIndex(*P_ptr);
+                    rebuildRosterIndex(*P_ptr);
+                    pressEnterToContinue();
+                    break;
+                case 9:
+                    compactStudents(P_ptr, &studentTable);
+                    break;
+                case 10:
+                    importStudents(P_ptr, &studentTable, departmentName);
+                    break;
+                case 11:
+                    departmentRunning = 0;
+                    break;
+                default:
+                    printf("Invalid choice (%d). Please enter 1-11.\n", subSelect);
+                    pressEnterToContinue();
+                    break;
+                }
+                if (operation != NULL)
+                    endOperation(&timer);
+                // Pause is handled within sub-functions or implicitly by loop
+            }
+            freeStudentTable(&studentTable);
+        }
+        else
+        {
+            printf("Invalid department choice (%d).\n", deptChoice);
+            pressEnterToContinue();
+        }
+    }
+    else
+    {
+        printf("Wrong Username\n");
+        pressEnterToContinue();
+    }
+}
+
+void addStudent(FILE **P_ptr, struct StudentTable *table, const char *departmentName)
+{
+    if (*P_ptr == NULL)
+    {
+        reportError("ERROR: Student file is not open in addStudent.\n");
+        pressEnterToContinue();
+        return;
+    }
+
+    int addStudentLoop = 1;
+    while (addStudentLoop)
+    {
+        clearScreen();
+        printf("\n--- Add New Student to %s ---\n", departmentName);
+        char firstName[100] = "", lastName[100] = "", fatherName[100] = "", motherName[100] = "";
+        char studentID[100] = "", intake[100] = "", section[100] = "";
+        char presentAddress[200] = "", permanentAddress[200] = "";                         
+        char bloodGroup[20] = "", mobileNumber[20] = "", backupMobileNumber[20] = "", email[100] = ""; 
+        printf("Student First Name: ");
+        if (!readLine(firstName, sizeof(firstName)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(firstName);
+
+        printf("Student Last Name: ");
+        if (!readLine(lastName, sizeof(lastName)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(lastName);
+
+        printf("Father's Name: ");
+        if (!readLine(fatherName, sizeof(fatherName)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(fatherName);
+
+        printf("Mother's Name: ");
+        if (!readLine(motherName, sizeof(motherName)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(motherName);
+
+        printf("Student ID: ");
+        if (!readLine(studentID, sizeof(studentID)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(studentID);
+
+        printf("Intake: ");
+        if (!readLine(intake, sizeof(intake)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(intake);
+
+        printf("Section: ");
+        if (!readLine(section, sizeof(section)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(section);
+
+        printf("Present Address: ");
+        if (!readLine(presentAddress, sizeof(presentAddress)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(presentAddress);
+
+        printf("Permanent Address: ");
+        if (!readLine(permanentAddress, sizeof(permanentAddress)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(permanentAddress);
+
+        printf("Blood Group: ");
+        if (!readLine(bloodGroup, sizeof(bloodGroup)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(bloodGroup);
+
+        printf("Mobile Number: ");
+        if (!readLine(mobileNumber, sizeof(mobileNumber)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(mobileNumber);
+
+        printf("Backup Mobile Number: ");
+        if (!readLine(backupMobileNumber, sizeof(backupMobileNumber)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(backupMobileNumber);
+
+        printf("Email Address: ");
+        if (!readLine(email, sizeof(email)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(email);
+
+        // --- Validate Input ---
+        if (strlen(studentID) == 0 || strlen(firstName) == 0 || strlen(lastName) == 0)
+        {
+            printf("\nError: Student ID and Full Name are required.\n");
+        }
+        else
+        {
+            char key[INDEX_KEY_SIZE];
+            char fullName[201];
+            struct StudentRecord student;
+            snprintf(fullName, sizeof(fullName), "%s %s", firstName, lastName);
+            const char *values[STUDENT_FIELD_COUNT] = {fullName, fatherName, motherName, studentID, departmentName, intake, section,
+                                                       presentAddress, permanentAddress, bloodGroup, mobileNumber, backupMobileNumber, email};
+            char rosterKey[ROSTER_KEY_SIZE];
+            if (fillStudentValues(&student, values) > 0 || !makeStudentKey(key, departmentName, studentID) ||
+                !makeRosterKey(rosterKey, departmentName, intake, section))
+            {
+                printf("\nError: Student details are too long.\n");
+            }
+            else if (!ensureStudentTable(table, *P_ptr))
+            {
+                reportError("Error: Student records could not be loaded. Student not added.\n");
+            }
+            else if (studentTableFind(table, departmentName, studentID) >= 0)
+            {
+                printf("\nError: Student ID '%s' already exists in the %s department.\n", studentID, departmentName);
+            }
+            else
+            {
+                long long recordNumber = insertStudentRecord(*P_ptr, &student);
+                if (recordNumber < 0)
+                {
+                    reportError("Error: Could not write student data. Student not added.\n");
+                    clearerr(*P_ptr);
+                }
+                else
+                {
+                    struct StudentRecordView added;
+                    studentRecordView(&student, &added);
+                    if (studentTableAppend(table, &added, recordNumber) < 0)
+                        table->loaded = 0;
+                    stampStudentTable(table);
+                    printf("\n---------- Congratulations! Student added successfully. ----------\n");
+                }
+            }
+        }
+        printf("\n---------- Add another student to %s? ----------\n", departmentName);
+        printf("1. Yes\n2. No (Back to %s Menu)\n", departmentName);
+        printf("Enter Choice: ");
+        int addChoice;
+        if (scanInput("%d", &addChoice) != 1)
+        {
+            addChoice = 2;     
+            clearInputBuffer(); 
+        }
+        else
+        {
+            clearInputBuffer();
+        }
+
+        if (addChoice != 1)
+            addStudentLoop = 0;
+    }
+    pressEnterToContinue(); 
+}
+
+void viewAllStudents(FILE **P_ptr, struct StudentTable *table, const char *departmentName)
+{
+    if (*P_ptr == NULL)
+    {
+        reportError("ERROR: Student file is not open in viewAllStudents.\n");
+        pressEnterToContinue();
+        return;
+    }
+
+    clearScreen();
+    printf("\n\n------------------- Student List for Department: %s -------------------\n\n", departmentName);
+
+    if (!ensureStudentTable(table, *P_ptr))
+    {
+        pressEnterToContinue();
+        return;
+    }
+
+    long dept = findStudentCode(table, departmentName);
+    int recordsFound = 0;
+    if (table->liveCount > 0)
+    {
+        printf("%-25s %-15s %-15s %-10s %-10s\n", "Student Name", "Student ID", "Mobile Number", "Intake", "Section");
+        printf("------------------------------------------------------------------------------\n");
+    }
+    if (dept >= 0)
+        hotPath.recordsScanned += (long long)table->count;
+    for (size_t row = 0; dept >= 0 && row < table->count; row++)
+    {
+        if (table->live[row] && table->deptCode[row] == (unsigned int)dept)
+        {
+            printf("%-25s %-15s %-15s %-10s %-10s\n",
+                   TABLE_TEXT(table, nameText, row), TABLE_TEXT(table, idText, row),
+                   TABLE_TEXT(table, mobileText, row), TABLE_CODE(table, intakeCode, row),
+                   TABLE_CODE(table, sectionCode, row));
+            recordsFound = 1;
+        }
+    }
+
+    if (table->liveCount == 0)
+    {
+        printf("\nNo students added yet!\n");
+    }
+    else
+    {
+        if (!recordsFound)
+        {
+            printf("\nNo students found in the %s department.\n", departmentName);
+        }
+        printf("------------------------------------------------------------------------------\n");
+    }
+
+    clearerr(*P_ptr);
+    pressEnterToContinue();
+}
+
+void searchStudentById(FILE **P_ptr, struct StudentTable *table, const char *departmentName)
+{
+    if (*P_ptr == NULL)
+    {
+        reportError("ERROR: Student file is not open in searchStudentById.\n");
+        pressEnterToContinue();
+        return;
+    }
+
+    int searchAgain = 1;
+    while (searchAgain)
+    {
+        clearScreen();
+        printf("\n--- Search Student by ID in %s ---\n", departmentName);
+        printf("Enter Student ID to search: ");
+        char searchID[100];
+        if (!readLine(searchID, sizeof(searchID)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(searchID);
+
+        if (strlen(searchID) == 0)
+        {
+            printf("Search ID cannot be empty.\n");
+            pressEnterToContinue();
+            continue;
+        }
+
+        struct StudentRecord student;
+        struct StudentRecordView record;
+        long row = ensureStudentTable(table, *P_ptr) ? studentTableFind(table, departmentName, searchID) : -1;
+        int found = 0;
+        if (row >= 0)
+        {
+            if (readStudentRow(table, *P_ptr, row, &student))
+            {
+                found = 1;
+                studentRecordView(&student, &record);
+                clearScreen();
+                printf("\n------------------- Student Details Found -------------------\n");
+                printStudentDetails(&record);
+                printf("-------------------------------------------------------------\n");
+            }
+            else
+            {
+                reportError("Error: Student table is out of date; it will be reloaded.\n");
+                table->loaded = 0;
+            }
+        }
+
+        if (!found)
+        {
+            clearScreen();
+            printf("\nStudent with ID '%s' not found in the %s department.\n", searchID, departmentName);
+        }
+
+        clearerr(*P_ptr);
+        printf("\nOptions:\n1. Search Another Student by ID\n2. Back to %s Menu\n", departmentName);
+        printf("Enter your choice: ");
+        int choice;
+        if (scanInput("%d", &choice) != 1)
+        {
+            choice = 2;
+            clearInputBuffer();
+        }
+        else
+        {
+            clearInputBuffer();
+        }
+        if (choice != 1)
+            searchAgain = 0;
+    }
+}
+
+void searchStudentByName(FILE **P_ptr, struct StudentTable *table, const char *departmentName)
+{
+    if (*P_ptr == NULL)
+    {
+        reportError("ERROR: Student file is not open in searchStudentByName.\n");
+        pressEnterToContinue();
+        return;
+    }
+
+    int searchAgain = 1;
+    while (searchAgain)
+    {
+        clearScreen();
+        printf("\n--- Search Student by Name in %s ---\n", departmentName);
+        printf("Enter Student Name (or part of it): ");
+        char searchName[201];
+        if (!readLine(searchName, sizeof(searchName)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(searchName);
+
+        if (strlen(searchName) == 0)
+        {
+            printf("Search name cannot be empty.\n");
+            pressEnterToContinue();
+            continue;
+        }
+
+        if (!ensureStudentTable(table, *P_ptr))
+        {
+            pressEnterToContinue();
             return;
         }
-        clearInputBuffer(); 
 
-        if (deptChoice >= 1 && deptChoice <= 4)
+        int foundCount = 0;
+        struct StudentRecord student;
+        struct StudentRecordView record;
+        unsigned int *matches;
+        long matchCount = searchStudentNames(table, findStudentCode(table, departmentName), searchName, &matches);
+        if (matchCount < 0)
         {
-            int departmentRunning = 1;
-            char departmentName[20];
-            switch (deptChoice)
+            reportError("ERROR: Out of memory while searching student names.\n");
+            matchCount = 0;
+        }
+        printf("\n--- Search Results for '%s' in %s ---\n", searchName, departmentName);
+        for (long m = 0; m < matchCount; m++)
+        {
+            if (!readStudentRow(table, *P_ptr, (long)matches[m], &student))
             {
-            case 1:
-                strcpy(departmentName, "CSE");
-                break;
-            case 2:
-                strcpy(departmentName, "EEE");
-                break;
-            case 3:
-                strcpy(departmentName, "BBA");
-                break;
-            case 4:
-                strcpy(departmentName, "ENGLISH");
+                reportError("Error: Student table is out of date; it will be reloaded.\n");
+                table->loaded = 0;
                 break;
-            default:
-                printf("Internal error: Invalid department choice.\n");
-                return; 
             }
+            studentRecordView(&student, &record);
+            if (foundCount == 0)
+            {
+                printf("\n------------------- Matching Student(s) Found -------------------\n");
+            }
+            foundCount++;
+            printf("--- Match %d ---\n", foundCount);
+            printStudentDetails(&record);
+            printf("-------------------------------------------------------------\n");
+        }
+        free(matches);
 
-            while (departmentRunning)
+        if (foundCount == 0)
+        {
+            printf("\nNo students found matching the name '%s' in the %s department.\n", searchName, departmentName);
+        }
+        clearerr(*P_ptr);
+        printf("\nOptions:\n1. Search Again by Name\n2. Back to %s Menu\n", departmentName);
+        printf("Enter your choice: ");
+        int choice;
+        if (scanInput("%d", &choice) != 1)
+        {
+            choice = 2;
+            clearInputBuffer();
+        }
+        else
+        {
+            clearInputBuffer();
+        }
+        if (choice != 1)
+            searchAgain = 0;
+    }
+}
+
+void viewStudentsByIntakeSection(FILE **P_ptr, const char *departmentName)
+{
+    if (*P_ptr == NULL)
+    {
+        reportError("ERROR: Student file is not open in viewStudentsByIntakeSection.\n");
+        pressEnterToContinue();
+        return;
+    }
+
+    int viewAgain = 1;
+    while (viewAgain)
+    {
+        clearScreen();
+        printf("\n--- View Students by Intake & Section in %s ---\n", departmentName);
+        char searchIntake[100], searchSection[100];
+
+        printf("Enter Intake to filter by: ");
+        if (!readLine(searchIntake, sizeof(searchIntake)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(searchIntake);
+
+        printf("Enter Section to filter by: ");
+        if (!readLine(searchSection, sizeof(searchSection)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(searchSection);
+
+        if (strlen(searchIntake) == 0 || strlen(searchSection) == 0)
+        {
+            printf("Intake and Section cannot be empty.\n");
+            pressEnterToContinue();
+            continue;
+        }
+
+        // The roster index hands back just this section's record numbers, so the cost follows the section size.
+        char rosterKey[ROSTER_KEY_SIZE];
+        struct RosterIndex roster;
+        long long *recordNumbers = NULL;
+        long long rosterCount = -1;
+        if (makeRosterKey(rosterKey, departmentName, searchIntake, searchSection) && openRosterIndex(&roster, *P_ptr))
+        {
+            rosterCount = rosterIndexCollect(&roster, rosterKey, 0, &recordNumbers);
+            closeRosterIndex(&roster);
+        }
+        struct StudentMap map;
+        const struct StudentRecord *records;
+        long long count;
+        if (rosterCount < 0 || !mapStudentStore(*P_ptr, &map, POSIX_MADV_RANDOM, &records, &count))
+        {
+            reportError("Error: Could not read the section roster.\n");
+            free(recordNumbers);
+            pressEnterToContinue();
+            return;
+        }
+        hotPath.recordsScanned += rosterCount;
+
+        printf("\n--- Student List for %s - Intake: %s, Section: %s ---\n\n", departmentName, searchIntake, searchSection);
+        printf("%-25s %-15s %-15s\n", "Student Name", "Student ID", "Mobile Number");
+        printf("----------------------------------------------------------\n");
+
+        int found = 0;
+        for (long long i = 0; i < rosterCount; i++)
+        {
+            const struct StudentRecord *student = recordNumbers[i] < count ? &records[recordNumbers[i]] : NULL;
+            if (student != NULL && student->state == STUDENT_RECORD_LIVE)
             {
-                system("clear || cls");
-                printf("\n--- Department: %s ---\n", departmentName);
-                printf("1. Add Student\n");
-                printf("2. View All Students\n");
-                printf("3. Search Student by ID\n");
-                printf("4. Search Student by Name\n");
-                printf("5. Delete Student by ID\n");
-                printf("6. Update Student Info by ID\n");
-                printf("7. View Students by Intake & Section\n");
-                printf("8. Back to Main Menu\n");
-                printf("\nEnter choice (1-8): ");
+                found = 1;
+                printf("%-25s %-15s %-15s\n", student->name, student->studentID, student->mobileNumber);
+            }
+        }
+        unmapStudentFile(&map);
+        free(recordNumbers);
 
-                int subSelect;
-                if (scanf("%d", &subSelect) != 1)
-                {
-                    printf("Invalid input. Please enter a number (1-8).\n");
-                    clearInputBuffer();
-                    pressEnterToContinue();
-                    continue;
-                }
-                clearInputBuffer(); 
-                if (*P_ptr == NULL)
-                {
-                    fprintf(stderr, "ERROR: Student file pointer is NULL in handleAdmissionPhase.\n")
-                    *P_ptr = fopen("test.txt", "a+");
-                    if (*P_ptr == NULL)
-                    {
-                        perror("FATAL: Could not reopen student file");
-                        exit(EXIT_FAILURE);
-                    }
-                    printf("INFO: Student file pointer was reopened.\n");
-                }
+        printf("----------------------------------------------------------\n");
+        if (!found)
+        {
+            printf("\nNo students found matching criteria (Dept: %s, Intake: %s, Section: %s).\n", departmentName, searchIntake, searchSection);
+        }
+
+        clearerr(*P_ptr);
+        printf("\nOptions:\n1. View Another Intake/Section\n2. Back to %s Menu\n", departmentName);
+        printf("Enter your choice: ");
+        int choice;
+        if (scanInput("%d", &choice) != 1)
+        {
+            choice = 2;
+            clearInputBuffer();
+        }
+        else
+        {
+            clearInputBuffer();
+        }
+        if (choice != 1)
+            viewAgain = 0;
+    }
+}
+
+void deleteStudentById(FILE **P_ptr, struct StudentTable *table, const char *departmentName)
+{
+    int deleteMore = 1;
+    while (deleteMore)
+    {
+        clearScreen();
+        printf("\n--- Delete Student by ID from %s ---\n", departmentName);
+        printf("Enter Student ID to delete: ");
+        char deleteID[100];
+        if (!readLine(deleteID, sizeof(deleteID)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(deleteID);
+
+        if (strlen(deleteID) == 0)
+        {
+            printf("Delete ID cannot be empty.\n");
+            pressEnterToContinue();
+            continue;
+        }
+        if (*P_ptr == NULL)
+        {
+            reportError("ERROR: Student file is not open in deleteStudentById.\n");
+            pressEnterToContinue();
+            return;
+        }
+
+        struct StudentRecord student;
+        long row = -1;
+        if (!ensureStudentTable(table, *P_ptr))
+        {
+            reportError("Error: Could not read student records. No changes made.\n");
+        }
+        else if ((row = studentTableFind(table, departmentName, deleteID)) < 0)
+        {
+            printf("\nStudent with ID '%s' not found in %s department. No changes made.\n", deleteID, departmentName);
+        }
+        else if (!readStudentRow(table, *P_ptr, row, &student))
+        {
+            reportError("Error: Could not read student record for ID '%s'. No changes made.\n", deleteID);
+            table->loaded = 0;
+        }
+        else if (tombstoneStudentRecord(*P_ptr, table->recordNumber[row], &student))
+        {
+            studentTableRemove(table, row);
+            stampStudentTable(table);
+            printf("\nStudent deleted successfully.\n");
+        }
+
+        printf("\nOptions:\n1. Delete Another Student\n2. Back to %s Menu\n", departmentName);
+        printf("Enter your choice: ");
+        int choice;
+        if (scanInput("%d", &choice) != 1)
+        {
+            choice = 2;
+            clearInputBuffer();
+        }
+        else
+        {
+            clearInputBuffer();
+        }
+        if (choice != 1)
+            deleteMore = 0;
+    }
+}
+
+void updateStudentById(FILE **P_ptr, struct StudentTable *table, const char *departmentName)
+{
+    int updateMore = 1;
+    while (updateMore)
+    {
+        clearScreen();
+        printf("\n--- Update Student Information in %s ---\n", departmentName);
+        printf("Enter Student ID to update: ");
+        char updateID[100];
+        if (!readLine(updateID, sizeof(updateID)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(updateID);
 
-                switch (subSelect)
-                {
-                case 1:
-                    addStudent(P_ptr, departmentName);
+        if (strlen(updateID) == 0)
+        {
+            printf("Update ID cannot be empty.\n");
+            pressEnterToContinue();
+            continue;
+        }
+        if (*P_ptr == NULL)
+        {
+            reportError("ERROR: Student file is not open in updateStudentById.\n");
+            pressEnterToContinue();
+            return;
+        }
+
+        // The one record is read up front; nothing touches the store again until every prompt is answered.
+        struct StudentRecord original;
+        struct StudentRecordView record;
+        long row = ensureStudentTable(table, *P_ptr) ? studentTableFind(table, departmentName, updateID) : -1;
+        int found = 0;
+        if (row >= 0)
+        {
+            found = readStudentRow(table, *P_ptr, row, &original) ? 1 : -1;
+            if (found < 0)
+                table->loaded = 0;
+        }
+        if (found <= 0)
+        {
+            if (found == 0)
+                printf("\nStudent with ID '%s' not found in %s department. No changes made.\n", updateID, departmentName);
+            else
+                reportError("Error: Could not read student record for ID '%s'. No changes made.\n", updateID);
+        }
+        else
+        {
+            studentRecordView(&original, &record);
+            char name1[100], name2[100], father[100], mother[100];
+            char currentID[100], currentDept[100], intake[100], section[100];
+            char presentAddr[200], permanentAddr[200], blood[20];
+            char mobile[20], backupMobile[20], email[100];
+            splitStudentName(record.field[FIELD_NAME], name1, sizeof(name1), name2, sizeof(name2));
+            copyField(record.field[FIELD_FATHER], father, sizeof(father));
+            copyField(record.field[FIELD_MOTHER], mother, sizeof(mother));
+            copyField(record.field[FIELD_ID], currentID, sizeof(currentID));
+            copyField(record.field[FIELD_DEPARTMENT], currentDept, sizeof(currentDept));
+            copyField(record.field[FIELD_INTAKE], intake, sizeof(intake));
+            copyField(record.field[FIELD_SECTION], section, sizeof(section));
+            copyField(record.field[FIELD_PRESENT_ADDRESS], presentAddr, sizeof(presentAddr));
+            copyField(record.field[FIELD_PERMANENT_ADDRESS], permanentAddr, sizeof(permanentAddr));
+            copyField(record.field[FIELD_BLOOD_GROUP], blood, sizeof(blood));
+            copyField(record.field[FIELD_MOBILE], mobile, sizeof(mobile));
+            copyField(record.field[FIELD_BACKUP_MOBILE], backupMobile, sizeof(backupMobile));
+            copyField(record.field[FIELD_EMAIL], email, sizeof(email));
+            long long recordNumber = table->recordNumber[row];
+
+            clearScreen();
+            printf("\n--- Updating Student ID: %s (Dept: %s) ---\n", currentID, currentDept);
+            printf("--- Enter new info or press Enter to keep current ---\n\n");
+            char newName1[100], newName2[100], newFather[100], newMother[100];
+            char newIntake[100], newSection[100], newPresentAddr[200], newPermanentAddr[200];
+            char newBlood[20], newMobile[20], newBackupMobile[20], newEmail[100];
+            int inputFailed = 1;
+            do
+            {
+                printf("First Name (%s): ", name1);
+                if (!readLine(newName1, sizeof(newName1)))
                     break;
-                case 2:
-                    viewAllStudents(P_ptr, departmentName);
+                trimWhitespace(newName1);
+                printf("Last Name (%s): ", name2);
+                if (!readLine(newName2, sizeof(newName2)))
                     break;
-                case 3:
-                    searchStudentById(P_ptr, departmentName);
+                trimWhitespace(newName2);
+                printf("Father's Name (%s): ", father);
+                if (!readLine(newFather, sizeof(newFather)))
                     break;
-                case 4:
-                    searchStudentByName(P_ptr, departmentName);
+                trimWhitespace(newFather);
+                printf("Mother's Name (%s): ", mother);
+                if (!readLine(newMother, sizeof(newMother)))
                     break;
-                case 5:
-                    deleteStudentById(P_ptr, departmentName);
+                trimWhitespace(newMother);
+                printf("Intake (%s): ", intake);
+                if (!readLine(newIntake, sizeof(newIntake)))
                     break;
-                case 6:
-                    updateStudentById(P_ptr, departmentName);
+                trimWhitespace(newIntake);
+                printf("Section (%s): ", section);
+                if (!readLine(newSection, sizeof(newSection)))
                     break;
-                case 7:
-                    viewStudentsByIntakeSection(P_ptr, departmentName);
+                trimWhitespace(newSection);
+                printf("Present Address (%s): ", presentAddr);
+                if (!readLine(newPresentAddr, sizeof(newPresentAddr)))
                     break;
-                case 8:
-                    departmentRunning = 0;
+                trimWhitespace(newPresentAddr);
+                printf("Permanent Address (%s): ", permanentAddr);
+                if (!readLine(newPermanentAddr, sizeof(newPermanentAddr)))
                     break;
-                default:
-                    printf("Invalid choice (%d). Please enter 1-8.\n", subSelect);
-                    pressEnterToContinue();
+                trimWhitespace(newPermanentAddr);
+                printf("Blood Group (%s): ", blood);
+                if (!readLine(newBlood, sizeof(newBlood)))
+                    break;
+                trimWhitespace(newBlood);
+                printf("Mobile (%s): ", mobile);
+                if (!readLine(newMobile, sizeof(newMobile)))
                     break;
+                trimWhitespace(newMobile);
+                printf("Backup Mobile (%s): ", backupMobile);
+                if (!readLine(newBackupMobile, sizeof(newBackupMobile)))
+                    break;
+                trimWhitespace(newBackupMobile);
+                printf("Email (%s): ", email);
+                if (!readLine(newEmail, sizeof(newEmail)))
+                    break;
+                trimWhitespace(newEmail);
+                inputFailed = 0;
+            } while (0);
+
+            if (inputFailed)
+            {
+                printf("\nInput error! Student not updated.\n");
+            }
+            else
+            {
+                char fullName[201];
+                struct StudentRecord student;
+                snprintf(fullName, sizeof(fullName), "%s %s", (strlen(newName1) > 0) ? newName1 : name1, (strlen(newName2) > 0) ? newName2 : name2);
+                const char *values[STUDENT_FIELD_COUNT] = {
+                    fullName,
+                    (strlen(newFather) > 0) ? newFather : father,
+                    (strlen(newMother) > 0) ? newMother : mother,
+                    currentID,
+                    currentDept,
+                    (strlen(newIntake) > 0) ? newIntake : intake,
+                    (strlen(newSection) > 0) ? newSection : section,
+                    (strlen(newPresentAddr) > 0) ? newPresentAddr : presentAddr,
+                    (strlen(newPermanentAddr) > 0) ? newPermanentAddr : permanentAddr,
+                    (strlen(newBlood) > 0) ? newBlood : blood,
+                    (strlen(newMobile) > 0) ? newMobile : mobile,
+                    (strlen(newBackupMobile) > 0) ? newBackupMobile : backupMobile,
+                    (strlen(newEmail) > 0) ? newEmail : email};
+                char rosterKey[ROSTER_KEY_SIZE];
+                if (fillStudentValues(&student, values) > 0 ||
+                    !makeRosterKey(rosterKey, student.department, student.intake, student.section))
+                {
+                    printf("\nError: Student details are too long. Student not updated.\n");
+                }
+                else if (memcmp(&student, &original, sizeof(student)) == 0)
+                {
+                    printf("\nNo changes entered. Student not updated.\n");
+                }
+                else
+                {
+                    int written = updateStudentRecord(*P_ptr, recordNumber, &original, &student);
+                    if (written < 0)
+                    {
+                        reportError("Error: Could not write updated student record. Student not updated.\n");
+                        clearerr(*P_ptr);
+                    }
+                    else if (written == 0)
+                    {
+                        printf("\nStudent '%s' was changed by someone else while you were editing. Student not updated.\n", currentID);
+                        table->loaded = 0;
+                    }
+                    else
+                    {
+                        struct StudentRecordView updated;
+                        studentRecordView(&student, &updated);
+                        if (!studentTableReplace(table, row, &updated))
+                            table->loaded = 0;
+                        stampStudentTable(table);
+                        printf("\nStudent updated successfully!\n");
+                    }
                 }
-                // Pause is handled within sub-functions or implicitly by loop
             }
         }
+
+        printf("\nOptions:\n1. Update Another Student\n2. Back to %s Menu\n", departmentName);
+        printf("Enter your choice: ");
+        int choice;
+        if (scanInput("%d", &choice) != 1)
+        {
+            choice = 2;
+            clearInputBuffer();
+        }
         else
         {
-            printf("Invalid department choice (%d).\n", deptChoice);
-            pressEnterToContinue();
+            clearInputBuffer();
+        }
+        if (choice != 1)
+            updateMore = 0;
+    }
+}
+void compactStudents(FILE **P_ptr, struct StudentTable *table)
+{
+    clearScreen();
+    printf("\n--- Compact Student Store ---\n");
+    printf("Compact when dead space reaches (0-1, Enter for %.2f): ", STUDENT_COMPACT_THRESHOLD);
+    char input[50];
+    if (!readLine(input, sizeof(input)))
+    {
+        printf("Input error!\n");
+        return;
+    }
+    trimWhitespace(input);
+    double threshold = STUDENT_COMPACT_THRESHOLD;
+    if (strlen(input) > 0)
+    {
+        char *end;
+        threshold = strtod(input, &end);
+        if (*end != '\0' || threshold < 0.0 || threshold > 1.0)
+        {
+            printf("Invalid threshold '%s'. Enter a fraction between 0 and 1.\n", input);
+            pressEnterToContinue();
+            return;
+        }
+    }
+    if (compactStudentStore(P_ptr, threshold) > 0)
+    {
+        // Compaction renumbers every record, so the session table starts over.
+        freeStudentTable(table);
+        if (!loadStudentTable(table, *P_ptr))
+            reportError("Error: Could not reload student records after compaction.\n");
+    }
+    pressEnterToContinue();
+}
+void importStudents(FILE **P_ptr, struct StudentTable *table, const char *departmentName)
+{
+    clearScreen();
+    printf("\n--- Import %s Students from CSV ---\n", departmentName);
+    printf("CSV file path: ");
+    char path[512];
+    if (!readLine(path, sizeof(path)))
+    {
+        printf("Input error!\n");
+        return;
+    }
+    trimWhitespace(path);
+    if (strlen(path) == 0)
+    {
+        printf("No file given.\n");
+        pressEnterToContinue();
+        return;
+    }
+    long imported, rejected;
+    if (importStudentCsv(*P_ptr, departmentName, path, stdout, &imported, &rejected))
+        printf("Imported %ld students, rejected %ld rows.\n", imported, rejected);
+    else
+        printf("Import failed; no students were added.\n");
+    if (imported > 0)
+    {
+        freeStudentTable(table);
+        if (!loadStudentTable(table, *P_ptr))
+            reportError("Error: Could not reload student records after import.\n");
+    }
+    pressEnterToContinue();
+}
+static const char *const scheduleTypes[] = {
+    "Class Routine", "Mid Exam Routine", "Final Exam Routine", "Result Publication Date", "Other Event", NULL};
+
+int isRoutineType(const char *scheduleType)
+{
+    return (strcmp(scheduleType, "Class Routine") == 0 ||
+            strcmp(scheduleType, "Mid Exam Routine") == 0 ||
+            strcmp(scheduleType, "Final Exam Routine") == 0);
+}
+
+// First problem that keeps schedule from being saved, or NULL if it is complete.
+const char *checkSchedule(const struct AcademicSchedule *schedule)
+{
+    if (strlen(schedule->intake) == 0)
+        return "Intake is required.";
+    if (strlen(schedule->section) == 0)
+        return "Section is required.";
+    if (strlen(schedule->scheduleType) == 0)
+        return "Schedule Type is required.";
+    if (isRoutineType(schedule->scheduleType))
+    {
+        if (strlen(schedule->routineData.day) == 0 || strlen(schedule->routineData.time) == 0 || strlen(schedule->routineData.room) == 0)
+            return "For routine types, Day, Time, and Room are required.";
+    }
+    else if (strlen(schedule->otherDetails) == 0)
+    {
+        return "Details are required for this schedule type.";
+    }
+    return NULL;
+}
+
+int matchSchedule(const void *record, const void *key)
+{
+    const struct AcademicSchedule *a = record, *b = key;
+    return strcmp(a->intake, b->intake) == 0 && strcmp(a->section, b->section) == 0 &&
+           strcmp(a->scheduleType, b->scheduleType) == 0;
+}
+
+int matchResult(const void *record, const void *key)
+{
+    const struct StudentResult *a = record, *b = key;
+    return strcmp(a->studentID, b->studentID) == 0 && strcmp(a->intake, b->intake) == 0 &&
+           strcmp(a->section, b->section) == 0;
+}
+
+static const struct FixedStore resultStore = {"results.dat", "results.free", sizeof(struct StudentResult)};
+
+// Scans a file of fixed-size records for the first live one matches() accepts against key. Returns 1 with the
+// record and its offset, 0 if there is none, -1 on a read error.
+int findFixedRecord(FILE *file, size_t recordSize, int (*matches)(const void *, const void *), const void *key,
+                    void *record, long *recordPos)
+{
+    long pos;
+    rewindData(file);
+    clearerr(file);
+    while ((pos = ftell(file)) != -1 && readData(record, recordSize, 1, file) == 1)
+    {
+        hotPath.recordsScanned++;
+        if (!FIXED_RECORD_DEAD(record) && matches(record, key))
+        {
+            if (recordPos != NULL)
+                *recordPos = pos;
+            return 1;
+        }
+    }
+    if (ferror(file))
+    {
+        reportSystemError("Error reading data file");
+        clearerr(file);
+        return -1;
+    }
+    return 0;
+}
+
+// Writes record at recordPos, or appends it when recordPos is negative.
+int writeFixedRecord(FILE *file, long recordPos, const void *record, size_t recordSize)
+{
+    int sought = recordPos < 0 ? seekData(file, 0, SEEK_END) : seekData(file, recordPos, SEEK_SET);
+    if (sought != 0 || fwrite(record, recordSize, 1, file) != 1 || fflush(file) != 0)
+    {
+        reportSystemError("Error writing data file");
+        clearerr(file);
+        return 0;
+    }
+    return 1;
+}
+
+// A <data>.free file is an IndexHeader (usedCount slots, stamped with the data file) followed by the record
+// numbers of the dead slots, used as a stack. A missing or stale list is rebuilt by scanning for dead slots.
+static int rebuildFreeSlots(FILE *file, const struct FixedStore *store)
+{
+    struct StudentMap map;
+    struct IndexHeader header;
+    char tempPath[300];
+    long long *slots = NULL;
+    long long count, used = 0;
+
+    if (fflush(file) != 0 || !mapStudentFile(file, &map, POSIX_MADV_SEQUENTIAL))
+        return 0;
+    count = (long long)(map.length / store->recordSize);
+    hotPath.recordsScanned += count;
+    slots = malloc((size_t)(count > 0 ? count : 1) * sizeof(long long));
+    for (long long i = 0; slots != NULL && i < count; i++)
+    {
+        if (FIXED_RECORD_DEAD(map.data + i * (long long)store->recordSize))
+            slots[used++] = i;
+    }
+    unmapStudentFile(&map);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FREE_SLOTS_MAGIC, sizeof(FREE_SLOTS_MAGIC) - 1);
+    header.version = INDEX_VERSION;
+    header.usedCount = (unsigned int)used;
+    header.slotCount = (unsigned int)used;
+    getFileStamp(store->path, &header.dataSize, &header.dataModified);
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", store->freePath);
+    FILE *out = slots != NULL ? fopen(tempPath, "wb") : NULL;
+    int ok = out != NULL && fwrite(&header, sizeof(header), 1, out) == 1 &&
+             fwrite(slots, sizeof(long long), (size_t)used, out) == (size_t)used;
+    if (out != NULL && fclose(out) != 0)
+        ok = 0;
+    if (!ok || rename(tempPath, store->freePath) != 0)
+    {
+        reportSystemError("Error writing free slot list");
+        remove(tempPath);
+        ok = 0;
+    }
+    free(slots);
+    return ok;
+}
+
+static int loadFreeSlots(struct FreeSlots *slots, const struct FixedStore *store)
+{
+    long long dataSize = 0, dataModified = 0;
+    memset(slots, 0, sizeof(*slots));
+    slots->file = fopen(store->freePath, "rb+");
+    if (slots->file == NULL)
+        return 0;
+    int ok = readData(&slots->header, sizeof(slots->header), 1, slots->file) == 1 &&
+             strncmp(slots->header.magic, FREE_SLOTS_MAGIC, sizeof(slots->header.magic)) == 0 &&
+             slots->header.version == INDEX_VERSION && getFileStamp(store->path, &dataSize, &dataModified) &&
+             dataSize == slots->header.dataSize && dataModified == slots->header.dataModified;
+    if (!ok)
+        closeFreeSlots(slots);
+    return ok;
+}
+
+int openFreeSlots(struct FreeSlots *slots, FILE *file, const struct FixedStore *store)
+{
+    fflush(file);
+    if (loadFreeSlots(slots, store))
+        return 1;
+    return rebuildFreeSlots(file, store) && loadFreeSlots(slots, store);
+}
+
+void closeFreeSlots(struct FreeSlots *slots)
+{
+    if (slots->file != NULL)
+        fclose(slots->file);
+    memset(slots, 0, sizeof(*slots));
+}
+
+// Writes the header with usedCount and the data file's current stamp. A list left unstamped after the data
+// file changed is simply rebuilt the next time it is opened.
+static int stampFreeSlots(struct FreeSlots *slots, const struct FixedStore *store)
+{
+    if (!getFileStamp(store->path, &slots->header.dataSize, &slots->header.dataModified))
+        return 0;
+    slots->header.slotCount = slots->header.usedCount;
+    return seekData(slots->file, 0, SEEK_SET) == 0 &&
+           fwrite(&slots->header, sizeof(slots->header), 1, slots->file) == 1 && fflush(slots->file) == 0;
+}
+
+// Writes record into the most recently freed slot, or appends it when there is none. Returns the record's
+// offset, or -1 on error.
+long insertFixedRecord(FILE *file, const struct FixedStore *store, const void *record)
+{
+    struct FreeSlots slots;
+    long long slot = -1;
+    long pos = -1;
+    int tracked = openFreeSlots(&slots, file, store);
+    if (tracked && slots.header.usedCount > 0 &&
+        seekData(slots.file, (long long)sizeof(struct IndexHeader) + (slots.header.usedCount - 1) * (long long)sizeof(long long), SEEK_SET) == 0 &&
+        readData(&slot, sizeof(slot), 1, slots.file) == 1)
+        pos = (long)(slot * (long long)store->recordSize);
+    else if (seekData(file, 0, SEEK_END) == 0)
+        pos = ftell(file);
+    if (pos < 0 || !writeFixedRecord(file, pos, record, store->recordSize))
+    {
+        closeFreeSlots(&slots);
+        return -1;
+    }
+    if (tracked)
+    {
+        if (slot >= 0)
+            slots.header.usedCount--;
+        stampFreeSlots(&slots, store);
+        closeFreeSlots(&slots);
+    }
+    return pos;
+}
+
+// Turns the records at positions[0..count) into dead slots, one record-sized write each, and files them for
+// reuse. Returns 1 on success, 0 on error.
+int deleteFixedRecords(FILE *file, const struct FixedStore *store, const long *positions, long count)
+{
+    static const char deadRecord[1024];
+    struct FreeSlots slots;
+    memset(&slots, 0, sizeof(slots));
+    int ok = store->recordSize <= sizeof(deadRecord);
+    int tracked = ok && openFreeSlots(&slots, file, store);
+    for (long i = 0; ok && i < count; i++)
+    {
+        long long slot = positions[i] / (long)store->recordSize;
+        ok = writeFixedRecord(file, positions[i], deadRecord, store->recordSize);
+        if (ok && tracked)
+        {
+            long long pos = (long long)sizeof(struct IndexHeader) + slots.header.usedCount * (long long)sizeof(long long);
+            tracked = seekData(slots.file, pos, SEEK_SET) == 0 && fwrite(&slot, sizeof(slot), 1, slots.file) == 1;
+            slots.header.usedCount += tracked;
+        }
+    }
+    if (tracked)
+        stampFreeSlots(&slots, store);
+    closeFreeSlots(&slots);
+    return ok;
+}
+
+#define SCHEDULE_COLUMN(member) {offsetof(struct AcademicSchedule, member), sizeof(((struct AcademicSchedule *)0)->member)}
+static const struct
+{
+    size_t offset;
+    size_t size;
+} scheduleRecordLayout[SCHEDULE_FIELD_COUNT] = {
+    SCHEDULE_COLUMN(intake), SCHEDULE_COLUMN(section), SCHEDULE_COLUMN(scheduleType),
+    SCHEDULE_COLUMN(routineData.day), SCHEDULE_COLUMN(routineData.date), SCHEDULE_COLUMN(routineData.time),
+    SCHEDULE_COLUMN(routineData.room), SCHEDULE_COLUMN(routineData.faculty), SCHEDULE_COLUMN(otherDetails)};
+
+// Packs schedule into heap as length-prefixed strings, one length byte below 128 and two from there. A listed
+// type goes into *type and leaves its string empty. Returns the heap length.
+static size_t encodeSchedule(const struct AcademicSchedule *schedule, unsigned char *type, unsigned char *heap)
+{
+    size_t used = 0;
+    *type = SCHEDULE_TYPE_NAMED;
+    for (int t = 0; scheduleTypes[t] != NULL && *type == SCHEDULE_TYPE_NAMED; t++)
+    {
+        if (strncmp(schedule->scheduleType, scheduleTypes[t], sizeof(schedule->scheduleType)) == 0)
+            *type = (unsigned char)(t + 1);
+    }
+    for (int i = 0; i < SCHEDULE_FIELD_COUNT; i++)
+    {
+        const char *value = (const char *)schedule + scheduleRecordLayout[i].offset;
+        size_t len = i == SCHEDULE_FIELD_TYPE && *type != SCHEDULE_TYPE_NAMED ? 0 : strnlen(value, scheduleRecordLayout[i].size - 1);
+        if (len >= 0x80)
+            heap[used++] = (unsigned char)(0x80 | (len >> 8));
+        heap[used++] = (unsigned char)(len & 0xff);
+        memcpy(heap + used, value, len);
+        used += len;
+    }
+    return used;
+}
+
+static int decodeSchedule(const struct ScheduleRecordHeader *header, const unsigned char *heap,
+                          struct AcademicSchedule *schedule)
+{
+    static const int typeCount = sizeof(scheduleTypes) / sizeof(scheduleTypes[0]) - 1;
+    size_t used = 0;
+    memset(schedule, 0, sizeof(*schedule));
+    if (header->type > typeCount)
+        return 0;
+    for (int i = 0; i < SCHEDULE_FIELD_COUNT; i++)
+    {
+        if (used >= header->length)
+            return 0;
+        size_t len = heap[used++];
+        if (len & 0x80)
+        {
+            if (used >= header->length)
+                return 0;
+            len = ((len & 0x7f) << 8) | heap[used++];
+        }
+        if (len >= scheduleRecordLayout[i].size || used + len > header->length)
+            return 0;
+        memcpy((char *)schedule + scheduleRecordLayout[i].offset, heap + used, len);
+        used += len;
+    }
+    if (header->type != SCHEDULE_TYPE_NAMED)
+        strcpy(schedule->scheduleType, scheduleTypes[header->type - 1]);
+    return used == header->length;
+}
+
+// Fills header and heap for schedule, reserving its length rounded up so small edits can stay in place.
+static void packSchedule(const struct AcademicSchedule *schedule, struct ScheduleRecordHeader *header, unsigned char *heap)
+{
+    memset(header, 0, sizeof(*header));
+    header->state = SCHEDULE_RECORD_LIVE;
+    header->length = (unsigned short)encodeSchedule(schedule, &header->type, heap);
+    header->capacity = (unsigned short)((header->length + SCHEDULE_HEAP_ALIGN - 1) / SCHEDULE_HEAP_ALIGN * SCHEDULE_HEAP_ALIGN);
+}
+
+// Writes a packed record at the current position, padded out to its capacity.
+static int putScheduleRecord(FILE *file, const struct ScheduleRecordHeader *header, const unsigned char *heap)
+{
+    return fwrite(header, sizeof(*header), 1, file) == 1 && fwrite(heap, 1, header->length, file) == header->length &&
+           writeZeroBytes(file, header->capacity - header->length);
+}
+
+int appendScheduleRecord(FILE *file, const struct AcademicSchedule *schedule)
+{
+    struct ScheduleRecordHeader header;
+    unsigned char heap[SCHEDULE_HEAP_MAX];
+    packSchedule(schedule, &header, heap);
+    return putScheduleRecord(file, &header, heap);
+}
+
+static int writeScheduleAt(FILE *file, long recordPos, const struct ScheduleRecordHeader *header, const unsigned char *heap)
+{
+    if (seekData(file, recordPos, SEEK_SET) != 0 || !putScheduleRecord(file, header, heap) || fflush(file) != 0)
+    {
+        reportSystemError("Error writing schedule file");
+        clearerr(file);
+        return 0;
+    }
+    return 1;
+}
+
+// Reads the record at recordPos; schedule may be NULL when only the header is wanted. Returns 1 for a live
+// record, 0 for a hole or a record that does not decode, -1 on a read error.
+int readScheduleAt(FILE *file, long recordPos, struct ScheduleRecordHeader *header, struct AcademicSchedule *schedule)
+{
+    unsigned char heap[SCHEDULE_HEAP_MAX];
+    hotPath.recordsScanned++;
+    if (seekData(file, recordPos, SEEK_SET) != 0 || readData(header, sizeof(*header), 1, file) != 1)
+    {
+        clearerr(file);
+        return -1;
+    }
+    if (header->state != SCHEDULE_RECORD_LIVE || header->length > header->capacity || header->length > sizeof(heap))
+        return 0;
+    if (schedule == NULL)
+        return 1;
+    if (readData(heap, 1, header->length, file) != header->length)
+    {
+        clearerr(file);
+        return -1;
+    }
+    return decodeSchedule(header, heap, schedule);
+}
+
+static void initScheduleHeader(struct ScheduleFileHeader *header)
+{
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, SCHEDULE_STORE_MAGIC, sizeof(SCHEDULE_STORE_MAGIC) - 1);
+    header->version = SCHEDULE_STORE_VERSION;
+    header->recordHeaderSize = sizeof(struct ScheduleRecordHeader);
+}
+
+static int checkScheduleHeader(const struct ScheduleFileHeader *header)
+{
+    return strncmp(header->magic, SCHEDULE_STORE_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == SCHEDULE_STORE_VERSION && header->recordHeaderSize == sizeof(struct ScheduleRecordHeader);
+}
+
+// Streams a version 1 file, a bare array of AcademicSchedule, into the compact layout one record at a time.
+// The old file is kept as <path>.v1; the new one replaces path only once every record has been written.
+int migrateScheduleStore(const char *path)
+{
+    char tempPath[256], legacyPath[256];
+    struct ScheduleFileHeader header;
+    struct AcademicSchedule schedule;
+    long migrated = 0;
+
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    snprintf(legacyPath, sizeof(legacyPath), "%s.v1", path);
+    FILE *in = fopen(path, "rb");
+    if (in == NULL)
+    {
+        reportSystemError("Error opening schedule file for migration");
+        return 0;
+    }
+    FILE *out = fopen(tempPath, "wb");
+    if (out == NULL)
+    {
+        reportSystemError("Error creating migrated schedule file");
+        fclose(in);
+        return 0;
+    }
+    setvbuf(out, NULL, _IOFBF, EXPORT_BUFFER_SIZE);
+    initScheduleHeader(&header);
+    int ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    while (ok && fread(&schedule, sizeof(schedule), 1, in) == 1)
+    {
+        if (FIXED_RECORD_DEAD(&schedule))
+            continue;
+        ok = appendScheduleRecord(out, &schedule);
+        migrated++;
+    }
+    if (ferror(in))
+        ok = 0;
+    fclose(in);
+    if (fclose(out) != 0)
+        ok = 0;
+    if (ok && rename(path, legacyPath) != 0)
+        ok = 0;
+    else if (ok && rename(tempPath, path) != 0)
+    {
+        rename(legacyPath, path);
+        ok = 0;
+    }
+    if (!ok)
+    {
+        reportSystemError("Error migrating schedule file");
+        remove(tempPath);
+        return 0;
+    }
+    notice("Migrated %ld schedule entries to the compact format; the old file is kept as %s.\n", migrated, legacyPath);
+    return 1;
+}
+
+// Opens the schedule store for update. A missing or empty file gets a fresh header; a version 1 file is
+// migrated first.
+FILE *openScheduleStore(const char *path)
+{
+    struct ScheduleFileHeader header;
+    struct stat info;
+    FILE *file = fopen(path, "rb+");
+    if (file == NULL && errno == ENOENT)
+        file = fopen(path, "wb+");
+    if (file == NULL || fstat(fileno(file), &info) != 0)
+    {
+        if (file != NULL)
+            fclose(file);
+        return NULL;
+    }
+    memset(&header, 0, sizeof(header));
+    if (info.st_size == 0)
+    {
+        initScheduleHeader(&header);
+        if (fwrite(&header, sizeof(header), 1, file) != 1 || fflush(file) != 0)
+        {
+            fclose(file);
+            return NULL;
         }
+        return file;
     }
-    else
+    if (readData(&header, sizeof(header), 1, file) == 1 && checkScheduleHeader(&header))
+        return file;
+    fclose(file);
+    if (strncmp(header.magic, SCHEDULE_STORE_MAGIC, sizeof(header.magic)) != 0 &&
+        info.st_size % (off_t)sizeof(struct AcademicSchedule) == 0)
     {
-        printf("Wrong Username\n");
-        pressEnterToContinue();
+        notice("INFO: Migrating %s to the compact schedule format...\n", path);
+        return migrateScheduleStore(path) ? openScheduleStore(path) : NULL;
     }
+    reportError("ERROR: '%s' is not a version %d schedule store.\n", path, SCHEDULE_STORE_VERSION);
+    errno = EINVAL;
+    return NULL;
 }
 
-void addStudent(FILE **P_ptr, const char *departmentName)
+// Maps the schedule store read-only and sets *pos to its first record.
+int mapScheduleStore(FILE *file, struct StudentMap *map, int advice, size_t *pos)
 {
-    if (*P_ptr == NULL)
+    *pos = sizeof(struct ScheduleFileHeader);
+    if (!mapStudentFile(file, map, advice))
+        return 0;
+    if (map->length < sizeof(struct ScheduleFileHeader) || !checkScheduleHeader((const struct ScheduleFileHeader *)map->data))
     {
-        fprintf(stderr, "ERROR: Student file is not open in addStudent.\n");
-        pressEnterToContinue();
-        return;
+        reportError("ERROR: Schedule store header is missing or corrupt.\n");
+        unmapStudentFile(map);
+        return 0;
     }
+    return 1;
+}
 
-    int addStudentLoop = 1;
-    while (addStudentLoop)
+// Steps *pos over one record of a mapped store, live or not, and returns 1 with its header and offset; 0 at
+// the end of the records, where a torn tail is not counted.
+static int nextScheduleSlot(const struct StudentMap *map, size_t *pos, struct ScheduleRecordHeader *header, size_t *recordPos)
+{
+    if (*pos + sizeof(*header) > map->length)
+        return 0;
+    memcpy(header, map->data + *pos, sizeof(*header));
+    size_t end = *pos + sizeof(*header) + header->capacity;
+    if (header->length > header->capacity || end > map->length)
+        return 0;
+    *recordPos = *pos;
+    *pos = end;
+    return 1;
+}
+
+// Decodes the next live record of a mapped store. Returns 1 with it in *schedule, -1 for a live record that
+// does not decode, 0 at the end.
+int nextScheduleRecord(const struct StudentMap *map, size_t *pos, struct AcademicSchedule *schedule, long *recordPos)
+{
+    struct ScheduleRecordHeader header;
+    size_t at;
+    while (nextScheduleSlot(map, pos, &header, &at))
     {
-        system("clear || cls");
-        printf("\n--- Add New Student to %s ---\n", departmentName);
-        char firstName[100] = "", lastName[100] = "", fatherName[100] = "", motherName[100] = "";
-        char studentID[100] = "", intake[100] = "", section[100] = "";
-        char presentAddress[200] = "", permanentAddress[200] = "";                         
-        char bloodGroup[20] = "", mobileNumber[20] = "", backupMobileNumber[20] = "", email[100] = ""; 
-        printf("Student First Name: ");
-        if (!fgets(firstName, sizeof(firstName), stdin))
-        {
-            printf("Input error!\n");
+        if (header.state != SCHEDULE_RECORD_LIVE)
             continue;
-        }
-        trimWhitespace(firstName);
+        hotPath.recordsScanned++;
+        if (recordPos != NULL)
+            *recordPos = (long)at;
+        return decodeSchedule(&header, (const unsigned char *)map->data + at + sizeof(header), schedule) ? 1 : -1;
+    }
+    return 0;
+}
 
-        printf("Student Last Name: ");
-        if (!fgets(lastName, sizeof(lastName), stdin))
-        {
-            printf("Input error!\n");
+// schedules.free is an IndexHeader (usedCount holes, stamped with schedules.dat) followed by one ScheduleHole
+// per hole, used most recent first. A missing or stale list is rebuilt by walking the store.
+static int rebuildScheduleHoles(FILE *file)
+{
+    struct StudentMap map;
+    struct IndexHeader header;
+    struct ScheduleRecordHeader record;
+    struct ScheduleHole *holes = NULL;
+    char tempPath[300];
+    size_t pos, at;
+    long long used = 0, capacity = 0;
+
+    if (fflush(file) != 0 || !mapScheduleStore(file, &map, POSIX_MADV_SEQUENTIAL, &pos))
+        return 0;
+    int ok = 1;
+    while (ok && nextScheduleSlot(&map, &pos, &record, &at))
+    {
+        if (record.state == SCHEDULE_RECORD_LIVE)
             continue;
+        if (used == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 64;
+            struct ScheduleHole *grown = realloc(holes, (size_t)capacity * sizeof(*holes));
+            ok = grown != NULL;
+            if (ok)
+                holes = grown;
         }
-        trimWhitespace(lastName);
+        if (ok)
+            holes[used++] = (struct ScheduleHole){(long long)at, record.capacity};
+    }
+    unmapStudentFile(&map);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SCHEDULE_FREE_MAGIC, sizeof(SCHEDULE_FREE_MAGIC) - 1);
+    header.version = INDEX_VERSION;
+    header.usedCount = (unsigned int)used;
+    header.slotCount = (unsigned int)used;
+    getFileStamp(SCHEDULE_DATA_FILE, &header.dataSize, &header.dataModified);
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", SCHEDULE_FREE_FILE);
+    FILE *out = ok ? fopen(tempPath, "wb") : NULL;
+    ok = out != NULL && fwrite(&header, sizeof(header), 1, out) == 1 &&
+         (used == 0 || fwrite(holes, sizeof(*holes), (size_t)used, out) == (size_t)used);
+    if (out != NULL && fclose(out) != 0)
+        ok = 0;
+    if (!ok || rename(tempPath, SCHEDULE_FREE_FILE) != 0)
+    {
+        reportSystemError("Error writing schedule hole list");
+        remove(tempPath);
+        ok = 0;
+    }
+    free(holes);
+    return ok;
+}
 
-        printf("Father's Name: ");
-        if (!fgets(fatherName, sizeof(fatherName), stdin))
+static int loadScheduleHoles(struct FreeSlots *slots)
+{
+    long long dataSize = 0, dataModified = 0;
+    memset(slots, 0, sizeof(*slots));
+    slots->file = fopen(SCHEDULE_FREE_FILE, "rb+");
+    if (slots->file == NULL)
+        return 0;
+    int ok = readData(&slots->header, sizeof(slots->header), 1, slots->file) == 1 &&
+             strncmp(slots->header.magic, SCHEDULE_FREE_MAGIC, sizeof(slots->header.magic)) == 0 &&
+             slots->header.version == INDEX_VERSION && getFileStamp(SCHEDULE_DATA_FILE, &dataSize, &dataModified) &&
+             dataSize == slots->header.dataSize && dataModified == slots->header.dataModified;
+    if (!ok)
+        closeFreeSlots(slots);
+    return ok;
+}
+
+static int openScheduleHoles(struct FreeSlots *slots, FILE *file)
+{
+    fflush(file);
+    if (loadScheduleHoles(slots))
+        return 1;
+    return rebuildScheduleHoles(file) && loadScheduleHoles(slots);
+}
+
+static int writeScheduleHole(struct FreeSlots *slots, long long i, const struct ScheduleHole *hole)
+{
+    return seekData(slots->file, (long long)sizeof(struct IndexHeader) + i * (long long)sizeof(*hole), SEEK_SET) == 0 &&
+           fwrite(hole, sizeof(*hole), 1, slots->file) == 1;
+}
+
+static int stampScheduleHoles(struct FreeSlots *slots)
+{
+    if (!getFileStamp(SCHEDULE_DATA_FILE, &slots->header.dataSize, &slots->header.dataModified))
+        return 0;
+    slots->header.slotCount = slots->header.usedCount;
+    return seekData(slots->file, 0, SEEK_SET) == 0 &&
+           fwrite(&slots->header, sizeof(slots->header), 1, slots->file) == 1 && fflush(slots->file) == 0;
+}
+
+// Writes schedule into the most recently freed hole it fits, or appends it. Returns its offset, or -1 on error.
+long placeScheduleRecord(FILE *file, const struct AcademicSchedule *schedule)
+{
+    struct ScheduleRecordHeader header;
+    unsigned char heap[SCHEDULE_HEAP_MAX];
+    struct FreeSlots slots;
+    struct ScheduleHole hole;
+    long long h = -1;
+    long pos = -1;
+
+    packSchedule(schedule, &header, heap);
+    int tracked = openScheduleHoles(&slots, file);
+    for (long long i = tracked ? (long long)slots.header.usedCount - 1 : -1; i >= 0 && h < 0; i--)
+    {
+        if (seekData(slots.file, (long long)sizeof(struct IndexHeader) + i * (long long)sizeof(hole), SEEK_SET) != 0 ||
+            readData(&hole, sizeof(hole), 1, slots.file) != 1)
+            break;
+        if (hole.capacity >= header.length)
+            h = i;
+    }
+    if (h >= 0)
+    {
+        pos = (long)hole.offset;
+        header.capacity = (unsigned short)hole.capacity;
+    }
+    else if (seekData(file, 0, SEEK_END) == 0)
+    {
+        pos = ftell(file);
+    }
+    if (pos < 0 || !writeScheduleAt(file, pos, &header, heap))
+    {
+        closeFreeSlots(&slots);
+        return -1;
+    }
+    if (tracked)
+    {
+        // The last hole moves into the one just filled.
+        struct ScheduleHole last;
+        long long lastPos = (long long)sizeof(struct IndexHeader) + (slots.header.usedCount - 1) * (long long)sizeof(last);
+        int listed = h < 0 || (seekData(slots.file, lastPos, SEEK_SET) == 0 && readData(&last, sizeof(last), 1, slots.file) == 1 &&
+                               writeScheduleHole(&slots, h, &last));
+        if (listed && h >= 0)
+            slots.header.usedCount--;
+        if (listed)
+            stampScheduleHoles(&slots);
+        closeFreeSlots(&slots);
+    }
+    return pos;
+}
+
+// Turns the records at positions[0..count) into holes, one state byte each, and lists them for reuse.
+// Returns 1 on success, 0 on error.
+int freeScheduleRecords(FILE *file, const long *positions, long count)
+{
+    static const unsigned char holeState = 0;
+    struct ScheduleRecordHeader header;
+    struct FreeSlots slots;
+    int tracked = openScheduleHoles(&slots, file);
+    int ok = 1;
+    for (long i = 0; ok && i < count; i++)
+    {
+        ok = readScheduleAt(file, positions[i], &header, NULL) >= 0 && seekData(file, positions[i], SEEK_SET) == 0 &&
+             fwrite(&holeState, 1, 1, file) == 1 && fflush(file) == 0;
+        if (!ok)
         {
-            printf("Input error!\n");
-            continue;
+            reportSystemError("Error writing schedule file");
+            clearerr(file);
         }
-        trimWhitespace(fatherName);
+        if (ok && tracked)
+        {
+            struct ScheduleHole hole = {positions[i], header.capacity};
+            tracked = writeScheduleHole(&slots, slots.header.usedCount, &hole);
+            slots.header.usedCount += tracked;
+        }
+    }
+    if (tracked)
+        stampScheduleHoles(&slots);
+    closeFreeSlots(&slots);
+    return ok;
+}
 
-        printf("Mother's Name: ");
-        if (!fgets(motherName, sizeof(motherName), stdin))
+// Rewrites the record at recordPos in place when the new version fits its capacity, and moves it otherwise.
+// Returns the record's offset afterwards, or -1 on error.
+long rewriteScheduleRecord(FILE *file, long recordPos, const struct AcademicSchedule *schedule)
+{
+    struct ScheduleRecordHeader current, header;
+    unsigned char heap[SCHEDULE_HEAP_MAX];
+    if (readScheduleAt(file, recordPos, &current, NULL) <= 0)
+        return -1;
+    packSchedule(schedule, &header, heap);
+    if (header.length <= current.capacity)
+    {
+        header.capacity = current.capacity;
+        return writeScheduleAt(file, recordPos, &header, heap) ? recordPos : -1;
+    }
+    long moved = placeScheduleRecord(file, schedule);
+    if (moved < 0 || !freeScheduleRecords(file, &recordPos, 1))
+        return -1;
+    return moved;
+}
+
+int makeScheduleKey(char *key, const char *intake, const char *section, const char *scheduleType)
+{
+    int n = snprintf(key, ROSTER_KEY_SIZE, "%s|%s|%s", intake, section, scheduleType);
+    return n > 0 && n < ROSTER_KEY_SIZE;
+}
+
+// schedules.idx files each live record's offset under "INTAKE|SECTION|TYPE", so one section's entries are the
+// keys sharing the "INTAKE|SECTION|" prefix.
+int rebuildScheduleIndex(FILE *scheduleFile)
+{
+    struct StudentMap map;
+    struct CodePool groups;
+    struct AcademicSchedule schedule;
+    char key[ROSTER_KEY_SIZE];
+    long *groupOf = NULL;
+    long long *offsets = NULL;
+    long long count = 0, capacity = 0;
+    long corrupt = 0;
+    size_t pos;
+    long recordPos;
+    int got;
+
+    memset(&groups, 0, sizeof(groups));
+    if (fflush(scheduleFile) != 0 || !mapScheduleStore(scheduleFile, &map, POSIX_MADV_SEQUENTIAL, &pos))
+        return 0;
+    int ok = 1;
+    while (ok && (got = nextScheduleRecord(&map, &pos, &schedule, &recordPos)) != 0)
+    {
+        if (got < 0 || !makeScheduleKey(key, schedule.intake, schedule.section, schedule.scheduleType))
         {
-            printf("Input error!\n");
+            corrupt++;
             continue;
         }
-        trimWhitespace(motherName);
+        if (count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 1024;
+            long *grownGroups = realloc(groupOf, (size_t)capacity * sizeof(long));
+            if (grownGroups != NULL)
+                groupOf = grownGroups;
+            long long *grownOffsets = realloc(offsets, (size_t)capacity * sizeof(long long));
+            if (grownOffsets != NULL)
+                offsets = grownOffsets;
+            ok = grownGroups != NULL && grownOffsets != NULL;
+        }
+        if (ok)
+        {
+            offsets[count] = recordPos;
+            ok = (groupOf[count++] = internCode(&groups, (struct FieldView){key, strlen(key)})) >= 0;
+        }
+    }
+    unmapStudentFile(&map);
+    ok = ok && writeRosterFile(SCHEDULE_INDEX_FILE, SCHEDULE_INDEX_MAGIC, SCHEDULE_DATA_FILE, &groups, groupOf, offsets, count);
+    if (ok)
+    {
+        notice("Schedule index rebuilt: %u schedule types indexed.\n", groups.count);
+        if (corrupt > 0)
+            reportError("Warning: %ld potentially corrupt schedule records were left out of the index.\n", corrupt);
+    }
+    else
+        reportError("ERROR: Could not rebuild schedule index.\n");
+    free(groupOf);
+    free(offsets);
+    freeCodePool(&groups);
+    return ok;
+}
 
-        printf("Student ID: ");
-        if (!fgets(studentID, sizeof(studentID), stdin))
+int openScheduleIndex(struct RosterIndex *index, FILE *scheduleFile)
+{
+    fflush(scheduleFile);
+    if (loadRosterDirectory(index, SCHEDULE_INDEX_FILE, SCHEDULE_INDEX_MAGIC, SCHEDULE_DATA_FILE))
+        return 1;
+    notice("INFO: Schedule index is missing or stale. Rebuilding...\n");
+    return rebuildScheduleIndex(scheduleFile) &&
+           loadRosterDirectory(index, SCHEDULE_INDEX_FILE, SCHEDULE_INDEX_MAGIC, SCHEDULE_DATA_FILE);
+}
+
+static void settleScheduleIndex(struct RosterIndex *index, int patched, FILE *scheduleFile)
+{
+    closeRosterIndex(index);
+    if (!patched)
+        rebuildScheduleIndex(scheduleFile);
+}
+
+// Reads the live entries for key's intake and section, only those of key's type when withType is set, in
+// store order. Returns the count with malloc'd arrays in *schedules and, if wanted, *positions, or -1 on error.
+long fetchScheduleRecords(FILE *scheduleFile, const struct AcademicSchedule *key, int withType,
+                          struct AcademicSchedule **schedules, long **positions)
+{
+    char indexKey[ROSTER_KEY_SIZE];
+    struct ScheduleRecordHeader header;
+    *schedules = NULL;
+    if (positions != NULL)
+        *positions = NULL;
+    if (!makeScheduleKey(indexKey, key->intake, key->section, withType ? key->scheduleType : ""))
+        return 0;
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        struct RosterIndex index;
+        long long *numbers;
+        if (!openScheduleIndex(&index, scheduleFile))
+            return -1;
+        long long count = rosterIndexCollect(&index, indexKey, !withType, &numbers);
+        closeRosterIndex(&index);
+        if (count < 0)
+            return -1;
+        struct AcademicSchedule *found = malloc((size_t)(count > 0 ? count : 1) * sizeof(struct AcademicSchedule));
+        long *foundPos = malloc((size_t)(count > 0 ? count : 1) * sizeof(long));
+        int ok = found != NULL && foundPos != NULL;
+        long long i = 0;
+        for (; ok && i < count; i++)
+        {
+            foundPos[i] = (long)numbers[i];
+            if (readScheduleAt(scheduleFile, foundPos[i], &header, &found[i]) <= 0 ||
+                (withType ? !matchSchedule(&found[i], key)
+                          : strcmp(found[i].intake, key->intake) != 0 || strcmp(found[i].section, key->section) != 0))
+                break;
+        }
+        free(numbers);
+        if (ok && i == count)
         {
-            printf("Input error!\n");
-            continue;
+            *schedules = found;
+            if (positions != NULL)
+                *positions = foundPos;
+            else
+                free(foundPos);
+            return (long)count;
+        }
+        free(found);
+        free(foundPos);
+        if (!ok)
+        {
+            reportSystemError("Error allocating schedule list");
+            return -1;
         }
-        trimWhitespace(studentID);
 
-        printf("Intake: ");
-        if (!fgets(intake, sizeof(intake), stdin))
+        notice("INFO: Schedule index points at the wrong record. Rebuilding...\n");
+        if (!rebuildScheduleIndex(scheduleFile))
+            return -1;
+    }
+    return -1;
+}
+
+// findFixedRecord for schedules through schedules.idx: the first entry of key's type. Same return values.
+int findScheduleRecord(FILE *scheduleFile, const struct AcademicSchedule *key, struct AcademicSchedule *schedule,
+                       long *recordPos)
+{
+    struct AcademicSchedule *schedules;
+    long *positions;
+    long count = fetchScheduleRecords(scheduleFile, key, 1, &schedules, &positions);
+    if (count > 0)
+    {
+        *schedule = schedules[0];
+        if (recordPos != NULL)
+            *recordPos = positions[0];
+    }
+    free(schedules);
+    free(positions);
+    return count > 0 ? 1 : (int)count;
+}
+
+static const char *const weekdayNames[] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", NULL};
+
+// Weekdays named in day as a bitmask, Sunday first. "Sun", "Sunday & Tuesday", "Mon-Wed" and "Sat to Mon" all work.
+static int parseWeekdays(const char *day)
+{
+    int mask = 0, last = -1, range = 0;
+    const char *p = day;
+    while (*p != '\0')
+    {
+        if (!isalpha((unsigned char)*p))
         {
-            printf("Input error!\n");
+            range |= *p == '-' && last >= 0;
+            p++;
             continue;
         }
-        trimWhitespace(intake);
-
-        printf("Section: ");
-        if (!fgets(section, sizeof(section), stdin))
+        char word[16];
+        size_t n = 0;
+        for (; isalpha((unsigned char)*p); p++)
         {
-            printf("Input error!\n");
+            if (n + 1 < sizeof(word))
+                word[n++] = (char)tolower((unsigned char)*p);
+        }
+        word[n] = '\0';
+        if (strcmp(word, "to") == 0 && last >= 0)
+        {
+            range = 1;
             continue;
         }
-        trimWhitespace(section);
+        int d = -1;
+        for (int i = 0; n >= 3 && d < 0 && weekdayNames[i] != NULL; i++)
+        {
+            size_t k = 0;
+            while (k < n && tolower((unsigned char)weekdayNames[i][k]) == word[k])
+                k++;
+            if (k == n)
+                d = i;
+        }
+        if (d < 0)
+            continue;
+        for (int i = last; range && i != d; i = (i + 1) % 7)
+            mask |= 1 << i;
+        mask |= 1 << d;
+        last = d;
+        range = 0;
+    }
+    return mask;
+}
 
-        printf("Present Address: ");
-        if (!fgets(presentAddress, sizeof(presentAddress), stdin))
+// One clock time at *p such as "9", "9:30", "09.30", "9:30 pm" or "21:30", in minutes past midnight as
+// written, or -1. *meridiem is 'a', 'p' or 0.
+static int parseClock(const char **p, int *meridiem)
+{
+    const char *s = *p;
+    int hour = 0, minute = 0, digits = 0;
+    while (isspace((unsigned char)*s))
+        s++;
+    for (; isdigit((unsigned char)*s) && digits < 2; s++, digits++)
+        hour = hour * 10 + (*s - '0');
+    if (digits == 0)
+        return -1;
+    if ((*s == ':' || *s == '.') && isdigit((unsigned char)s[1]) && isdigit((unsigned char)s[2]))
+    {
+        minute = (s[1] - '0') * 10 + (s[2] - '0');
+        s += 3;
+    }
+    while (isspace((unsigned char)*s))
+        s++;
+    *meridiem = 0;
+    int letter = tolower((unsigned char)*s);
+    if ((letter == 'a' || letter == 'p') && (tolower((unsigned char)s[1]) == 'm' || (s[1] == '.' && tolower((unsigned char)s[2]) == 'm')))
+    {
+        *meridiem = letter;
+        s += s[1] == '.' ? 3 : 2;
+        if (*s == '.')
+            s++;
+    }
+    if (hour > 23 || minute > 59 || (*meridiem != 0 && (hour < 1 || hour > 12)))
+        return -1;
+    *p = s;
+    return hour * 60 + minute;
+}
+
+static int applyMeridiem(int minutes, int meridiem)
+{
+    if (meridiem == 0)
+        return minutes;
+    return (minutes / 60 % 12 + (meridiem == 'p' ? 12 : 0)) * 60 + minutes % 60;
+}
+
+// Minutes past midnight a routine's time covers, from "10:00 AM - 11:30 AM", "10:00-11:30 am" or "14:00". A
+// start without AM/PM takes the end's unless that would put it after the end; a missing end means an hour.
+static int parseTimeRange(const char *text, long long *start, long long *end)
+{
+    const char *p = text;
+    int startMeridiem, endMeridiem = 0;
+    int from = parseClock(&p, &startMeridiem), to = -1;
+    if (from < 0)
+        return 0;
+    while (isspace((unsigned char)*p))
+        p++;
+    int toWord = tolower((unsigned char)p[0]) == 't' && tolower((unsigned char)p[1]) == 'o';
+    if (*p == '-' || toWord || strncmp(p, "\xe2\x80\x93", 3) == 0) // hyphen, "to" or an en dash
+    {
+        p += *p == '-' ? 1 : toWord ? 2 : 3;
+        to = parseClock(&p, &endMeridiem);
+        if (to < 0)
+            return 0;
+        to = applyMeridiem(to, endMeridiem);
+    }
+    if (startMeridiem == 0 && endMeridiem != 0 && applyMeridiem(from, endMeridiem) < to)
+        from = applyMeridiem(from, endMeridiem);
+    from = applyMeridiem(from, startMeridiem);
+    if (to < 0)
+        to = from + CLASH_DEFAULT_MINUTES;
+    else if (to <= from && startMeridiem == 0 && endMeridiem == 0 && to + 12 * 60 > from)
+        to += 12 * 60; // "11:00-1:00"
+    if (to <= from)
+        return 0;
+    *start = from;
+    *end = to;
+    return 1;
+}
+
+// Days since 1970-01-01 in the proleptic Gregorian calendar.
+static long long daysFromCivil(long long year, int month, int day)
+{
+    year -= month <= 2;
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    long long yearOfEra = year - era * 400;
+    long long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+static void civilFromDays(long long days, long long *year, int *month, int *day)
+{
+    days += 719468;
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    long long dayOfEra = days - era * 146097;
+    long long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    long long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    long long mp = (5 * dayOfYear + 2) / 153;
+    *day = (int)(dayOfYear - (153 * mp + 2) / 5 + 1);
+    *month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    *year = yearOfEra + era * 400 + (*month <= 2);
+}
+
+// The first date in text, as YYYY-MM-DD or DD/MM/YYYY (any of - / . between the parts).
+static int parseExamDate(const char *text, long long *days)
+{
+    int a, b, c, year, day;
+    char first, second;
+    if (sscanf(text, "%d%c%d%c%d", &a, &first, &b, &second, &c) != 5 || first != second ||
+        (first != '-' && first != '/' && first != '.'))
+        return 0;
+    year = a > 31 ? a : c;
+    day = a > 31 ? c : a;
+    if (year < 1900 || year > 9999 || b < 1 || b > 12 || day < 1 || day > 31)
+        return 0;
+    *days = daysFromCivil(year, b, day);
+    return 1;
+}
+
+// kind followed by name without case or spaces. Returns 0 for a blank name or a shared venue such as "Online"
+// or "TBA", which never clash.
+static int foldBookingName(int kind, const char *name, char *folded, size_t size)
+{
+    static const char *const shared[] = {"", "tba", "tbd", "na", "n/a", "none", "-", "online", NULL};
+    size_t n = 0;
+    int listed = 0;
+    for (; *name != '\0' && n + 2 < size; name++)
+    {
+        if (!isspace((unsigned char)*name))
+            folded[1 + n++] = (char)tolower((unsigned char)*name);
+    }
+    folded[0] = (char)kind;
+    folded[1 + n] = '\0';
+    for (int i = 0; !listed && shared[i] != NULL; i++)
+        listed = strcmp(shared[i], folded + 1) == 0;
+    return !listed;
+}
+
+static const char *bookingName(const struct AcademicSchedule *schedule, int kind)
+{
+    if (kind == BOOKING_SLOT)
+        return "";
+    return kind == BOOKING_ROOM ? schedule->routineData.room : schedule->routineData.faculty;
+}
+
+// The bookings schedule makes: its room, its faculty and a slot on every weekday it names, or on its date for an
+// exam that has one. Entries that are not routines or whose time does not parse book nothing.
+static int scheduleBookings(const struct AcademicSchedule *schedule, long recordPos, struct Booking *bookings)
+{
+    static const int kinds[] = {BOOKING_ROOM, BOOKING_FACULTY, BOOKING_SLOT};
+    long long from, to, days, base[7];
+    char folded[128];
+    int dayCount = 0, count = 0;
+    if (!isRoutineType(schedule->scheduleType) || !parseTimeRange(schedule->routineData.time, &from, &to))
+        return 0;
+    if (strcmp(schedule->scheduleType, "Class Routine") != 0 && parseExamDate(schedule->routineData.date, &days))
+    {
+        base[dayCount++] = (CLASH_DATED_BASE + days) * MINUTES_PER_DAY;
+    }
+    else
+    {
+        int mask = parseWeekdays(schedule->routineData.day);
+        for (int d = 0; d < 7; d++)
         {
-            printf("Input error!\n");
+            if (mask & (1 << d))
+                base[dayCount++] = (long long)d * MINUTES_PER_DAY;
+        }
+    }
+    for (int k = 0; k < 3; k++)
+    {
+        if (!foldBookingName(kinds[k], bookingName(schedule, kinds[k]), folded, sizeof(folded)) && kinds[k] != BOOKING_SLOT)
+            continue;
+        unsigned int resource = hashIndexKey(folded);
+        for (int d = 0; d < dayCount; d++)
+            bookings[count++] = (struct Booking){resource, kinds[k], base[d] + from, base[d] + to, base[d] + to, recordPos};
+    }
+    return count;
+}
+
+static int compareBookings(const void *a, const void *b)
+{
+    const struct Booking *x = a, *y = b;
+    if (x->resource != y->resource)
+        return x->resource < y->resource ? -1 : 1;
+    if (x->start != y->start)
+        return x->start < y->start ? -1 : 1;
+    return (x->recordPos > y->recordPos) - (x->recordPos < y->recordPos);
+}
+
+static int isDatedBooking(const struct Booking *booking)
+{
+    return booking->start >= CLASH_DATED_BASE * MINUTES_PER_DAY;
+}
+
+// Where start falls on the weekly timeline: a dated booking moves to the same minute of its date's weekday.
+static long long weeklyStart(long long start)
+{
+    if (start < CLASH_DATED_BASE * MINUTES_PER_DAY)
+        return start;
+    long long day = start / MINUTES_PER_DAY;
+    long long weekday = ((day - CLASH_DATED_BASE + 4) % 7 + 7) % 7; // 1970-01-01 was a Thursday
+    return weekday * MINUTES_PER_DAY + (start - day * MINUTES_PER_DAY);
+}
+
+// Whether two bookings overlap in time. A dated exam also meets the weekly classes held on its weekday, so a
+// dated and a weekly booking are compared on the weekly timeline; two dated ones only meet on the same date.
+static int bookingsOverlap(const struct Booking *a, const struct Booking *b)
+{
+    long long aStart = a->start, bStart = b->start;
+    if (isDatedBooking(a) != isDatedBooking(b))
+    {
+        aStart = weeklyStart(a->start);
+        bStart = weeklyStart(b->start);
+    }
+    return aStart < bStart + (b->end - b->start) && bStart < aStart + (a->end - a->start);
+}
+
+// "Sun 10:00-11:30" on the weekly timeline, "2024-03-10 10:00-11:30" on the dated one.
+void formatBookingTime(long long start, long long end, char *out, size_t size)
+{
+    static const char *const days[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+    long long day = start / MINUTES_PER_DAY, year;
+    long long from = start - day * MINUTES_PER_DAY, to = end - day * MINUTES_PER_DAY;
+    int month, dayOfMonth;
+    char when[48];
+    if (day < 7)
+    {
+        snprintf(when, sizeof(when), "%s", days[day]);
+    }
+    else
+    {
+        civilFromDays(day - CLASH_DATED_BASE, &year, &month, &dayOfMonth);
+        snprintf(when, sizeof(when), "%04lld-%02d-%02d", year, month, dayOfMonth);
+    }
+    snprintf(out, size, "%s %02lld:%02lld-%02lld:%02lld", when, from / 60, from % 60, to / 60, to % 60);
+}
+
+// Collects every booking in the store, sorts them and fills in maxEnd, then writes schedules.clash afresh.
+int rebuildClashIndex(FILE *scheduleFile)
+{
+    struct StudentMap map;
+    struct AcademicSchedule schedule;
+    struct IndexHeader header;
+    struct Booking *bookings = NULL;
+    char tempPath[300];
+    long long count = 0, capacity = 0;
+    size_t pos;
+    long recordPos;
+    int got;
+
+    if (fflush(scheduleFile) != 0 || !mapScheduleStore(scheduleFile, &map, POSIX_MADV_SEQUENTIAL, &pos))
+        return 0;
+    int ok = 1;
+    while (ok && (got = nextScheduleRecord(&map, &pos, &schedule, &recordPos)) != 0)
+    {
+        if (got < 0)
             continue;
+        if (count + SCHEDULE_BOOKINGS_MAX > capacity)
+        {
+            capacity = capacity ? capacity * 2 : 1024;
+            struct Booking *grown = realloc(bookings, (size_t)capacity * sizeof(*bookings));
+            ok = grown != NULL;
+            if (ok)
+                bookings = grown;
         }
-        trimWhitespace(presentAddress);
+        if (ok)
+            count += scheduleBookings(&schedule, recordPos, bookings + count);
+    }
+    unmapStudentFile(&map);
+    if (ok && count > 0)
+        qsort(bookings, (size_t)count, sizeof(*bookings), compareBookings);
+    for (long long i = 1; ok && i < count; i++)
+    {
+        if (bookings[i].resource == bookings[i - 1].resource && bookings[i - 1].maxEnd > bookings[i].maxEnd)
+            bookings[i].maxEnd = bookings[i - 1].maxEnd;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CLASH_INDEX_MAGIC, sizeof(CLASH_INDEX_MAGIC) - 1);
+    header.version = INDEX_VERSION;
+    header.slotCount = (unsigned int)count;
+    getFileStamp(SCHEDULE_DATA_FILE, &header.dataSize, &header.dataModified);
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", CLASH_INDEX_FILE);
+    FILE *out = ok ? fopen(tempPath, "wb") : NULL;
+    ok = out != NULL && fwrite(&header, sizeof(header), 1, out) == 1 &&
+         (count == 0 || fwrite(bookings, sizeof(*bookings), (size_t)count, out) == (size_t)count);
+    if (out != NULL && fclose(out) != 0)
+        ok = 0;
+    if (!ok || rename(tempPath, CLASH_INDEX_FILE) != 0)
+    {
+        reportSystemError("Error writing clash index");
+        remove(tempPath);
+        ok = 0;
+    }
+    free(bookings);
+    return ok;
+}
+
+static int loadClashIndex(struct ClashIndex *index)
+{
+    long long dataSize = 0, dataModified = 0;
+    memset(index, 0, sizeof(*index));
+    index->file = fopen(CLASH_INDEX_FILE, "rb+");
+    if (index->file == NULL)
+        return 0;
+    int ok = readData(&index->header, sizeof(index->header), 1, index->file) == 1 &&
+             strncmp(index->header.magic, CLASH_INDEX_MAGIC, sizeof(index->header.magic)) == 0 &&
+             index->header.version == INDEX_VERSION && getFileStamp(SCHEDULE_DATA_FILE, &dataSize, &dataModified) &&
+             dataSize == index->header.dataSize && dataModified == index->header.dataModified &&
+             mapStudentFile(index->file, &index->map, POSIX_MADV_RANDOM) &&
+             index->map.length == sizeof(struct IndexHeader) +
+                                      ((size_t)index->header.slotCount + index->header.usedCount) * sizeof(struct Booking);
+    if (!ok)
+    {
+        closeClashIndex(index);
+        return 0;
+    }
+    index->sorted = (const struct Booking *)(index->map.data + sizeof(struct IndexHeader));
+    return 1;
+}
+
+int openClashIndex(struct ClashIndex *index, FILE *scheduleFile)
+{
+    fflush(scheduleFile);
+    if (loadClashIndex(index))
+        return 1;
+    notice("INFO: Clash index is missing or stale. Rebuilding...\n");
+    return rebuildClashIndex(scheduleFile) && loadClashIndex(index);
+}
+
+void closeClashIndex(struct ClashIndex *index)
+{
+    unmapStudentFile(&index->map);
+    if (index->file != NULL)
+        fclose(index->file);
+    memset(index, 0, sizeof(*index));
+}
+
+// First sorted booking at or after (resource, start).
+static long long lowerBooking(const struct ClashIndex *index, unsigned int resource, long long start)
+{
+    long long lo = 0, hi = index->header.slotCount;
+    while (lo < hi)
+    {
+        long long mid = lo + (hi - lo) / 2;
+        const struct Booking *b = &index->sorted[mid];
+        if (b->resource < resource || (b->resource == resource && b->start < start))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Appends the bookings schedule makes at recordPos. Fails once the appended part is full, so that the caller
+// rebuilds and sorts them in.
+static int clashIndexAdd(struct ClashIndex *index, const struct AcademicSchedule *schedule, long recordPos)
+{
+    struct Booking bookings[SCHEDULE_BOOKINGS_MAX];
+    int count = scheduleBookings(schedule, recordPos, bookings);
+    if (count == 0)
+        return 1;
+    if (index->header.usedCount + (unsigned int)count > CLASH_DELTA_MAX)
+        return 0;
+    long long at = (long long)index->header.slotCount + index->header.usedCount;
+    if (seekData(index->file, (off_t)(sizeof(struct IndexHeader) + at * sizeof(struct Booking)), SEEK_SET) != 0 ||
+        fwrite(bookings, sizeof(struct Booking), (size_t)count, index->file) != (size_t)count)
+        return 0;
+    index->header.usedCount += (unsigned int)count;
+    return 1;
+}
 
-        printf("Permanent Address: ");
-        if (!fgets(permanentAddress, sizeof(permanentAddress), stdin))
-        {
-            printf("Input error!\n");
-            continue;
+// Marks the bookings schedule made at recordPos as removed. Only finds bookings that were in the index when it
+// was opened, so removals come before additions.
+static int clashIndexRemove(struct ClashIndex *index, const struct AcademicSchedule *schedule, long recordPos)
+{
+    static const long long removed = -1;
+    struct Booking bookings[SCHEDULE_BOOKINGS_MAX];
+    int count = scheduleBookings(schedule, recordPos, bookings);
+    const struct Booking *appended = index->sorted + index->header.slotCount;
+    for (int i = 0; i < count; i++)
+    {
+        const struct Booking *b = &bookings[i];
+        long long at = lowerBooking(index, b->resource, b->start);
+        while (at < index->header.slotCount && index->sorted[at].resource == b->resource &&
+               index->sorted[at].start == b->start && index->sorted[at].recordPos != recordPos)
+            at++;
+        if (at >= index->header.slotCount || index->sorted[at].recordPos != recordPos ||
+            index->sorted[at].resource != b->resource || index->sorted[at].start != b->start)
+        {
+            at = -1;
+            for (unsigned int j = 0; at < 0 && j < index->header.usedCount; j++)
+            {
+                if (appended[j].recordPos == recordPos && appended[j].resource == b->resource && appended[j].start == b->start)
+                    at = (long long)index->header.slotCount + j;
+            }
         }
-        trimWhitespace(permanentAddress);
+        if (at < 0)
+            return 0;
+        off_t pos = (off_t)(sizeof(struct IndexHeader) + at * sizeof(struct Booking) + offsetof(struct Booking, recordPos));
+        if (seekData(index->file, pos, SEEK_SET) != 0 || fwrite(&removed, sizeof(removed), 1, index->file) != 1)
+            return 0;
+    }
+    return 1;
+}
 
-        printf("Blood Group: ");
-        if (!fgets(bloodGroup, sizeof(bloodGroup), stdin))
-        {
-            printf("Input error!\n");
-            continue;
-        }
-        trimWhitespace(bloodGroup);
+static int stampClashIndex(struct ClashIndex *index)
+{
+    if (!getFileStamp(SCHEDULE_DATA_FILE, &index->header.dataSize, &index->header.dataModified))
+        return 0;
+    return seekData(index->file, 0, SEEK_SET) == 0 &&
+           fwrite(&index->header, sizeof(index->header), 1, index->file) == 1 && fflush(index->file) == 0;
+}
 
-        printf("Mobile Number: ");
-        if (!fgets(mobileNumber, sizeof(mobileNumber), stdin))
-        {
-            printf("Input error!\n");
-            continue;
-        }
-        trimWhitespace(mobileNumber);
+static void settleClashIndex(struct ClashIndex *index, int patched, FILE *scheduleFile)
+{
+    patched = patched && stampClashIndex(index);
+    closeClashIndex(index);
+    if (!patched)
+        rebuildClashIndex(scheduleFile);
+}
 
-        printf("Backup Mobile Number: ");
-        if (!fgets(backupMobileNumber, sizeof(backupMobileNumber), stdin))
+// Records the overlap between bookings a (of first at firstPos) and b if b's record still holds a booking of the
+// same name, which rules out hash collisions. Returns 0 only when out of memory.
+static int addScheduleClash(FILE *scheduleFile, const struct AcademicSchedule *first, long firstPos,
+                            const struct Booking *a, const struct Booking *b, struct ScheduleClash **clashes,
+                            long *count, long *capacity)
+{
+    struct ScheduleRecordHeader header;
+    struct AcademicSchedule other;
+    char name[128], otherName[128];
+    if (readScheduleAt(scheduleFile, (long)b->recordPos, &header, &other) <= 0 ||
+        !foldBookingName(a->kind, bookingName(first, a->kind), name, sizeof(name)) ||
+        !foldBookingName(b->kind, bookingName(&other, b->kind), otherName, sizeof(otherName)) ||
+        strcmp(name, otherName) != 0)
+        return 1;
+    if (*count == *capacity)
+    {
+        *capacity = *capacity ? *capacity * 2 : 16;
+        struct ScheduleClash *grown = realloc(*clashes, (size_t)*capacity * sizeof(**clashes));
+        if (grown == NULL)
         {
-            printf("Input error!\n");
-            continue;
+            reportSystemError("Error allocating clash list");
+            return 0;
         }
-        trimWhitespace(backupMobileNumber);
+        *clashes = grown;
+    }
+    // A weekly class that meets a dated exam is shown on the exam's date.
+    long long aShift = 0, bShift = 0;
+    if (isDatedBooking(a) && !isDatedBooking(b))
+        bShift = a->start - weeklyStart(a->start);
+    else if (isDatedBooking(b) && !isDatedBooking(a))
+        aShift = b->start - weeklyStart(b->start);
+    struct ScheduleClash *clash = &(*clashes)[(*count)++];
+    clash->kind = a->kind;
+    clash->start = a->start + aShift > b->start + bShift ? a->start + aShift : b->start + bShift;
+    clash->end = a->end + aShift < b->end + bShift ? a->end + aShift : b->end + bShift;
+    clash->recordPos[0] = firstPos;
+    clash->recordPos[1] = (long)b->recordPos;
+    clash->entries[0] = *first;
+    clash->entries[1] = other;
+    return 1;
+}
 
-        printf("Email Address: ");
-        if (!fgets(email, sizeof(email), stdin))
-        {
-            printf("Input error!\n");
+// Every booking of another entry that overlaps one schedule would make. recordPos is schedule's own record when
+// it is being edited and -1 for a new entry. Each booking costs a binary search into its resource's sorted run,
+// a walk back while maxEnd still reaches its start, and a pass over the few appended bookings. A dated exam is
+// also looked up at its weekday in the weekly part of the run, and a weekly class checks the run's dated exams.
+// Returns the count with a malloc'd array in *clashes, or -1 on error.
+long findScheduleClashes(FILE *scheduleFile, const struct AcademicSchedule *schedule, long recordPos,
+                         struct ScheduleClash **clashes)
+{
+    struct Booking bookings[SCHEDULE_BOOKINGS_MAX];
+    struct ClashIndex index;
+    long count = 0, capacity = 0;
+    *clashes = NULL;
+    int bookingCount = scheduleBookings(schedule, recordPos, bookings);
+    if (bookingCount == 0)
+        return 0;
+    if (!openClashIndex(&index, scheduleFile))
+        return -1;
+    const struct Booking *appended = index.sorted + index.header.slotCount;
+    int ok = 1;
+    for (int i = 0; ok && i < bookingCount; i++)
+    {
+        const struct Booking *b = &bookings[i];
+        if (b->kind == BOOKING_SLOT)
             continue;
+        long long windows[2][2] = {{b->start, b->end}, {weeklyStart(b->start), weeklyStart(b->start) + b->end - b->start}};
+        for (int w = 0; w < (isDatedBooking(b) ? 2 : 1); w++)
+        {
+            for (long long j = lowerBooking(&index, b->resource, windows[w][1]) - 1;
+                 ok && j >= 0 && index.sorted[j].resource == b->resource && index.sorted[j].maxEnd > windows[w][0]; j--)
+            {
+                const struct Booking *other = &index.sorted[j];
+                if (bookingsOverlap(b, other) && other->kind == b->kind && other->recordPos >= 0 &&
+                    other->recordPos != recordPos)
+                    ok = addScheduleClash(scheduleFile, schedule, recordPos, b, other, clashes, &count, &capacity);
+            }
         }
-        trimWhitespace(email);
-
-        // --- Validate Input ---
-        if (strlen(studentID) == 0 || strlen(firstName) == 0 || strlen(lastName) == 0)
+        for (long long j = isDatedBooking(b) ? index.header.slotCount
+                                             : lowerBooking(&index, b->resource, CLASH_DATED_BASE * MINUTES_PER_DAY);
+             ok && j < index.header.slotCount && index.sorted[j].resource == b->resource; j++)
         {
-            printf("\nError: Student ID and Full Name are required.\n");
+            const struct Booking *other = &index.sorted[j];
+            if (bookingsOverlap(b, other) && other->kind == b->kind && other->recordPos >= 0 && other->recordPos != recordPos)
+                ok = addScheduleClash(scheduleFile, schedule, recordPos, b, other, clashes, &count, &capacity);
         }
-        else
+        for (unsigned int j = 0; ok && j < index.header.usedCount; j++)
         {
-            if (fseek(*P_ptr, 0, SEEK_END) != 0)
+            const struct Booking *other = &appended[j];
+            if (other->resource == b->resource && other->kind == b->kind && bookingsOverlap(b, other) &&
+                other->recordPos >= 0 && other->recordPos != recordPos)
+                ok = addScheduleClash(scheduleFile, schedule, recordPos, b, other, clashes, &count, &capacity);
+        }
+    }
+    closeClashIndex(&index);
+    if (!ok)
+    {
+        free(*clashes);
+        *clashes = NULL;
+        return -1;
+    }
+    return count;
+}
+
+// Every overlapping pair of bookings in the store, from one sweep over the live bookings in (resource, start)
+// order: each booking pairs with the earlier ones of its resource that have not ended when it starts. A dated
+// exam, which sorts after its resource's weekly classes, is also projected onto its weekday and looked up in
+// that weekly run. Returns the count with a malloc'd array in *clashes, or -1 on error.
+long collectScheduleClashes(FILE *scheduleFile, struct ScheduleClash **clashes)
+{
+    struct ClashIndex index;
+    struct ScheduleRecordHeader header;
+    struct AcademicSchedule first;
+    long count = 0, capacity = 0;
+    *clashes = NULL;
+    if (!openClashIndex(&index, scheduleFile))
+        return -1;
+    size_t sortedCount = index.header.slotCount, total = sortedCount + index.header.usedCount, live = 0, running = 0;
+    struct Booking *bookings = malloc((total ? total : 1) * sizeof(*bookings));
+    size_t *active = malloc((total ? total : 1) * sizeof(*active));
+    int ok = bookings != NULL && active != NULL;
+    for (size_t i = 0; ok && i < total; i++)
+    {
+        if (index.sorted[i].recordPos >= 0 && index.sorted[i].kind != BOOKING_SLOT)
+            bookings[live++] = index.sorted[i];
+    }
+    closeClashIndex(&index);
+    if (ok && total > sortedCount)
+        qsort(bookings, live, sizeof(*bookings), compareBookings);
+    size_t runStart = 0;
+    for (size_t i = 0; ok && i < live; i++)
+    {
+        struct Booking *b = &bookings[i];
+        size_t kept = 0;
+        int sameRun = i > 0 && b->resource == bookings[i - 1].resource;
+        for (size_t a = 0; sameRun && a < running; a++)
+        {
+            if (bookings[active[a]].end > b->start)
+                active[kept++] = active[a];
+        }
+        running = kept;
+        if (!sameRun)
+            runStart = i;
+        b->maxEnd = sameRun && bookings[i - 1].maxEnd > b->end ? bookings[i - 1].maxEnd : b->end;
+        if (isDatedBooking(b))
+        {
+            long long from = weeklyStart(b->start), to = from + b->end - b->start;
+            size_t lo = runStart, hi = i;
+            while (lo < hi)
             {
-                perror("Error seeking to end of student file before writing");
+                size_t mid = lo + (hi - lo) / 2;
+                if (bookings[mid].start < to)
+                    lo = mid + 1;
+                else
+                    hi = mid;
             }
-            else
+            for (size_t j = lo; ok && j-- > runStart && bookings[j].maxEnd > from;)
             {
-                fprintf(*P_ptr, "Student Name: %s %s\n", firstName, lastName);
-                fprintf(*P_ptr, "Father's name: %s\n", fatherName);
-                fprintf(*P_ptr, "Mother's name: %s\n", motherName);
-                fprintf(*P_ptr, "Student ID: %s\n", studentID);
-                fprintf(*P_ptr, "Department: %s\n", departmentName);
-                fprintf(*P_ptr, "Intake: %s\n", intake);
-                fprintf(*P_ptr, "Section: %s\n", section);
-                fprintf(*P_ptr, "Present Address: %s\n", presentAddress);
-                fprintf(*P_ptr, "Permanent Address: %s\n", permanentAddress);
-                fprintf(*P_ptr, "Blood Group: %s\n", bloodGroup);
-                fprintf(*P_ptr, "Mobile number: %s\n", mobileNumber);
-                fprintf(*P_ptr, "Backup Mobile Number: %s\n", backupMobileNumber);
-                fprintf(*P_ptr, "Email: %s\n\n", email); 
-
-                fflush(*P_ptr); 
-
-                if (ferror(*P_ptr))
-                {
-                    perror("Error writing student data");
-                    clearerr(*P_ptr);
-                }
-                else
-                {
-                    printf("\n---------- Congratulations! Student added successfully. ----------\n");
-                }
+                const struct Booking *weekly = &bookings[j];
+                if (!isDatedBooking(weekly) && bookingsOverlap(weekly, b) &&
+                    readScheduleAt(scheduleFile, (long)weekly->recordPos, &header, &first) > 0)
+                    ok = addScheduleClash(scheduleFile, &first, (long)weekly->recordPos, weekly, b, clashes, &count, &capacity);
             }
         }
-        printf("\n---------- Add another student to %s? ----------\n", departmentName);
-        printf("1. Yes\n2. No (Back to %s Menu)\n", departmentName);
-        printf("Enter Choice: ");
-        int addChoice;
-        if (scanf("%d", &addChoice) != 1)
+        for (size_t a = 0; ok && a < running; a++)
         {
-            addChoice = 2;     
-            clearInputBuffer(); 
+            const struct Booking *earlier = &bookings[active[a]];
+            if (earlier->recordPos != b->recordPos &&
+                readScheduleAt(scheduleFile, (long)earlier->recordPos, &header, &first) > 0)
+                ok = addScheduleClash(scheduleFile, &first, (long)earlier->recordPos, earlier, b, clashes, &count, &capacity);
         }
-        else
+        active[running++] = i;
+    }
+    if (bookings == NULL || active == NULL)
+        reportSystemError("Error allocating clash report");
+    free(bookings);
+    free(active);
+    if (!ok)
+    {
+        free(*clashes);
+        *clashes = NULL;
+        return -1;
+    }
+    return count;
+}
+
+// The stretches of the booking timeline day covers as [start, end) pairs: each weekday it names, or for a date,
+// that date's weekday and the date itself. A blank day covers the whole timeline. Returns the number of
+// stretches, at most eight, and 0 when day names neither a weekday nor a date.
+int timetableRanges(const char *day, long long ranges[][2])
+{
+    long long days;
+    int count = 0;
+    if (day == NULL || *day == '\0')
+    {
+        ranges[0][0] = 0;
+        ranges[0][1] = BOOKING_TIMELINE_END;
+        return 1;
+    }
+    if (parseExamDate(day, &days))
+    {
+        long long weekday = ((days + 4) % 7 + 7) % 7; // 1970-01-01 was a Thursday
+        ranges[0][0] = weekday * MINUTES_PER_DAY;
+        ranges[1][0] = (CLASH_DATED_BASE + days) * MINUTES_PER_DAY;
+        count = 2;
+    }
+    else
+    {
+        int mask = parseWeekdays(day);
+        for (int d = 0; d < 7; d++)
         {
-            clearInputBuffer();
+            if (mask & (1 << d))
+                ranges[count++][0] = (long long)d * MINUTES_PER_DAY;
         }
-
-        if (addChoice != 1)
-            addStudentLoop = 0;
     }
-    pressEnterToContinue(); 
+    for (int i = 0; i < count; i++)
+        ranges[i][1] = ranges[i][0] + MINUTES_PER_DAY;
+    return count;
 }
 
-void viewAllStudents(FILE **P_ptr, const char *departmentName)
+static int appendBooking(struct Booking **list, long *count, long *capacity, const struct Booking *booking)
 {
-    if (*P_ptr == NULL)
+    if (*count == *capacity)
     {
-        fprintf(stderr, "ERROR: Student file is not open in viewAllStudents.\n");
-        pressEnterToContinue();
-        return;
+        *capacity = *capacity ? *capacity * 2 : 64;
+        struct Booking *grown = realloc(*list, (size_t)*capacity * sizeof(**list));
+        if (grown == NULL)
+            return 0;
+        *list = grown;
     }
+    (*list)[(*count)++] = *booking;
+    return 1;
+}
 
-    system("clear || cls");
-    printf("\n\n------------------- Student List for Department: %s -------------------\n\n", departmentName);
+static int sameBookingName(int kind, const char *wanted, const struct AcademicSchedule *schedule)
+{
+    char folded[128], other[128];
+    if (wanted == NULL || *wanted == '\0')
+        return 1;
+    foldBookingName(kind, wanted, folded, sizeof(folded));
+    foldBookingName(kind, bookingName(schedule, kind), other, sizeof(other));
+    return strcmp(folded, other) == 0;
+}
 
-    rewind(*P_ptr); 
-    if (ferror(*P_ptr))
-    { 
-        perror("Error rewinding student file");
-        clearerr(*P_ptr);
-        pressEnterToContinue();
-        return;
-    }
-    int firstChar = fgetc(*P_ptr);
-    if (firstChar == EOF)
+// The routine entries in room, taught by faculty and falling on day (any of them may be NULL or blank), in time
+// order with one row per day an entry books. Reads the run of the room's, the faculty's or, for neither or a
+// shared name like "Online", every entry's bookings in schedules.clash, then only the records listed there.
+// Returns the count with a malloc'd array in *entries, or -1 on error.
+long fetchTimetable(FILE *scheduleFile, const char *room, const char *faculty, const char *day,
+                    struct TimetableEntry **entries)
+{
+    struct ClashIndex index;
+    struct ScheduleRecordHeader header;
+    struct Booking *found = NULL;
+    long long ranges[8][2];
+    char key[128];
+    long count = 0, capacity = 0, kept = 0;
+    *entries = NULL;
+    int rangeCount = timetableRanges(day, ranges);
+    int kind = room != NULL && foldBookingName(BOOKING_ROOM, room, key, sizeof(key))            ? BOOKING_ROOM
+               : faculty != NULL && foldBookingName(BOOKING_FACULTY, faculty, key, sizeof(key)) ? BOOKING_FACULTY
+                                                                                                 : BOOKING_SLOT;
+    if (kind == BOOKING_SLOT)
+        foldBookingName(BOOKING_SLOT, "", key, sizeof(key));
+    unsigned int resource = hashIndexKey(key);
+    if (!openClashIndex(&index, scheduleFile))
+        return -1;
+    const struct Booking *appended = index.sorted + index.header.slotCount;
+    int ok = 1;
+    for (int r = 0; ok && r < rangeCount; r++)
     {
-        if (ferror(*P_ptr))
+        for (long long j = lowerBooking(&index, resource, ranges[r][0]);
+             ok && j < index.header.slotCount && index.sorted[j].resource == resource && index.sorted[j].start < ranges[r][1]; j++)
         {
-            perror("Error checking if student file is empty");
+            if (index.sorted[j].recordPos >= 0 && index.sorted[j].kind == kind)
+                ok = appendBooking(&found, &count, &capacity, &index.sorted[j]);
         }
-        else
+        for (unsigned int k = 0; ok && k < index.header.usedCount; k++)
         {
-            printf("\nNo students added yet!\n");
+            const struct Booking *b = &appended[k];
+            if (b->recordPos >= 0 && b->resource == resource && b->kind == kind && b->start >= ranges[r][0] &&
+                b->start < ranges[r][1])
+                ok = appendBooking(&found, &count, &capacity, b);
         }
-        clearerr(*P_ptr);
     }
-    else
+    closeClashIndex(&index);
+    if (ok && count > 0)
+    {
+        qsort(found, (size_t)count, sizeof(*found), compareBookings);
+        *entries = malloc((size_t)count * sizeof(**entries));
+        ok = *entries != NULL;
+    }
+    for (long i = 0; ok && i < count; i++)
+    {
+        struct TimetableEntry *entry = &(*entries)[kept];
+        if (readScheduleAt(scheduleFile, (long)found[i].recordPos, &header, &entry->schedule) <= 0 ||
+            !sameBookingName(BOOKING_ROOM, room, &entry->schedule) ||
+            !sameBookingName(BOOKING_FACULTY, faculty, &entry->schedule))
+            continue;
+        entry->start = found[i].start;
+        entry->end = found[i].end;
+        entry->recordPos = (long)found[i].recordPos;
+        kept++;
+    }
+    free(found);
+    if (!ok)
     {
-        ungetc(firstChar, *P_ptr); 
+        reportSystemError("Error allocating timetable");
+        free(*entries);
+        *entries = NULL;
+        return -1;
+    }
+    return kept;
+}
 
-        printf("%-25s %-15s %-15s %-10s %-10s\n", "Student Name", "Student ID", "Mobile Number", "Intake", "Section");
-        printf("------------------------------------------------------------------------------\n");
-        char name1[100] = "", name2[100] = "", studentID[100] = "", mobileNumber[100] = "";
-        char currentDept[100] = "", intake[100] = "", section[100] = "";
-        char line[512]; 
-        char fullName[201] = "";
-        int recordsFound = 0;
-        int readingRecord = 0; 
-        fullName[0] = '\0';
-        studentID[0] = '\0';
-        mobileNumber[0] = '\0';
-        currentDept[0] = '\0';
-        intake[0] = '\0';
-        section[0] = '\0';
-        name1[0] = '\0';
-        name2[0] = '\0';
-
-        while (fgets(line, sizeof(line), *P_ptr))
-        {
-            char trimmedLine[512];
-            strcpy(trimmedLine, line);
-            trimWhitespace(trimmedLine);
-
-            if (strlen(trimmedLine) == 0)
-            { 
-                if (readingRecord)
-                {
-                    if (strcmp(currentDept, departmentName) == 0)
-                    {
-                        printf("%-25s %-15s %-15s %-10s %-10s\n", fullName, studentID, mobileNumber, intake, section);
-                        recordsFound = 1;
-                    }
-                    readingRecord = 0;
-                    fullName[0] = '\0';
-                    studentID[0] = '\0';
-                    mobileNumber[0] = '\0';
-                    currentDept[0] = '\0';
-                    intake[0] = '\0';
-                    section[0] = '\0';
-                    name1[0] = '\0';
-                    name2[0] = '\0';
-                }
-                continue; 
-            }
-            readingRecord = 1; 
-            char temp_s1[100], temp_s2[100];
-            if (sscanf(trimmedLine, "Student Name: %99s %99s", temp_s1, temp_s2) == 2)
-            {
-                strcpy(name1, temp_s1);
-                strcpy(name2, temp_s2);
-                snprintf(fullName, sizeof(fullName), "%s %s", name1, name2);
-            }
-            else if (sscanf(trimmedLine, "Student ID: %99s", temp_s1) == 1)
-            {
-                strcpy(studentID, temp_s1);
-            }
-            else if (sscanf(trimmedLine, "Department: %99s", temp_s1) == 1)
-            {
-                strcpy(currentDept, temp_s1);
-            }
-            else if (sscanf(trimmedLine, "Mobile number: %99s", temp_s1) == 1)
-            {
-                strcpy(mobileNumber, temp_s1);
-            }
-            else if (sscanf(trimmedLine, "Intake: %99s", temp_s1) == 1)
-            {
-                strcpy(intake, temp_s1);
-            }
-            else if (sscanf(trimmedLine, "Section: %99s", temp_s1) == 1)
-            {
-                strcpy(section, temp_s1);
-            }
-        }
-        if (readingRecord && strcmp(currentDept, departmentName) == 0)
+static int compareFacultyLoads(const void *a, const void *b)
+{
+    const struct FacultyLoad *x = a, *y = b;
+    if (x->minutes != y->minutes)
+        return x->minutes > y->minutes ? -1 : 1;
+    return strcmp(x->faculty, y->faculty);
+}
+
+// Weekly teaching minutes and classes per faculty, or just for faculty when it is given, busiest first. The
+// totals come from the weekly faculty bookings in schedules.clash; only one record per faculty is read, for its
+// name. Returns the count with a malloc'd array in *loads, or -1 on error.
+long collectFacultyLoad(FILE *scheduleFile, const char *faculty, struct FacultyLoad **loads)
+{
+    struct ClashIndex index;
+    struct ScheduleRecordHeader header;
+    struct AcademicSchedule schedule;
+    char key[128];
+    long count = 0;
+    *loads = NULL;
+    int one = faculty != NULL && *faculty != '\0';
+    if (one && !foldBookingName(BOOKING_FACULTY, faculty, key, sizeof(key)))
+        return 0;
+    unsigned int resource = one ? hashIndexKey(key) : 0;
+    if (!openClashIndex(&index, scheduleFile))
+        return -1;
+    size_t sortedCount = index.header.slotCount, total = sortedCount + index.header.usedCount, live = 0;
+    struct Booking *bookings = malloc((total ? total : 1) * sizeof(*bookings));
+    int ok = bookings != NULL;
+    for (size_t i = one ? (size_t)lowerBooking(&index, resource, 0) : 0; ok && i < total; i++)
+    {
+        const struct Booking *b = &index.sorted[i];
+        if (one && i < sortedCount && b->resource != resource)
         {
-            printf("%-25s %-15s %-15s %-10s %-10s\n", fullName, studentID, mobileNumber, intake, section);
-            recordsFound = 1;
+            i = sortedCount - 1; // the rest of the sorted part belongs to others
+            continue;
         }
-
-        if (!recordsFound)
+        if (b->recordPos >= 0 && b->kind == BOOKING_FACULTY && b->start < 7 * MINUTES_PER_DAY &&
+            (!one || b->resource == resource))
+            bookings[live++] = *b;
+    }
+    closeClashIndex(&index);
+    if (ok && total > sortedCount)
+        qsort(bookings, live, sizeof(*bookings), compareBookings);
+    size_t runs = 0;
+    for (size_t i = 0; ok && i < live; i++)
+        runs += i == 0 || bookings[i].resource != bookings[i - 1].resource;
+    *loads = ok ? malloc((runs ? runs : 1) * sizeof(**loads)) : NULL;
+    ok = *loads != NULL;
+    for (size_t i = 0; ok && i < live; i++)
+    {
+        // Faculty whose names share a hash are counted together; the name shown is the first one's.
+        if (i == 0 || bookings[i].resource != bookings[i - 1].resource)
         {
-            printf("\nNo students found in the %s department.\n", departmentName);
+            int named = readScheduleAt(scheduleFile, (long)bookings[i].recordPos, &header, &schedule) > 0 &&
+                        (!one || sameBookingName(BOOKING_FACULTY, faculty, &schedule));
+            if (!named)
+            {
+                while (i + 1 < live && bookings[i + 1].resource == bookings[i].resource)
+                    i++;
+                continue;
+            }
+            struct FacultyLoad *load = &(*loads)[count++];
+            snprintf(load->faculty, sizeof(load->faculty), "%s", schedule.routineData.faculty);
+            load->minutes = 0;
+            load->classes = 0;
         }
-        printf("------------------------------------------------------------------------------\n");
+        (*loads)[count - 1].minutes += bookings[i].end - bookings[i].start;
+        (*loads)[count - 1].classes++;
+    }
+    if (!ok)
+        reportSystemError("Error allocating faculty load");
+    free(bookings);
+    if (!ok)
+    {
+        free(*loads);
+        *loads = NULL;
+        return -1;
     }
+    qsort(*loads, (size_t)count, sizeof(**loads), compareFacultyLoads);
+    return count;
+}
 
-    clearerr(*P_ptr); 
-    pressEnterToContinue();
+// Writes schedule into a hole or at the end and files it in the schedule index. Returns its offset, or -1 on error.
+long insertScheduleRecord(FILE *scheduleFile, const struct AcademicSchedule *schedule)
+{
+    char key[ROSTER_KEY_SIZE];
+    struct RosterIndex index;
+    struct ClashIndex clashes;
+    int indexed = makeScheduleKey(key, schedule->intake, schedule->section, schedule->scheduleType) &&
+                  openScheduleIndex(&index, scheduleFile);
+    int booked = openClashIndex(&clashes, scheduleFile);
+    long pos = placeScheduleRecord(scheduleFile, schedule);
+    if (indexed)
+        settleScheduleIndex(&index, pos >= 0 && rosterIndexAdd(&index, key, pos), scheduleFile);
+    if (booked)
+        settleClashIndex(&clashes, pos >= 0 && clashIndexAdd(&clashes, schedule, pos), scheduleFile);
+    return pos;
 }
 
-void searchStudentById(FILE **P_ptr, const char *departmentName)
+// Rewrites the entry at recordPos, whose intake, section and type never change; the index is only touched when
+// the entry outgrew its record and moved. Returns the entry's offset afterwards, or -1 on error.
+long updateScheduleRecord(FILE *scheduleFile, long recordPos, const struct AcademicSchedule *schedule)
 {
-    if (*P_ptr == NULL)
+    char key[ROSTER_KEY_SIZE];
+    struct RosterIndex index;
+    struct ClashIndex clashes;
+    struct ScheduleRecordHeader header;
+    struct AcademicSchedule previous;
+    int indexed = makeScheduleKey(key, schedule->intake, schedule->section, schedule->scheduleType) &&
+                  openScheduleIndex(&index, scheduleFile);
+    int booked = readScheduleAt(scheduleFile, recordPos, &header, &previous) > 0 && openClashIndex(&clashes, scheduleFile);
+    long pos = rewriteScheduleRecord(scheduleFile, recordPos, schedule);
+    if (indexed)
     {
-        fprintf(stderr, "ERROR: Student file is not open in searchStudentById.\n");
-        pressEnterToContinue();
-        return;
+        int patched = pos < 0 ? 0
+                      : pos == recordPos ? stampRosterIndex(&index)
+                                         : rosterIndexRemove(&index, key, recordPos) && rosterIndexAdd(&index, key, pos);
+        settleScheduleIndex(&index, patched, scheduleFile);
+    }
+    if (booked)
+    {
+        int patched = pos >= 0 && clashIndexRemove(&clashes, &previous, recordPos) && clashIndexAdd(&clashes, schedule, pos);
+        settleClashIndex(&clashes, patched, scheduleFile);
     }
+    return pos;
+}
 
-    int searchAgain = 1;
-    while (searchAgain)
+// Deletes every entry filed under key's intake, section and type. Returns 1 if any were deleted, 0 if none
+// matched, -1 on error.
+int deleteScheduleRecords(FILE *scheduleFile, const struct AcademicSchedule *key)
+{
+    char indexKey[ROSTER_KEY_SIZE];
+    struct AcademicSchedule *schedules;
+    struct RosterIndex index;
+    long *positions;
+    struct ClashIndex clashes;
+    long count = fetchScheduleRecords(scheduleFile, key, 1, &schedules, &positions);
+    if (count <= 0)
+        return (int)count;
+    int indexed = makeScheduleKey(indexKey, key->intake, key->section, key->scheduleType) &&
+                  openScheduleIndex(&index, scheduleFile);
+    int booked = openClashIndex(&clashes, scheduleFile);
+    int ok = freeScheduleRecords(scheduleFile, positions, count);
+    if (indexed)
     {
-        system("clear || cls");
-        printf("\n--- Search Student by ID in %s ---\n", departmentName);
-        printf("Enter Student ID to search: ");
-        char searchID[100];
-        if (!fgets(searchID, sizeof(searchID), stdin))
+        int patched = ok;
+        for (long i = 0; patched && i < count; i++)
+            patched = rosterIndexRemove(&index, indexKey, positions[i]);
+        settleScheduleIndex(&index, patched, scheduleFile);
+    }
+    if (booked)
+    {
+        int patched = ok;
+        for (long i = 0; patched && i < count; i++)
+            patched = clashIndexRemove(&clashes, &schedules[i], positions[i]);
+        settleClashIndex(&clashes, patched, scheduleFile);
+    }
+    free(schedules);
+    free(positions);
+    return ok ? 1 : -1;
+}
+
+static int copyCsvField(char *dest, size_t destSize, const char *value)
+{
+    size_t len = strlen(value);
+    if (len == 0 || len >= destSize)
+        return 0;
+    memcpy(dest, value, len + 1);
+    return 1;
+}
+
+// Grades a batch of parsed rows, then writes it: rows aimed at records already in the file are rewritten in
+// place, and new records (numbered from firstNew up) go out in one fwrite.
+static int flushResultBatch(FILE *resultFile, struct StudentResult *rows, const long long *targets, int rowCount,
+                            long long firstNew, struct StudentResult *appends, int *appendCount)
+{
+    int ok = 1;
+    for (int i = 0; i < rowCount; i++)
+        calculateGrade(rows[i].gpa, rows[i].grade);
+    for (int i = 0; i < rowCount && ok; i++)
+    {
+        if (targets[i] >= firstNew)
         {
-            printf("Input error!\n");
+            appends[targets[i] - firstNew] = rows[i];
             continue;
         }
-        trimWhitespace(searchID);
+        ok = seekData(resultFile, (long)(targets[i] * (long long)sizeof(struct StudentResult)), SEEK_SET) == 0 &&
+             fwrite(&rows[i], sizeof(struct StudentResult), 1, resultFile) == 1;
+    }
+    if (ok && *appendCount > 0)
+        ok = seekData(resultFile, 0, SEEK_END) == 0 &&
+             fwrite(appends, sizeof(struct StudentResult), (size_t)*appendCount, resultFile) == (size_t)*appendCount;
+    *appendCount = 0;
+    return ok;
+}
 
-        if (strlen(searchID) == 0)
-        {
-            printf("Search ID cannot be empty.\n");
-            pressEnterToContinue();
+// Loads a results CSV with id, name, intake, section and gpa columns (any order, named in the header row).
+// A row whose (id, intake, section) is already in results.dat, or earlier in the file, is rejected unless
+// upsert is set, in which case it replaces that result. Rejected rows go to rejects with their line number.
+// Returns 0 if the file as a whole could not be imported.
+int importResultCsv(FILE *resultFile, const char *csvPath, int upsert, FILE *rejects, long *added, long *updated,
+                    long *rejected)
+{
+    static const char *const columnNames[] = {"id", "name", "intake", "section", "gpa", NULL};
+    struct StudentMap csvMap, resultMap;
+    struct IndexTable seen;
+    char scratch[RESULT_CSV_LINE_SIZE];
+    char key[INDEX_KEY_SIZE];
+    char *fields[RESULT_CSV_COLUMNS + 1];
+    int columnField[RESULT_CSV_COLUMNS + 1];
+    long line = 0;
+
+    *added = 0;
+    *updated = 0;
+    *rejected = 0;
+    FILE *csv = fopen(csvPath, "rb");
+    if (csv == NULL)
+    {
+        reportSystemError("Error opening result CSV file");
+        return 0;
+    }
+    int ok = mapStudentFile(csv, &csvMap, POSIX_MADV_SEQUENTIAL);
+    fclose(csv);
+    if (!ok)
+        return 0;
+    if (fflush(resultFile) != 0 || !mapStudentFile(resultFile, &resultMap, POSIX_MADV_SEQUENTIAL))
+    {
+        unmapStudentFile(&csvMap);
+        return 0;
+    }
+
+    // Every (id, intake, section) already published, mapped to its record number.
+    const struct StudentResult *existing = (const struct StudentResult *)resultMap.data;
+    long long fileRecords = (long long)(resultMap.length / sizeof(struct StudentResult));
+    hotPath.recordsScanned += fileRecords;
+    ok = initIndexTable(&seen, RESULT_INDEX_MAGIC, (unsigned int)(fileRecords + csvMap.length / 32));
+    for (long long i = 0; ok && i < fileRecords; i++)
+    {
+        if (FIXED_RECORD_DEAD(&existing[i]))
             continue;
-        }
+        snprintf(key, sizeof(key), "%s|%s|%s", existing[i].studentID, existing[i].intake, existing[i].section);
+        ok = indexTablePut(&seen, key, i, (long long)sizeof(struct StudentResult), 0) >= 0;
+    }
+    unmapStudentFile(&resultMap);
 
-        rewind(*P_ptr);
-        if (ferror(*P_ptr))
+    size_t pos = 0;
+    int columns = 0, present = 0;
+    while (ok && pos < csvMap.length && columns == 0)
+    {
+        int n = readCsvRecord(csvMap.data, csvMap.length, &pos, scratch, sizeof(scratch), fields, RESULT_CSV_COLUMNS + 1, &line);
+        if (n == 1 && fields[0][0] == '\0')
+            continue;
+        if (n < 0)
         {
-            perror("Error rewinding student file for search");
-            clearerr(*P_ptr);
-            pressEnterToContinue();
-            return; 
+            reportError("Error: Malformed CSV header on line %ld.\n", line);
+            ok = 0;
         }
-
-        int found = 0;
-        char line[512];
-        char name1[100] = "", name2[100] = "", father[100] = "", mother[100] = "";
-        char currentID[100] = "", currentDept[100] = "", intake[100] = "", section[100] = "";
-        char presentAddr[200] = "", permanentAddr[200] = "", blood[20] = "";
-        char mobile[20] = "", backupMobile[20] = "", email[100] = "";
-        char fullName[201] = "";
-        char temp_id[100], temp_dept[100];
-        int readingRecord = 0;       
-        char recordBuffer[2048] = ""; 
-        recordBuffer[0] = '\0';
-        readingRecord = 0;
-        temp_id[0] = '\0';
-        temp_dept[0] = '\0'; 
-        while (fgets(line, sizeof(line), *P_ptr))
-        {
-            char trimmedLine[512];
-            strcpy(trimmedLine, line);
-            trimWhitespace(trimmedLine);
-
-            if (strlen(trimmedLine) == 0)
-            { 
-                if (readingRecord)
-                {
-                    if (strcmp(temp_id, searchID) == 0 && strcmp(temp_dept, departmentName) == 0)
-                    {
-                        found = 1;
-                        char *linePtr = recordBuffer;
-                        char blockLine[512];
-                        name1[0] = '\0';
-                        name2[0] = '\0';
-                        father[0] = '\0';
-                        mother[0] = '\0';
-                        strcpy(currentID, temp_id);
-                        strcpy(currentDept, temp_dept); 
-                        intake[0] = '\0';
-                        section[0] = '\0';
-                        presentAddr[0] = '\0';
-                        permanentAddr[0] = '\0';
-                        blood[0] = '\0';
-                        mobile[0] = '\0';
-                        backupMobile[0] = '\0';
-                        email[0] = '\0';
-
-                        while (sscanf(linePtr, "%511[^\n]", blockLine) == 1)
-                        { 
-                            char *nextNewline = strchr(linePtr, '\n';
-                            char temp_s1[200], temp_s2[100]; 
-                            if (sscanf(blockLine, "Student Name: %99s %99s", temp_s1, temp_s2) == 2)
-                            {
-                                strcpy(name1, temp_s1);
-                                strcpy(name2, temp_s2);
-                            }
-                            else if (sscanf(blockLine, "Father's name: %99[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(father, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Mother's name: %99[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(mother, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Intake: %99s", temp_s1) == 1)
-                            {
-                                strcpy(intake, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Section: %99s", temp_s1) == 1)
-                            {
-                                strcpy(section, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Present Address: %199[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(presentAddr, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Permanent Address: %199[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(permanentAddr, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Blood Group: %19[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(blood, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Mobile number: %19s", temp_s1) == 1)
-                            {
-                                strcpy(mobile, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Backup Mobile Number: %19s", temp_s1) == 1)
-                            {
-                                strcpy(backupMobile, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Email: %99[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(email, temp_s1);
-                            }
-                            if (!nextNewline)
-                                break; 
-                            linePtr = nextNewline + 1;
-                            if (*linePtr == '\0')
-                              break; 
-                        }
-                        break; 
-                    }
-                    readingRecord = 0;
-                    recordBuffer[0] = '\0';
-                    temp_id[0] = '\0';
-                    temp_dept[0] = '\0';
-                }
-                continue; 
-            }
-            readingRecord = 1;
-            if (strlen(recordBuffer) + strlen(line) < sizeof(recordBuffer))
-            {
-                strcat(recordBuffer, line);
-            }
-            else
-            {
-                fprintf(stderr, "Warning: Record buffer overflow near potential ID %s\n", temp_id);
-            }
-            char temp_s1[100];
-            if (sscanf(trimmedLine, "Student ID: %99s", temp_s1) == 1)
+        for (int c = 0; ok && c < n; c++)
+        {
+            columnField[c] = -1;
+            for (int f = 0; columnNames[f] != NULL; f++)
             {
-                strcpy(temp_id, temp_s1); 
+                if (strcmp(fields[c], columnNames[f]) == 0 && !(present & (1 << f)))
+                    columnField[c] = f;
             }
-            if (sscanf(trimmedLine, "Department: %99s", temp_s1) == 1)
+            if (columnField[c] < 0)
             {
-                strcpy(temp_dept, temp_s1); 
+                reportError("Error: Unknown or repeated CSV column '%s' on line %ld.\n", fields[c], line);
+                ok = 0;
             }
+            else
+                present |= 1 << columnField[c];
         }
-        if (readingRecord && !found)
+        if (ok && present != (1 << RESULT_CSV_COLUMNS) - 1)
         {
-            if (strcmp(temp_id, searchID) == 0 && strcmp(temp_dept, departmentName) == 0)
-            {
-                found = 1;
+            reportError("Error: CSV header needs the id, name, intake, section and gpa columns.\n");
+            ok = 0;
+        }
+        columns = n;
+    }
 
-                char *linePtr = recordBuffer;
-                char blockLine[512];
-                name1[0] = '\0';
-                name2[0] = '\0';
-                father[0] = '\0';
-                mother[0] = '\0';
-                strcpy(currentID, temp_id);
-                strcpy(currentDept, temp_dept);
-                intake[0] = '\0';
-                section[0] = '\0';
-                presentAddr[0] = '\0';
-                permanentAddr[0] = '\0';
-                blood[0] = '\0';
-                mobile[0] = '\0';
-                backupMobile[0] = '\0';
-                email[0] = '\0';
-                while (sscanf(linePtr, "%511[^\n]", blockLine) == 1)
-                {
-                    char *nextNewline = strchr(linePtr, '\n');
-                    char temp_s1[200], temp_s2[100];
-                    if (sscanf(blockLine, "Student Name: %99s %99s", temp_s1, temp_s2) == 2)
-                    {
-                        strcpy(name1, temp_s1);
-                        strcpy(name2, temp_s2);
-                    }
-                    else if (sscanf(blockLine, "Father's name: %99[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(father, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Mother's name: %99[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(mother, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Intake: %99s", temp_s1) == 1)
-                    {
-                        strcpy(intake, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Section: %99s", temp_s1) == 1)
-                    {
-                        strcpy(section, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Present Address: %199[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(presentAddr, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Permanent Address: %199[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(permanentAddr, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Blood Group: %19[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(blood, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Mobile number: %19s", temp_s1) == 1)
-                    {
-                        strcpy(mobile, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Backup Mobile Number: %19s", temp_s1) == 1)
-                    {
-                        strcpy(backupMobile, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Email: %99[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(email, temp_s1);
-                    }
-                    if (!nextNewline)
-                        break;
-                    linePtr = nextNewline + 1;
-                    if (*linePtr == '\0')
-                        break;
-                }
-            }
+    struct StudentResult *rows = NULL, *appends = NULL;
+    long long *targets = NULL;
+    if (ok)
+    {
+        rows = malloc(RESULT_IMPORT_BATCH * sizeof(struct StudentResult));
+        appends = malloc(RESULT_IMPORT_BATCH * sizeof(struct StudentResult));
+        targets = malloc(RESULT_IMPORT_BATCH * sizeof(long long));
+        ok = rows != NULL && appends != NULL && targets != NULL;
+        if (!ok)
+            reportSystemError("Error allocating import buffers");
+    }
+    long long originalSize = -1;
+    ok = ok && seekData(resultFile, 0, SEEK_END) == 0 && (originalSize = ftell(resultFile)) >= 0;
+    long long firstNew = fileRecords;
+    int rowCount = 0, appendCount = 0;
+    while (ok && pos < csvMap.length)
+    {
+        const char *values[RESULT_CSV_COLUMNS];
+        struct StudentResult *result = &rows[rowCount];
+        char *end;
+        int n = readCsvRecord(csvMap.data, csvMap.length, &pos, scratch, sizeof(scratch), fields, RESULT_CSV_COLUMNS + 1, &line);
+        if (n == 1 && fields[0][0] == '\0')
+            continue;
+        if (n < 0)
+        {
+            rejectImportRow(rejects, line, "malformed or oversized CSV row", rejected);
+            continue;
+        }
+        if (n != columns)
+        {
+            rejectImportRow(rejects, line, "wrong number of fields", rejected);
+            continue;
         }
-
-        if (found)
+        for (int c = 0; c < n; c++)
+            values[columnField[c]] = fields[c];
+        memset(result, 0, sizeof(*result));
+        if (!copyCsvField(result->studentID, sizeof(result->studentID), values[0]) ||
+            !copyCsvField(result->name, sizeof(result->name), values[1]) ||
+            !copyCsvField(result->intake, sizeof(result->intake), values[2]) ||
+            !copyCsvField(result->section, sizeof(result->section), values[3]))
         {
-            system("clear || cls");
-            snprintf(fullName, sizeof(fullName), "%s %s", name1, name2); 
-            printf("\n------------------- Student Details Found -------------------\n");
-            printf("Name: %s\n", fullName);
-            printf("Father's Name: %s\n", father);
-            printf("Mother's Name: %s\n", mother);
-            printf("Student ID: %s\n", currentID);
-            printf("Department: %s\n", currentDept);
-            printf("Intake: %s\n", intake);
-            printf("Section: %s\n", section);
-            printf("Present Address: %s\n", presentAddr);
-            printf("Permanent Address: %s\n", permanentAddr);
-            printf("Blood Group: %s\n", blood);
-            printf("Mobile Number: %s\n", mobile);
-            printf("Backup Mobile: %s\n", backupMobile);
-            printf("Email: %s\n", email);
-            printf("-------------------------------------------------------------\n");
+            rejectImportRow(rejects, line, "id, name, intake and section must be present and not too long", rejected);
+            continue;
         }
-        else
+        double gpa = strtod(values[4], &end);
+        if (end == values[4] || *end != '\0' || gpa < 0.0 || gpa > 4.0)
         {
-            system("clear || cls");
-            printf("\nStudent with ID '%s' not found in the %s department.\n", searchID, departmentName);
+            rejectImportRow(rejects, line, "gpa must be a number from 0.0 to 4.0", rejected);
+            continue;
         }
+        result->gpa = (float)gpa;
 
-        clearerr(*P_ptr);
-        printf("\nOptions:\n1. Search Another Student by ID\n2. Back to %s Menu\n", departmentName);
-        printf("Enter your choice: ");
-        int choice;
-        if (scanf("%d", &choice) != 1)
+        snprintf(key, sizeof(key), "%s|%s|%s", result->studentID, result->intake, result->section);
+        struct IndexSlot *slot = indexTableFind(&seen, key);
+        if (slot != NULL && !upsert)
         {
-            choice = 2;
-            clearInputBuffer();
+            rejectImportRow(rejects, line, "result already exists", rejected);
+            continue;
+        }
+        if (slot != NULL)
+        {
+            targets[rowCount] = slot->offset;
+            (*updated)++;
         }
         else
         {
-            clearInputBuffer();
+            targets[rowCount] = firstNew + appendCount++;
+            ok = indexTablePut(&seen, key, targets[rowCount], (long long)sizeof(struct StudentResult), 0) > 0;
+            (*added)++;
         }
-        if (choice != 1)
-            searchAgain = 0;
+        if (++rowCount == RESULT_IMPORT_BATCH)
+        {
+            long long batchFirst = firstNew;
+            firstNew += appendCount;
+            ok = ok && flushResultBatch(resultFile, rows, targets, rowCount, batchFirst, appends, &appendCount);
+            rowCount = 0;
+        }
+    }
+    if (ok && rowCount > 0)
+        ok = flushResultBatch(resultFile, rows, targets, rowCount, firstNew, appends, &appendCount);
+    ok = ok && fflush(resultFile) == 0;
+    if (!ok && originalSize >= 0)
+    {
+        // Appended results are dropped; in-place updates already written are harmless to repeat with upsert.
+        reportSystemError("Error writing imported results");
+        clearerr(resultFile);
+        fflush(resultFile);
+        if (ftruncate(fileno(resultFile), (off_t)originalSize) != 0)
+            reportSystemError("Error rolling back partial import");
+        *added = 0;
+    }
+    // seen now maps every key in the file to its first record, which is exactly the result index. A bulk
+    // load recounts the statistics in one pass rather than patching them row by row.
+    if (ok && (*added > 0 || *updated > 0))
+    {
+        saveIndexTable(&seen, RESULT_INDEX_FILE, "results.dat");
+        rebuildResultStats(resultFile);
     }
+    free(rows);
+    free(appends);
+    free(targets);
+    freeIndexTable(&seen);
+    unmapStudentFile(&csvMap);
+    return ok;
 }
 
-void searchStudentByName(FILE **P_ptr, const char *departmentName)
+// Orders student IDs numerically when both are digit strings, so "999" ranks ahead of "1000".
+static int compareStudentIds(const char *a, const char *b)
 {
-    if (*P_ptr == NULL)
+    size_t lenA = strlen(a), lenB = strlen(b);
+    if (lenA != lenB && strspn(a, "0123456789") == lenA && strspn(b, "0123456789") == lenB)
+        return lenA < lenB ? -1 : 1;
+    return strcmp(a, b);
+}
+
+// Negative when a comes before b on the merit list: higher GPA first, then lower ID.
+static int compareMerit(const struct StudentResult *a, const struct StudentResult *b)
+{
+    if (a->gpa != b->gpa)
+        return a->gpa > b->gpa ? -1 : 1;
+    return compareStudentIds(a->studentID, b->studentID);
+}
+
+static int compareMeritPointers(const void *a, const void *b)
+{
+    return compareMerit(*(const struct StudentResult *const *)a, *(const struct StudentResult *const *)b);
+}
+
+// Min-heap on merit: heap[0] is the weakest result kept so far.
+static void siftMeritHeap(const struct StudentResult **heap, long count, long i)
+{
+    while (1)
     {
-        fprintf(stderr, "ERROR: Student file is not open in searchStudentByName.\n");
-        pressEnterToContinue();
-        return;
+        long weakest = i, left = 2 * i + 1, right = left + 1;
+        if (left < count && compareMerit(heap[left], heap[weakest]) > 0)
+            weakest = left;
+        if (right < count && compareMerit(heap[right], heap[weakest]) > 0)
+            weakest = right;
+        if (weakest == i)
+            return;
+        const struct StudentResult *swap = heap[i];
+        heap[i] = heap[weakest];
+        heap[weakest] = swap;
+        i = weakest;
     }
+}
 
-    int searchAgain = 1;
-    while (searchAgain)
+// Builds the merit list for an intake, limited to one section unless section is NULL. With topK > 0 only
+// the best topK are kept, in a bounded heap, so a large intake is never fully sorted. Equal GPAs share a
+// rank and the next rank skips accordingly (1, 2, 2, 4). Returns the number of entries in *ranked, which
+// the caller frees, or -1 on error.
+long rankResults(FILE *resultFile, const char *intake, const char *section, long topK, struct RankedResult **ranked)
+{
+    struct StudentMap map;
+    *ranked = NULL;
+    if (fflush(resultFile) != 0 || !mapStudentFile(resultFile, &map, POSIX_MADV_SEQUENTIAL))
+        return -1;
+    const struct StudentResult *results = (const struct StudentResult *)map.data;
+    long count = (long)(map.length / sizeof(struct StudentResult));
+    hotPath.recordsScanned += count;
+
+    long capacity = topK > 0 && topK < count ? topK : count;
+    const struct StudentResult **kept = malloc((size_t)(capacity > 0 ? capacity : 1) * sizeof(*kept));
+    if (kept == NULL)
     {
-        system("clear || cls");
-        printf("\n--- Search Student by Name in %s ---\n", departmentName);
-        printf("Enter Student Name (or part of it): ");
-        char searchName[201];
-        if (!fgets(searchName, sizeof(searchName), stdin))
-        {
-            printf("Input error!\n");
+        reportSystemError("Error allocating merit list");
+        unmapStudentFile(&map);
+        return -1;
+    }
+    long keptCount = 0;
+    for (long i = 0; i < count; i++)
+    {
+        const struct StudentResult *r = &results[i];
+        if (FIXED_RECORD_DEAD(r) || strcmp(r->intake, intake) != 0 ||
+            (section != NULL && strcmp(r->section, section) != 0))
             continue;
+        if (keptCount < capacity)
+        {
+            kept[keptCount++] = r;
+            if (keptCount == capacity && capacity < count)
+            {
+                for (long j = keptCount / 2 - 1; j >= 0; j--)
+                    siftMeritHeap(kept, keptCount, j);
+            }
         }
-        trimWhitespace(searchName);
-
-        if (strlen(searchName) == 0)
+        else if (compareMerit(r, kept[0]) < 0)
         {
-            printf("Search name cannot be empty.\n");
-            pressEnterToContinue();
-            continue;
+            kept[0] = r;
+            siftMeritHeap(kept, keptCount, 0);
         }
+    }
+    qsort(kept, (size_t)keptCount, sizeof(*kept), compareMeritPointers);
 
-        rewind(*P_ptr);
-        if (ferror(*P_ptr))
-        {
-            perror("Error rewinding student file for search");
-            clearerr(*P_ptr);
-            pressEnterToContinue();
-            return;
+    *ranked = malloc((size_t)(keptCount > 0 ? keptCount : 1) * sizeof(struct RankedResult));
+    if (*ranked == NULL)
+    {
+        reportSystemError("Error allocating merit list");
+        keptCount = -1;
+    }
+    for (long i = 0; i < keptCount; i++)
+    {
+        (*ranked)[i].result = *kept[i];
+        (*ranked)[i].rank = i > 0 && kept[i]->gpa == kept[i - 1]->gpa ? (*ranked)[i - 1].rank : i + 1;
+    }
+    free(kept);
+    unmapStudentFile(&map);
+    return keptCount;
+}
+
+int makeResultKey(char *key, const struct StudentResult *result)
+{
+    return snprintf(key, INDEX_KEY_SIZE, "%s|%s|%s", result->studentID, result->intake, result->section) < INDEX_KEY_SIZE;
+}
+
+// Result index entries hold record numbers in results.dat. When a key occurs more than once, the first
+// record is indexed, which is the one a scan would find.
+int rebuildResultIndex(FILE *resultFile)
+{
+    struct StudentMap map;
+    struct IndexTable table;
+    char key[INDEX_KEY_SIZE];
+    long indexed = 0, duplicates = 0;
+
+    if (fflush(resultFile) != 0 || !mapStudentFile(resultFile, &map, POSIX_MADV_SEQUENTIAL))
+        return 0;
+    const struct StudentResult *results = (const struct StudentResult *)map.data;
+    long long count = (long long)(map.length / sizeof(struct StudentResult));
+    hotPath.recordsScanned += count;
+    int ok = initIndexTable(&table, RESULT_INDEX_MAGIC, (unsigned int)count);
+    for (long long i = 0; ok && i < count; i++)
+    {
+        if (FIXED_RECORD_DEAD(&results[i]) || !makeResultKey(key, &results[i]))
+            continue;
+        int added = indexTablePut(&table, key, i, (long long)sizeof(struct StudentResult), 0);
+        ok = added >= 0;
+        indexed += added > 0;
+        duplicates += added == 0;
+    }
+    unmapStudentFile(&map);
+    ok = ok && saveIndexTable(&table, RESULT_INDEX_FILE, "results.dat");
+    freeIndexTable(&table);
+    if (ok)
+    {
+        notice("Result index rebuilt: %ld results indexed.\n", indexed);
+        if (duplicates > 0)
+            notice("Warning: %ld duplicate results skipped; the first occurrence of each is indexed.\n", duplicates);
+    }
+    return ok;
+}
+
+int openResultIndex(struct DiskIndex *index, FILE *resultFile)
+{
+    fflush(resultFile);
+    if (openDiskIndex(index, RESULT_INDEX_FILE, RESULT_INDEX_MAGIC, "results.dat"))
+        return 1;
+    notice("INFO: Result index is missing or stale. Rebuilding...\n");
+    if (!rebuildResultIndex(resultFile))
+        return 0;
+    return openDiskIndex(index, RESULT_INDEX_FILE, RESULT_INDEX_MAGIC, "results.dat");
+}
+
+// findFixedRecord for results through results.idx: one index probe and one record read. Same return values.
+int fetchResultRecord(FILE *resultFile, const struct StudentResult *key, struct StudentResult *result, long *recordPos)
+{
+    char indexKey[INDEX_KEY_SIZE];
+    if (!makeResultKey(indexKey, key))
+        return 0;
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        struct DiskIndex index;
+        struct IndexSlot slot;
+        if (!openResultIndex(&index, resultFile))
+            return -1;
+        int found = diskIndexFind(&index, indexKey, &slot);
+        closeDiskIndex(&index);
+        if (!found)
+            return 0;
+        long pos = (long)(slot.offset * (long long)sizeof(struct StudentResult));
+        hotPath.recordsScanned++;
+        if (seekData(resultFile, pos, SEEK_SET) == 0 && readData(result, sizeof(*result), 1, resultFile) == 1 &&
+            matchResult(result, key))
+        {
+            if (recordPos != NULL)
+                *recordPos = pos;
+            return 1;
         }
 
-        int foundCount = 0; 
-        char line[512];
-        char name1[100], name2[100], father[100], mother[100];
-        char currentID[100], currentDept[100], intake[100], section[100];
-        char presentAddr[200], permanentAddr[200], blood[20];
-        char mobile[20], backupMobile[20], email[100];
-        char fullName[201];
+        clearerr(resultFile);
+        notice("INFO: Result index points at the wrong record. Rebuilding...\n");
+        if (!rebuildResultIndex(resultFile))
+            return -1;
+    }
+    return -1;
+}
 
-        int readingRecord = 0;      
-        char recordBuffer[2048] = ""; 
+static int gpaBin(float gpa)
+{
+    if (!(gpa > 0.0f))
+        return 0;
+    if (gpa >= 4.0f)
+        return GPA_BINS - 1;
+    return (int)(gpa * 100.0f + 0.5f);
+}
 
-        printf("\n--- Search Results for '%s' in %s ---\n", searchName, departmentName);
-        recordBuffer[0] = '\0';
-        readingRecord = 0;
+static void countGpa(struct GpaStats *group, float gpa, int delta)
+{
+    long long bin = gpaBin(gpa);
+    group->count += delta;
+    group->sum += delta * bin;
+    group->sumSquares += delta * bin * bin;
+    group->grades[gradeIndex(gpa)] += delta;
+    group->bins[bin] += (unsigned int)delta;
+}
 
-        while (fgets(line, sizeof(line), *P_ptr))
-        {
-            char trimmedLine[512];
-            strcpy(trimmedLine, line);
-            trimWhitespace(trimmedLine);
+static void initGpaStats(struct GpaStats *group, const char *intake, const char *section)
+{
+    memset(group, 0, sizeof(*group));
+    snprintf(group->intake, sizeof(group->intake), "%s", intake);
+    snprintf(group->section, sizeof(group->section), "%s", section);
+}
 
-            if (strlen(trimmedLine) == 0)
-            { 
-                if (readingRecord)
+// Recomputes every group in one pass over results.dat and writes results.agg. Each record only bumps its
+// group's counters; the previous record's group is tried before the hash, as results arrive a class at a time.
+int rebuildResultStats(FILE *resultFile)
+{
+    struct StudentMap map;
+    struct IndexTable lookup;
+    struct IndexHeader header;
+    struct GpaStats *groups = NULL;
+    char key[INDEX_KEY_SIZE];
+    char tempPath[300];
+    long groupCount = 0, capacity = 0, last = -1;
+
+    if (fflush(resultFile) != 0 || !mapStudentFile(resultFile, &map, POSIX_MADV_SEQUENTIAL))
+        return 0;
+    const struct StudentResult *results = (const struct StudentResult *)map.data;
+    long long count = (long long)(map.length / sizeof(struct StudentResult));
+    hotPath.recordsScanned += count;
+    int ok = initIndexTable(&lookup, RESULT_STATS_MAGIC, 64);
+    for (long long i = 0; ok && i < count; i++)
+    {
+        const struct StudentResult *r = &results[i];
+        if (FIXED_RECORD_DEAD(r))
+            continue;
+        if (last < 0 || strcmp(groups[last].intake, r->intake) != 0 || strcmp(groups[last].section, r->section) != 0)
+        {
+            snprintf(key, sizeof(key), "%s|%s", r->intake, r->section);
+            struct IndexSlot *slot = indexTableFind(&lookup, key);
+            if (slot != NULL)
+                last = (long)slot->offset;
+            else
+            {
+                if (groupCount == capacity)
                 {
-                    char *linePtr = recordBuffer;
-                    char blockLine[512];
-                    name1[0] = '\0';
-                    name2[0] = '\0';
-                    father[0] = '\0';
-                    mother[0] = '\0';
-                    currentID[0] = '\0';
-                    currentDept[0] = '\0';
-                    intake[0] = '\0';
-                    section[0] = '\0';
-                    presentAddr[0] = '\0';
-                    permanentAddr[0] = '\0';
-                    blood[0] = '\0';
-                    mobile[0] = '\0';
-                    backupMobile[0] = '\0';
-                    email[0] = '\0';
-                    fullName[0] = '\0';
-
-                    while (sscanf(linePtr, "%511[^\n]", blockLine) == 1)
-                    {
-                        char *nextNewline = strchr(linePtr, '\n');
-                        char temp_s1[200], temp_s2[100];
-                        if (sscanf(blockLine, "Student Name: %99s %99s", temp_s1, temp_s2) == 2)
-                        {
-                            strcpy(name1, temp_s1);
-                            strcpy(name2, temp_s2);
-                            snprintf(fullName, sizeof(fullName), "%s %s", name1, name2);
-                        }
-                        else if (sscanf(blockLine, "Father's name: %99[^\n]", temp_s1) == 1)
-                        {
-                            strcpy(father, temp_s1);
-                        }
-                        else if (sscanf(blockLine, "Mother's name: %99[^\n]", temp_s1) == 1)
-                        {
-                            strcpy(mother, temp_s1);
-                        }
-                        else if (sscanf(blockLine, "Student ID: %99s", temp_s1) == 1)
-                        {
-                            strcpy(currentID, temp_s1);
-                        }
-                        else if (sscanf(blockLine, "Department: %99s", temp_s1) == 1)
-                        {
-                            strcpy(currentDept, temp_s1);
-                        }
-                        else if (sscanf(blockLine, "Intake: %99s", temp_s1) == 1)
-                        {
-                            strcpy(intake, temp_s1);
-                        }
-                        else if (sscanf(blockLine, "Section: %99s", temp_s1) == 1)
-                        {
-                            strcpy(section, temp_s1);
-                        }
-                        else if (sscanf(blockLine, "Present Address: %199[^\n]", temp_s1) == 1)
-                        {
-                            strcpy(presentAddr, temp_s1);
-                        }
-                        else if (sscanf(blockLine, "Permanent Address: %199[^\n]", temp_s1) == 1)
-                        {
-                            strcpy(permanentAddr, temp_s1);
-                        }
-                        else if (sscanf(blockLine, "Blood Group: %19[^\n]", temp_s1) == 1)
-                        {
-                            strcpy(blood, temp_s1);
-                        }
-                        else if (sscanf(blockLine, "Mobile number: %19s", temp_s1) == 1)
-                        {
-                            strcpy(mobile, temp_s1);
-                        }
-                        else if (sscanf(blockLine, "Backup Mobile Number: %19s", temp_s1) == 1)
-                        {
-                            strcpy(backupMobile, temp_s1);
-                        }
-                        else if (sscanf(blockLine, "Email: %99[^\n]", temp_s1) == 1)
-                        {
-                            strcpy(email, temp_s1);
-                        }
-                        if (!nextNewline)
-                            break;
-                        linePtr = nextNewline + 1;
-                        if (*linePtr == '\0')
-                            break;
-                    }
-                    if (strlen(fullName) > 0 && strstr(fullName, searchName) != NULL && strcmp(currentDept, departmentName) == 0)
+                    capacity = capacity ? capacity * 2 : 16;
+                    struct GpaStats *grown = realloc(groups, (size_t)capacity * sizeof(struct GpaStats));
+                    if (grown == NULL)
                     {
-                        if (foundCount == 0)
-                        { 
-                            printf("\n------------------- Matching Student(s) Found -------------------\n");
-                        }
-                        foundCount++;
-                        printf("--- Match %d ---\n", foundCount);
-                        printf("Name: %s\n", fullName);
-                        printf("Father's Name: %s\n", father);
-                        printf("Mother's Name: %s\n", mother);
-                        printf("Student ID: %s\n", currentID);
-                        printf("Department: %s\n", currentDept);
-                        printf("Intake: %s\n", intake);
-                        printf("Section: %s\n", section);
-                        printf("Present Address: %s\n", presentAddr);
-                        printf("Permanent Address: %s\n", permanentAddr);
-                        printf("Blood Group: %s\n", blood);
-                        printf("Mobile Number: %s\n", mobile);
-                        printf("Backup Mobile: %s\n", backupMobile);
-                        printf("Email: %s\n", email);
-                        printf("-------------------------------------------------------------\n");
+                        reportSystemError("Error allocating result statistics");
+                        ok = 0;
+                        break;
                     }
-                    readingRecord = 0;
-                    recordBuffer[0] = '\0';
+                    groups = grown;
                 }
-                continue;
-            }
-            readingRecord = 1;
-            if (strlen(recordBuffer) + strlen(line) < sizeof(recordBuffer))
-            {
-                strcat(recordBuffer, line);
-            }
-            else
-            {
-                fprintf(stderr, "Warning: Record buffer overflow during name search\n");
+                initGpaStats(&groups[groupCount], r->intake, r->section);
+                last = groupCount++;
+                ok = indexTablePut(&lookup, key, last, 0, 0) > 0;
             }
         }
-        if (readingRecord)
-        {
-            char *linePtr = recordBuffer;
-            char blockLine[512];
-            name1[0] = '\0';
-            name2[0] = '\0';
-            father[0] = '\0';
-            mother[0] = '\0';
-            currentID[0] = '\0';
-            currentDept[0] = '\0';
-            intake[0] = '\0';
-            section[0] = '\0';
-            presentAddr[0] = '\0';
-            permanentAddr[0] = '\0';
-            blood[0] = '\0';
-            mobile[0] = '\0';
-            backupMobile[0] = '\0';
-            email[0] = '\0';
-            fullName[0] = '\0';
-            while (sscanf(linePtr, "%511[^\n]", blockLine) == 1)
-            {
-                char *nextNewline = strchr(linePtr, '\n');
-                char temp_s1[200], temp_s2[100];
-                if (sscanf(blockLine, "Student Name: %99s %99s", temp_s1, temp_s2) == 2)
-                {
-                    strcpy(name1, temp_s1);
-                    strcpy(name2, temp_s2);
-                    snprintf(fullName, sizeof(fullName), "%s %s", name1, name2);
-                }
-                else if (sscanf(blockLine, "Father's name: %99[^\n]", temp_s1) == 1)
-                {
-                    strcpy(father, temp_s1);
-                }
-                else if (sscanf(blockLine, "Mother's name: %99[^\n]", temp_s1) == 1)
-                {
-                    strcpy(mother, temp_s1);
-                }
-                else if (sscanf(blockLine, "Student ID: %99s", temp_s1) == 1)
-                {
-                    strcpy(currentID, temp_s1);
-                }
-                else if (sscanf(blockLine, "Department: %99s", temp_s1) == 1)
-                {
-                    strcpy(currentDept, temp_s1);
-                }
-                else if (sscanf(blockLine, "Intake: %99s", temp_s1) == 1)
-                {
-                    strcpy(intake, temp_s1);
-                }
-                else if (sscanf(blockLine, "Section: %99s", temp_s1) == 1)
-                {
-                    strcpy(section, temp_s1);
-                }
-                else if (sscanf(blockLine, "Present Address: %199[^\n]", temp_s1) == 1)
-                {
-                    strcpy(presentAddr, temp_s1);
-                }
-                else if (sscanf(blockLine, "Permanent Address: %199[^\n]", temp_s1) == 1)
-                {
-                    strcpy(permanentAddr, temp_s1);
-                }
-                else if (sscanf(blockLine, "Blood Group: %19[^\n]", temp_s1) == 1)
-                {
-                    strcpy(blood, temp_s1);
-                }
-                else if (sscanf(blockLine, "Mobile number: %19s", temp_s1) == 1)
-                {
-                    strcpy(mobile, temp_s1);
-                }
-                else if (sscanf(blockLine, "Backup Mobile Number: %19s", temp_s1) == 1)
-                {
-                    strcpy(backupMobile, temp_s1);
-                }
-                else if (sscanf(blockLine, "Email: %99[^\n]", temp_s1) == 1)
-                {
-                    strcpy(email, temp_s1);
-                }
-                if (!nextNewline)
-                    break;
-                linePtr = nextNewline + 1;
-                if (*linePtr == '\0')
-                    break;
-            }
-            if (strlen(fullName) > 0 && strstr(fullName, searchName) != NULL && strcmp(currentDept, departmentName) == 0)
-            {
-                if (foundCount == 0)
-                {
-                    printf("\n------------------- Matching Student(s) Found -------------------\n");
-                }
-                foundCount++;
-                printf("--- Match %d ---\n", foundCount);
-                printf("Name: %s\n", fullName);
-                printf("Father's Name: %s\n", father);
-                printf("Mother's Name: %s\n", mother);
-                printf("Student ID: %s\n", currentID);
-                printf("Department: %s\n", currentDept);
-                printf("Intake: %s\n", intake);
-                printf("Section: %s\n", section);
-                printf("Present Address: %s\n", presentAddr);
-                printf("Permanent Address: %s\n", permanentAddr);
-                printf("Blood Group: %s\n", blood);
-                printf("Mobile Number: %s\n", mobile);
-                printf("Backup Mobile: %s\n", backupMobile);
-                printf("Email: %s\n", email);
-                printf("-------------------------------------------------------------\n");
-            }
+        countGpa(&groups[last], r->gpa, 1);
+    }
+    freeIndexTable(&lookup);
+    unmapStudentFile(&map);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, RESULT_STATS_MAGIC, sizeof(RESULT_STATS_MAGIC) - 1);
+    header.version = INDEX_VERSION;
+    header.slotCount = (unsigned int)groupCount;
+    header.usedCount = (unsigned int)groupCount;
+    getFileStamp("results.dat", &header.dataSize, &header.dataModified);
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", RESULT_STATS_FILE);
+    FILE *file = ok ? fopen(tempPath, "wb") : NULL;
+    if (ok && file == NULL)
+        reportSystemError("Error creating result statistics file");
+    ok = ok && file != NULL && fwrite(&header, sizeof(header), 1, file) == 1 &&
+         (groupCount == 0 || fwrite(groups, sizeof(struct GpaStats), (size_t)groupCount, file) == (size_t)groupCount);
+    if (file != NULL && fclose(file) != 0)
+        ok = 0;
+    if (file != NULL && (!ok || rename(tempPath, RESULT_STATS_FILE) != 0))
+    {
+        reportSystemError("Error writing result statistics file");
+        remove(tempPath);
+        ok = 0;
+    }
+    if (ok)
+        notice("Result statistics rebuilt: %ld intake/section groups.\n", groupCount);
+    free(groups);
+    return ok;
+}
+
+static int loadResultStats(struct ResultStats *stats)
+{
+    long long dataSize = 0, dataModified = 0;
+    memset(stats, 0, sizeof(*stats));
+    stats->file = fopen(RESULT_STATS_FILE, "rb+");
+    if (stats->file == NULL)
+        return 0;
+    int ok = readData(&stats->header, sizeof(stats->header), 1, stats->file) == 1 &&
+             strncmp(stats->header.magic, RESULT_STATS_MAGIC, sizeof(stats->header.magic)) == 0 &&
+             stats->header.version == INDEX_VERSION && stats->header.usedCount == stats->header.slotCount &&
+             getFileStamp("results.dat", &dataSize, &dataModified) &&
+             dataSize == stats->header.dataSize && dataModified == stats->header.dataModified;
+    if (ok)
+    {
+        stats->groups = malloc((stats->header.usedCount ? stats->header.usedCount : 1) * sizeof(struct GpaStats));
+        ok = stats->groups != NULL &&
+             readData(stats->groups, sizeof(struct GpaStats), stats->header.usedCount, stats->file) == stats->header.usedCount;
+    }
+    if (!ok)
+        closeResultStats(stats);
+    return ok;
+}
+
+int openResultStats(struct ResultStats *stats, FILE *resultFile)
+{
+    fflush(resultFile);
+    if (loadResultStats(stats))
+        return 1;
+    notice("INFO: Result statistics are missing or stale. Rebuilding...\n");
+    return rebuildResultStats(resultFile) && loadResultStats(stats);
+}
+
+void closeResultStats(struct ResultStats *stats)
+{
+    if (stats->file != NULL)
+        fclose(stats->file);
+    free(stats->groups);
+    memset(stats, 0, sizeof(*stats));
+}
+
+static long findGpaStats(const struct ResultStats *stats, const char *intake, const char *section)
+{
+    for (unsigned int g = 0; g < stats->header.usedCount; g++)
+    {
+        if (strcmp(stats->groups[g].intake, intake) == 0 && strcmp(stats->groups[g].section, section) == 0)
+            return (long)g;
+    }
+    return -1;
+}
+
+static long addGpaStats(struct ResultStats *stats, const char *intake, const char *section)
+{
+    struct GpaStats *grown = realloc(stats->groups, (stats->header.usedCount + 1) * sizeof(struct GpaStats));
+    if (grown == NULL)
+        return -1;
+    stats->groups = grown;
+    initGpaStats(&stats->groups[stats->header.usedCount], intake, section);
+    stats->header.slotCount = ++stats->header.usedCount;
+    return (long)stats->header.usedCount - 1;
+}
+
+static int writeGpaStats(struct ResultStats *stats, long g)
+{
+    long long pos = (long long)sizeof(struct IndexHeader) + g * (long long)sizeof(struct GpaStats);
+    return seekData(stats->file, pos, SEEK_SET) == 0 &&
+           fwrite(&stats->groups[g], sizeof(struct GpaStats), 1, stats->file) == 1;
+}
+
+static int stampResultStats(struct ResultStats *stats)
+{
+    if (!getFileStamp("results.dat", &stats->header.dataSize, &stats->header.dataModified))
+        return 0;
+    return seekData(stats->file, 0, SEEK_SET) == 0 &&
+           fwrite(&stats->header, sizeof(stats->header), 1, stats->file) == 1 &&
+           fflush(stats->file) == 0;
+}
+
+// Takes removed's GPA out of its group and counts added's in its own (either may be NULL), writes the
+// groups that changed and restamps the file against results.dat, which must already hold the change.
+// Returns 0 if the file could not be patched.
+int resultStatsApply(struct ResultStats *stats, const struct StudentResult *removed, const struct StudentResult *added)
+{
+    long from = -1, to = -1;
+    if (removed != NULL)
+    {
+        from = findGpaStats(stats, removed->intake, removed->section);
+        if (from < 0 || stats->groups[from].bins[gpaBin(removed->gpa)] == 0)
+            return 0;
+    }
+    if (added != NULL && (to = findGpaStats(stats, added->intake, added->section)) < 0 &&
+        (to = addGpaStats(stats, added->intake, added->section)) < 0)
+        return 0;
+    if (from >= 0)
+        countGpa(&stats->groups[from], removed->gpa, -1);
+    if (to >= 0)
+        countGpa(&stats->groups[to], added->gpa, 1);
+    return (from < 0 || writeGpaStats(stats, from)) && (to < 0 || to == from || writeGpaStats(stats, to)) &&
+           stampResultStats(stats);
+}
+
+// Statistics that could not be patched are simply rebuilt from results.dat, which already holds the change.
+static void settleResultStats(struct ResultStats *stats, int patched, FILE *resultFile)
+{
+    closeResultStats(stats);
+    if (!patched)
+        rebuildResultStats(resultFile);
+}
+
+// Sums the groups of an intake, or just its section unless section is NULL, into total. Reads only
+// results.agg, so the cost does not grow with results.dat. Returns 1 if any result matched, 0 if none,
+// -1 on error.
+int collectGpaStats(FILE *resultFile, const char *intake, const char *section, struct GpaStats *total)
+{
+    struct ResultStats stats;
+    initGpaStats(total, intake, section != NULL ? section : "");
+    if (!openResultStats(&stats, resultFile))
+        return -1;
+    for (unsigned int g = 0; g < stats.header.usedCount; g++)
+    {
+        const struct GpaStats *group = &stats.groups[g];
+        if (strcmp(group->intake, intake) != 0 || (section != NULL && strcmp(group->section, section) != 0))
+            continue;
+        total->count += group->count;
+        total->sum += group->sum;
+        total->sumSquares += group->sumSquares;
+        for (int i = 0; i < GRADE_COUNT; i++)
+            total->grades[i] += group->grades[i];
+        for (int b = 0; b < GPA_BINS; b++)
+            total->bins[b] += group->bins[b];
+    }
+    closeResultStats(&stats);
+    return total->count > 0;
+}
+
+double gpaStatsMedian(const struct GpaStats *stats)
+{
+    long long low = (stats->count - 1) / 2, high = stats->count / 2, seen = 0;
+    int lowBin = -1;
+    for (int b = 0; b < GPA_BINS && stats->count > 0; b++)
+    {
+        seen += stats->bins[b];
+        if (lowBin < 0 && seen > low)
+            lowBin = b;
+        if (seen > high)
+            return (lowBin + b) / 200.0;
+    }
+    return 0.0;
+}
+
+// Population standard deviation. The square root is taken by Newton's method so the program does not
+// need libm.
+double gpaStatsDeviation(const struct GpaStats *stats)
+{
+    if (stats->count == 0)
+        return 0.0;
+    double n = (double)stats->count;
+    double variance = ((double)stats->sumSquares * n - (double)stats->sum * (double)stats->sum) / (n * n);
+    if (variance <= 0.0)
+        return 0.0;
+    double root = variance > 1.0 ? variance : 1.0;
+    for (int i = 0; i < 64; i++)
+        root = (root + variance / root) / 2.0;
+    return root / 100.0;
+}
+
+// Folds the hundredth bins into 0.25-wide buckets, the last holding 4.00 alone, with labels like "3.75-3.99".
+void gpaStatsHistogram(const struct GpaStats *stats, long long buckets[GPA_HISTOGRAM_BUCKETS], char labels[][16])
+{
+    for (int i = 0; i < GPA_HISTOGRAM_BUCKETS; i++)
+    {
+        buckets[i] = 0;
+        if (i < GPA_HISTOGRAM_BUCKETS - 1)
+            snprintf(labels[i], 16, "%.2f-%.2f", i * 0.25, i * 0.25 + 0.24);
+        else
+            snprintf(labels[i], 16, "%.2f", i * 0.25);
+    }
+    for (int b = 0; b < GPA_BINS; b++)
+        buckets[b / 25] += stats->bins[b];
+}
+
+// Writes result at recordPos, or into a free slot when recordPos is negative, files it in the result index and
+// moves its GPA into the statistics, taking out original's if it replaces one. Returns 1 if written, 0 on error.
+int saveResult(FILE *resultFile, long recordPos, const struct StudentResult *original, const struct StudentResult *result)
+{
+    char key[INDEX_KEY_SIZE], originalKey[INDEX_KEY_SIZE];
+    struct DiskIndex index;
+    struct IndexSlot slot;
+    struct ResultStats stats;
+
+    int indexed = makeResultKey(key, result) && (original == NULL || makeResultKey(originalKey, original)) &&
+                  openResultIndex(&index, resultFile);
+    int counted = openResultStats(&stats, resultFile);
+    long writtenPos = recordPos < 0 ? insertFixedRecord(resultFile, &resultStore, result)
+                                    : writeFixedRecord(resultFile, recordPos, result, sizeof(*result)) ? recordPos : -1;
+    if (writtenPos < 0)
+    {
+        if (indexed)
+            closeDiskIndex(&index);
+        if (counted)
+            closeResultStats(&stats);
+        return 0;
+    }
+    if (indexed)
+    {
+        // A key that is already filed keeps its first record; re-putting the entry restamps the index.
+        long long recordNumber = writtenPos / (long)sizeof(struct StudentResult);
+        if (original != NULL && strcmp(originalKey, key) != 0)
+            diskIndexRemove(&index, originalKey);
+        if (diskIndexFind(&index, key, &slot))
+            recordNumber = slot.offset;
+        if (!diskIndexPut(&index, key, recordNumber, (long long)sizeof(struct StudentResult)))
+            reportError("Warning: Result index could not be updated; it will be rebuilt on the next lookup.\n");
+        closeDiskIndex(&index);
+    }
+    if (counted)
+        settleResultStats(&stats, resultStatsApply(&stats, original, result), resultFile);
+    return 1;
+}
+
+// Finds key through the result index, turns its record into a free slot and takes it out of the index and
+// the statistics. Returns 1 if deleted, 0 if there is no such result, -1 on error.
+int deleteResultRecord(FILE *resultFile, const struct StudentResult *key)
+{
+    char indexKey[INDEX_KEY_SIZE];
+    struct StudentResult result;
+    struct DiskIndex index;
+    struct ResultStats stats;
+    long recordPos;
+
+    int found = fetchResultRecord(resultFile, key, &result, &recordPos);
+    if (found <= 0)
+        return found;
+    int indexed = makeResultKey(indexKey, key) && openResultIndex(&index, resultFile);
+    int counted = openResultStats(&stats, resultFile);
+    if (!deleteFixedRecords(resultFile, &resultStore, &recordPos, 1))
+    {
+        if (indexed)
+            closeDiskIndex(&index);
+        if (counted)
+            closeResultStats(&stats);
+        return -1;
+    }
+    if (indexed)
+    {
+        if (!diskIndexRemove(&index, indexKey))
+            reportError("Warning: Result index could not be updated; it will be rebuilt on the next lookup.\n");
+        closeDiskIndex(&index);
+    }
+    if (counted)
+        settleResultStats(&stats, resultStatsApply(&stats, &result, NULL), resultFile);
+    return 1;
+}
+
+void manageAcademicSchedules(FILE **scheduleFile_ptr)
+{
+    int scheduleRunning = 1;
+    int select;
+    while (scheduleRunning)
+    {
+        clearScreen();
+        printf("\n\n--- Academic Schedule Management ---\n");
+        printf("1. Add New Schedule Entry\n");
+        printf("2. View All Schedules for Intake & Section\n");
+        printf("3. Update Specific Schedule Entry\n");
+        printf("4. Delete Specific Schedule Entry\n");
+        printf("5. Room and Faculty Clash Report\n");
+        printf("6. Room, Faculty and Day Timetable\n");
+        printf("7. Faculty Teaching Load\n");
+        printf("8. Back to Main Menu\n");
+        printf("\nEnter Choice: ");
+
+        if (scanInput("%d", &select) != 1)
+        {
+            printf("Invalid input. Please enter a number (1-8).\n");
+            clearInputBuffer();
+            pressEnterToContinue();
+            continue;
         }
-        if (foundCount == 0)
+        clearInputBuffer(); 
+        if (*scheduleFile_ptr == NULL)
         {
-            printf("\nNo students found matching the name '%s' in the %s department.\n", searchName, departmentName);
+            reportError("ERROR: Schedule file pointer is NULL in manageAcademicSchedules.\n");
+            *scheduleFile_ptr = openScheduleStore(SCHEDULE_DATA_FILE);
+            if (*scheduleFile_ptr == NULL)
+            {
+                reportSystemError("FATAL: Schedule file is inaccessible");
+                exit(EXIT_FAILURE);
+            }
+            printf("INFO: Schedule file pointer was reopened.\n");
         }
-        clearerr(*P_ptr);
-        printf("\nOptions:\n1. Search Again by Name\n2. Back to %s Menu\n", departmentName);
-        printf("Enter your choice: ");
-        int choice;
-        if (scanf("%d", &choice) != 1)
+
+        static const char *const scheduleOperations[] = {NULL, "addSchedule", "viewSchedule", "updateSchedule", "deleteSchedule",
+                                                         "viewScheduleClashes", "viewTimetable", "viewFacultyLoad"};
+        struct OperationTimer timer;
+        const char *operation = select >= 1 && select <= 7 ? scheduleOperations[select] : NULL;
+        if (operation != NULL)
+            beginOperation(&timer, operation);
+        switch (select)
         {
-            choice = 2;
-            clearInputBuffer();
+        case 1:
+            addSchedule(scheduleFile_ptr);
+            break;
+        case 2:
+            viewSchedule(scheduleFile_ptr);
+            break;
+        case 3:
+            updateSchedule(scheduleFile_ptr);
+            break;
+        case 4:
+            deleteSchedule(scheduleFile_ptr);
+            break;
+        case 5:
+            viewScheduleClashes(scheduleFile_ptr);
+            break;
+        case 6:
+            viewTimetable(scheduleFile_ptr);
+            break;
+        case 7:
+            viewFacultyLoad(scheduleFile_ptr);
+            break;
+        case 8:
+            scheduleRunning = 0;
+            break;
+        default:
+            printf("Invalid choice (%d). Please enter 1-8.\n", select);
+            break;
         }
-        else
+        if (operation != NULL)
+            endOperation(&timer);
+        if (scheduleRunning && select >= 1 && select <= 7)
         {
-            clearInputBuffer();
+            pressEnterToContinue();
         }
-        if (choice != 1)
-            searchAgain = 0;
     }
 }
 
-void viewStudentsByIntakeSection(FILE **P_ptr, const char *departmentName)
+static void printScheduleClash(const struct ScheduleClash *clash, int withFirst)
 {
-    if (*P_ptr == NULL)
+    char when[64];
+    const struct AcademicSchedule *first = &clash->entries[0], *other = &clash->entries[1];
+    formatBookingTime(clash->start, clash->end, when, sizeof(when));
+    printf("  %s %s, %s: ", clash->kind == BOOKING_ROOM ? "Room" : "Faculty", bookingName(first, clash->kind), when);
+    if (withFirst)
+        printf("Intake %s, Section %s (%s) and ", first->intake, first->section, first->scheduleType);
+    printf("Intake %s, Section %s (%s)\n", other->intake, other->section, other->scheduleType);
+}
+
+// Lists the bookings schedule would overlap and asks whether to save it anyway. Returns 1 to go ahead.
+static int confirmScheduleClashes(FILE *scheduleFile, const struct AcademicSchedule *schedule, long recordPos)
+{
+    struct ScheduleClash *clashes;
+    char answer[8];
+    long count = findScheduleClashes(scheduleFile, schedule, recordPos, &clashes);
+    if (count < 0)
+        reportError("Warning: Could not check for room and faculty clashes.\n");
+    if (count <= 0)
+        return 1;
+    printf("\nThis entry clashes with %ld existing booking%s:\n", count, count == 1 ? "" : "s");
+    for (long i = 0; i < count; i++)
+        printScheduleClash(&clashes[i], 0);
+    free(clashes);
+    printf("Save anyway? (y/n): ");
+    if (!readLine(answer, sizeof(answer)))
+        return 0;
+    trimWhitespace(answer);
+    return answer[0] == 'y' || answer[0] == 'Y';
+}
+
+void addSchedule(FILE **scheduleFile_ptr)
+{
+    if (*scheduleFile_ptr == NULL)
     {
-        fprintf(stderr, "ERROR: Student file is not open in viewStudentsByIntakeSection.\n");
+        reportError("ERROR: Schedule file is not open in addSchedule.\n");
         pressEnterToContinue();
         return;
     }
-
-    int viewAgain = 1;
-    while (viewAgain)
+    struct AcademicSchedule schedule;
+    int addMore = 1;
+    while (addMore)
     {
-        system("clear || cls");
-        printf("\n--- View Students by Intake & Section in %s ---\n", departmentName);
-        char searchIntake[100], searchSection[100];
+        clearScreen();
+        printf("\n--- Add New Academic Schedule Entry ---\n");
+        memset(&schedule, 0, sizeof(struct AcademicSchedule));
 
-        printf("Enter Intake to filter by: ");
-        if (!fgets(searchIntake, sizeof(searchIntake), stdin))
+        printf("Enter Intake: ");
+        if (!readLine(schedule.intake, sizeof(schedule.intake)))
         {
             printf("Input error!\n");
             continue;
         }
-        trimWhitespace(searchIntake);
+        trimWhitespace(schedule.intake);
 
-        printf("Enter Section to filter by: ");
-        if (!fgets(searchSection, sizeof(searchSection), stdin))
+        printf("Enter Section: ");
+        if (!readLine(schedule.section, sizeof(schedule.section)))
         {
             printf("Input error!\n");
             continue;
         }
-        trimWhitespace(searchSection);
-
-        if (strlen(searchIntake) == 0 || strlen(searchSection) == 0)
+        trimWhitespace(schedule.section);
+        printf("Select Schedule Type:\n");
+        printf("  1. Class Routine\n");
+        printf("  2. Mid Exam Routine\n");
+        printf("  3. Final Exam Routine\n");
+        printf("  4. Result Publication Date\n");
+        printf("  5. Other Event\n");
+        printf("Enter choice (1-5): ");
+        int typeChoice;
+        if (scanInput("%d", &typeChoice) != 1 || typeChoice < 1 || typeChoice > 5)
         {
-            printf("Intake and Section cannot be empty.\n");
-            pressEnterToContinue();
-            continue;
+            printf("Invalid type choice. Defaulting to 'Other Event'.\n");
+            strcpy(schedule.scheduleType, "Other Event");
+            clearInputBuffer();
         }
-
-        rewind(*P_ptr);
-        if (ferror(*P_ptr))
+        else
         {
-            perror("Error rewinding student file");
-            clearerr(*P_ptr);
-            pressEnterToContinue();
-            return;
-        }
-
-        printf("\n--- Student List for %s - Intake: %s, Section: %s ---\n\n", departmentName, searchIntake, searchSection);
-        printf("%-25s %-15s %-15s\n", "Student Name", "Student ID", "Mobile Number");
-        printf("----------------------------------------------------------\n");
-
-        int found = 0;
-        char line[512];
-        char name1[100], name2[100], studentID[100], mobileNumber[100];
-        char currentDept[100], currentIntake[100], currentSection[100];
-        char fullName[201];
-        int readingRecord = 0;
-        fullName[0] = '\0';
-        name1[0] = '\0';
-        name2[0] = '\0';
-        studentID[0] = '\0';
-        mobileNumber[0] = '\0';
-        currentDept[0] = '\0';
-        currentIntake[0] = '\0';
-        currentSection[0] = '\0';
-
-        while (fgets(line, sizeof(line), *P_ptr))
-        {
-            char trimmedLine[512];
-            strcpy(trimmedLine, line);
-            trimWhitespace(trimmedLine);
-
-            if (strlen(trimmedLine) == 0)
-            { 
-                if (readingRecord)
-                {
-                    if (strcmp(currentDept, departmentName) == 0 &&
-                        strcmp(currentIntake, searchIntake) == 0 &&
-                        strcmp(currentSection, searchSection) == 0)
-                    {
-                        found = 1;
-                        snprintf(fullName, sizeof(fullName), "%s %s", name1, name2);
-                        printf("%-25s %-15s %-15s\n", fullName, studentID, mobileNumber);
-                    }
-                    readingRecord = 0;
-                    fullName[0] = '\0';
-                    name1[0] = '\0';
-                    name2[0] = '\0';
-                    studentID[0] = '\0';
-                    mobileNumber[0] = '\0';
-                    currentDept[0] = '\0';
-                    currentIntake[0] = '\0';
-                    currentSection[0] = '\0';
-                }
-                continue;
-            }
-            readingRecord = 1;
-            char temp_s1[100], temp_s2[100];
-            if (sscanf(trimmedLine, "Student Name: %99s %99s", temp_s1, temp_s2) == 2)
+            clearInputBuffer(); 
+            switch (typeChoice)
             {
-                strcpy(name1, temp_s1);
-                strcpy(name2, temp_s2);
+            case 1:
+                strcpy(schedule.scheduleType, "Class Routine");
+                break;
+            case 2:
+                strcpy(schedule.scheduleType, "Mid Exam Routine");
+                break;
+            case 3:
+                strcpy(schedule.scheduleType, "Final Exam Routine");
+                break;
+            case 4:
+                strcpy(schedule.scheduleType, "Result Publication Date");
+                break;
+            case 5:
+                strcpy(schedule.scheduleType, "Other Event");
+                break;
             }
-            else if (sscanf(trimmedLine, "Student ID: %99s", temp_s1) == 1)
+        }
+        if (isRoutineType(schedule.scheduleType))
+        {
+            printf("\n--- Enter %s Details ---\n", schedule.scheduleType);
+            printf("Day(s) (e.g., Sunday or Mon-Wed): ");
+            if (!readLine(schedule.routineData.day, sizeof(schedule.routineData.day)))
             {
-                strcpy(studentID, temp_s1);
+                printf("Input error!\n");
+                continue;
             }
-            else if (sscanf(trimmedLine, "Department: %99s", temp_s1) == 1)
+            trimWhitespace(schedule.routineData.day);
+
+            printf("Date(s) (e.g., 25/12/2023 or TBA): ");
+            if (!readLine(schedule.routineData.date, sizeof(schedule.routineData.date)))
             {
-                strcpy(currentDept, temp_s1);
+                printf("Input error!\n");
+                continue;
             }
-            else if (sscanf(trimmedLine, "Mobile number: %99s", temp_s1) == 1)
+            trimWhitespace(schedule.routineData.date);
+
+            printf("Time (e.g., 10:00 AM - 11:30 AM): ");
+            if (!readLine(schedule.routineData.time, sizeof(schedule.routineData.time)))
             {
-                strcpy(mobileNumber, temp_s1);
+                printf("Input error!\n");
+                continue;
             }
-            else if (sscanf(trimmedLine, "Intake: %99s", temp_s1) == 1)
+            trimWhitespace(schedule.routineData.time);
+
+            printf("Room/Platform (e.g., 501 or Online): ");
+            if (!readLine(schedule.routineData.room, sizeof(schedule.routineData.room)))
             {
-                strcpy(currentIntake, temp_s1);
+                printf("Input error!\n");
+                continue;
             }
-            else if (sscanf(trimmedLine, "Section: %99s", temp_s1) == 1)
+            trimWhitespace(schedule.routineData.room);
+
+            printf("Faculty/Instructor (e.g., Dr. Smith or TBA): ");
+            if (!readLine(schedule.routineData.faculty, sizeof(schedule.routineData.faculty)))
             {
-                strcpy(currentSection, temp_s1);
+                printf("Input error!\n");
+                continue;
             }
+            trimWhitespace(schedule.routineData.faculty);
+
+            schedule.otherDetails[0] = '\0'; 
         }
-        if (readingRecord)
-        {
-            if (strcmp(currentDept, departmentName) == 0 &&
-                strcmp(currentIntake, searchIntake) == 0 &&
-                strcmp(currentSection, searchSection) == 0)
+        else
+        { 
+            printf("Enter Details for '%s':\n", schedule.scheduleType);
+            if (!readLine(schedule.otherDetails, sizeof(schedule.otherDetails)))
             {
-                found = 1;
-                snprintf(fullName, sizeof(fullName), "%s %s", name1, name2);
-                printf("%-25s %-15s %-15s\n", fullName, studentID, mobileNumber);
+                printf("Input error!\n");
+                continue;
             }
+            trimWhitespace(schedule.otherDetails);
+            schedule.routineData.day[0] = '\0';
+            schedule.routineData.date[0] = '\0';
+            schedule.routineData.time[0] = '\0';
+            schedule.routineData.room[0] = '\0';
+            schedule.routineData.faculty[0] = '\0';
         }
-
-        printf("----------------------------------------------------------\n");
-        if (!found)
+        const char *problem = checkSchedule(&schedule);
+        if (problem != NULL)
         {
-            printf("\nNo students found matching criteria (Dept: %s, Intake: %s, Section: %s).\n", departmentName, searchIntake, searchSection);
+            printf("Error: %s\n", problem);
+            printf("Schedule not added due to missing required fields.\n");
+        }
+        else if (!confirmScheduleClashes(*scheduleFile_ptr, &schedule, -1))
+        {
+            printf("Schedule not added.\n");
+        }
+        else if (insertScheduleRecord(*scheduleFile_ptr, &schedule) >= 0)
+        {
+            printf("\nSchedule entry added successfully.\n");
         }
 
-        clearerr(*P_ptr);
-        printf("\nOptions:\n1. View Another Intake/Section\n2. Back to %s Menu\n", departmentName);
-        printf("Enter your choice: ");
+        printf("\nOptions:\n1. Add Another Entry\n2. Back to Schedule Menu\nChoice: ");
         int choice;
-        if (scanf("%d", &choice) != 1)
+        if (scanInput("%d", &choice) != 1)
         {
-            choice = 2;
+            choice = 2; 
             clearInputBuffer();
         }
         else
         {
-            clearInputBuffer();
+            clearInputBuffer(); 
         }
         if (choice != 1)
-            viewAgain = 0;
+            addMore = 0;
     }
 }
 
-void deleteStudentById(FILE **P_ptr, const char *departmentName)
+static void printScheduleEntry(const struct AcademicSchedule *schedule, int withType)
 {
-    int deleteMore = 1;
-    while (deleteMore)
+    if (withType)
+        printf("| Type: %-60s |\n", schedule->scheduleType);
+    if (isRoutineType(schedule->scheduleType))
     {
-        system("clear || cls");
-        printf("\n--- Delete Student by ID from %s ---\n", departmentName);
-        printf("Enter Student ID to delete: ");
-        char deleteID[100];
-        if (!fgets(deleteID, sizeof(deleteID), stdin))
+        printf("| Day: %-61s |\n", schedule->routineData.day);
+        printf("| Date: %-60s |\n", schedule->routineData.date);
+        printf("| Time: %-60s |\n", schedule->routineData.time);
+        printf("| Room: %-60s |\n", schedule->routineData.room);
+        printf("| Faculty: %-57s |\n", schedule->routineData.faculty);
+    }
+    else
+    {
+        printf("| Details: %-58.58s |\n", schedule->otherDetails);
+        if (strlen(schedule->otherDetails) > 58)
+        {
+            printf("| %-67s |\n", "... (details may be longer)");
+        }
+    }
+    printf("|---------------------------------------------------------------------|\n");
+}
+
+void viewSchedule(FILE **scheduleFile_ptr)
+{
+    if (*scheduleFile_ptr == NULL)
+    {
+        reportError("ERROR: Schedule file is not open in viewSchedule.\n");
+        pressEnterToContinue();
+        return;
+    }
+    struct AcademicSchedule schedule;
+    struct AcademicSchedule *foundSchedules = NULL;
+    long count = 0;
+    char searchIntake[20], searchSection[20];
+    const char *displayOrder[] = {
+        "Class Routine", "Mid Exam Routine", "Final Exam Routine",
+        "Result Publication Date", "Other Event", NULL};
+    enum { TYPE_BUCKETS = sizeof(displayOrder) / sizeof(displayOrder[0]) }; // the last bucket holds other types
+    long bucketStart[TYPE_BUCKETS + 1] = {0};
+
+    clearScreen();
+    printf("\n--- View All Schedules for Intake & Section ---\n");
+    printf("Enter Intake: ");
+    if (!readLine(searchIntake, sizeof(searchIntake)))
+    {
+        printf("Input error!\n");
+        return;
+    }
+    trimWhitespace(searchIntake);
+    printf("Enter Section: ");
+    if (!readLine(searchSection, sizeof(searchSection)))
+    {
+        printf("Input error!\n");
+        return;
+    }
+    trimWhitespace(searchSection);
+
+    if (strlen(searchIntake) == 0 || strlen(searchSection) == 0)
+    {
+        printf("Intake and Section required.\n");
+        return;
+    }
+
+    memset(&schedule, 0, sizeof(schedule));
+    strcpy(schedule.intake, searchIntake);
+    strcpy(schedule.section, searchSection);
+    count = fetchScheduleRecords(*scheduleFile_ptr, &schedule, 0, &foundSchedules, NULL);
+    if (count < 0)
+        count = 0;
+
+    // Counting sort by type: order lists the entries bucket by bucket, keeping file order within each.
+    unsigned char *bucketOf = malloc((size_t)(count > 0 ? count : 1));
+    long *order = malloc((size_t)(count > 0 ? count : 1) * sizeof(long));
+    long next[TYPE_BUCKETS];
+    if (bucketOf == NULL || order == NULL)
+    {
+        reportSystemError("Error allocating schedule list");
+        free(bucketOf);
+        free(order);
+        free(foundSchedules);
+        return;
+    }
+    for (long i = 0; i < count; i++)
+    {
+        int b = 0;
+        while (displayOrder[b] != NULL && strcmp(foundSchedules[i].scheduleType, displayOrder[b]) != 0)
+            b++;
+        bucketOf[i] = (unsigned char)b;
+        bucketStart[b + 1]++;
+    }
+    for (int b = 0; b < TYPE_BUCKETS; b++)
+        bucketStart[b + 1] += bucketStart[b];
+    memcpy(next, bucketStart, sizeof(next));
+    for (long i = 0; i < count; i++)
+        order[next[bucketOf[i]]++] = i;
+
+    if (count > 0)
+    {
+        printf("\n\n***********************************************************************\n");
+        printf("         ACADEMIC SCHEDULE - Intake: %s, Section: %s\n", searchIntake, searchSection);
+        printf("***********************************************************************\n");
+        for (int b = 0; b < TYPE_BUCKETS; b++)
+        {
+            if (bucketStart[b] == bucketStart[b + 1])
+                continue;
+            int others = displayOrder[b] == NULL;
+            printf("\n+---------------------------------------------------------------------+\n");
+            printf("| %-67s |\n", others ? "Other Schedule Entries" : displayOrder[b]);
+            printf("+---------------------------------------------------------------------+\n");
+            for (long k = bucketStart[b]; k < bucketStart[b + 1]; k++)
+                printScheduleEntry(&foundSchedules[order[k]], others);
+        }
+
+        printf("\n***********************************************************************\n");
+    }
+    else
+    {
+        printf("\nNo schedules found matching Intake '%s' and Section '%s'.\n", searchIntake, searchSection);
+    }
+    free(bucketOf);
+    free(order);
+    free(foundSchedules);
+}
+
+void updateSchedule(FILE **scheduleFile_ptr)
+{
+    if (*scheduleFile_ptr == NULL)
+    {
+        reportError("ERROR: Schedule file is not open in updateSchedule.\n");
+        pressEnterToContinue();
+        return;
+    }
+
+    struct AcademicSchedule schedule; 
+    char searchIntake[20], searchSection[20], searchType[50];
+    int found = 0;
+    long recordPos = -1; 
+    int updateAnother = 1;
+
+    while (updateAnother)
+    {
+        clearScreen();
+        printf("\n--- Update Specific Schedule Entry ---\n");
+        printf("Enter Intake of the schedule to update: ");
+        if (!readLine(searchIntake, sizeof(searchIntake)))
+        {
+            printf("Input error!\n");
+            continue;
+        }
+        trimWhitespace(searchIntake);
+
+        printf("Enter Section: ");
+        if (!readLine(searchSection, sizeof(searchSection)))
         {
             printf("Input error!\n");
             continue;
         }
-        trimWhitespace(deleteID);
+        trimWhitespace(searchSection);
 
-        if (strlen(deleteID) == 0)
+        printf("Enter Schedule Type to update: ");
+        if (!readLine(searchType, sizeof(searchType)))
         {
-            printf("Delete ID cannot be empty.\n");
-            pressEnterToContinue();
+            printf("Input error!\n");
             continue;
         }
+        trimWhitespace(searchType);
 
-        const char *originalFilename = "test.txt";
-        const char *tempFilename = "temp_student.tmp";
-
-        FILE *tempFile = fopen(tempFilename, "w");
-        if (tempFile == NULL)
+        if (strlen(searchIntake) == 0 || strlen(searchSection) == 0 || strlen(searchType) == 0)
         {
-            perror("Error creating temporary file");
+            printf("All search fields (Intake, Section, Type) are required.\n");
             pressEnterToContinue();
-            return; 
-        }
-        if (*P_ptr != NULL)
-        {
-            fclose(*P_ptr);
-            *P_ptr = NULL; 
-        }
-        else
-        {
-            fprintf(stderr, "Warning: Student file pointer was already NULL before delete operation.\n");
+            continue;
         }
 
-        FILE *P_read = fopen(originalFilename, "r");
-        if (P_read == NULL)
+        struct AcademicSchedule key;
+        memset(&key, 0, sizeof(key));
+        strcpy(key.intake, searchIntake);
+        strcpy(key.section, searchSection);
+        strcpy(key.scheduleType, searchType);
+        recordPos = -1;
+        found = findScheduleRecord(*scheduleFile_ptr, &key, &schedule, &recordPos);
+        if (found < 0)
         {
-            perror("Error opening student file for reading (delete)");
-            fclose(tempFile);     
-            remove(tempFilename); 
-            *P_ptr = fopen(originalFilename, "a+");
-            if (*P_ptr == NULL)
-            {
-                perror("FATAL: Could not reopen student file after delete read error");
-                exit(EXIT_FAILURE);
-            }
             pressEnterToContinue();
-            return; 
+            continue;
         }
-        int found = 0;
-        char line[512];
-        char currentID[100];
-        char currentDept[100];
-        int skipRecord = 0;         
-        char recordBuffer[2048] = ""; 
-        recordBuffer[0] = '\0';
-        skipRecord = 0;
-        currentID[0] = '\0';   
-        currentDept[0] = '\0'; 
-
-        while (fgets(line, sizeof(line), P_read))
-        {
-            char trimmedLine[512];
-            strcpy(trimmedLine, line);
-            trimWhitespace(trimmedLine);
-
-            if (strlen(trimmedLine) == 0)
-            { 
-                if (strlen(recordBuffer) > 0 && !skipRecord)
-                {
-                    if (fputs(recordBuffer, tempFile) == EOF)
-                    {
-                        perror("Error writing record to temp file");
-                    }
-                }
-                recordBuffer[0] = '\0';
-                skipRecord = 0;
-                currentID[0] = '\0';
-                currentDept[0] = '\0';
-                continue; 
-            }
-            if (strlen(recordBuffer) + strlen(line) < sizeof(recordBuffer))
+
+        if (found)
+        {
+            printf("\n--- Found Schedule Entry ---");
+            printf("\nIntake: %s, Section: %s, Type: %s", schedule.intake, schedule.section, schedule.scheduleType);
+
+            if (isRoutineType(schedule.scheduleType))
             {
-                strcat(recordBuffer, line);
+                printf("\nCurrent Day: %s", schedule.routineData.day);
+                printf("\nCurrent Date: %s", schedule.routineData.date);
+                printf("\nCurrent Time: %s", schedule.routineData.time);
+                printf("\nCurrent Room: %s", schedule.routineData.room);
+                printf("\nCurrent Faculty: %s", schedule.routineData.faculty);
             }
             else
             {
-                fprintf(stderr, "Warning: Record buffer overflow near ID %s during delete.\n", currentID);
+                printf("\nCurrent Details:\n%s", schedule.otherDetails);
             }
-            char temp_s1[100];
-            if (!skipRecord)
-            { 
-                if (sscanf(trimmedLine, "Student ID: %99s", temp_s1) == 1)
+
+            printf("\n\n--- Enter New Details (Press Enter to keep current) ---\n");
+            struct RoutineInfo newRoutineData; 
+            char newOtherDetails[500];
+            char inputBuffer[512]; 
+            int changed = 0;
+            if (isRoutineType(schedule.scheduleType))
+            {
+                printf("New Day (%s): ", schedule.routineData.day);
+                if (!readLine(inputBuffer, sizeof(inputBuffer)))
+                    break;
+                trimWhitespace(inputBuffer);
+                if (strlen(inputBuffer) > 0)
+                {
+                    strncpy(schedule.routineData.day, inputBuffer, sizeof(schedule.routineData.day) - 1);
+                    schedule.routineData.day[sizeof(schedule.routineData.day) - 1] = '\0';
+                    changed = 1;
+                }
+
+                printf("New Date (%s): ", schedule.routineData.date);
+                if (!readLine(inputBuffer, sizeof(inputBuffer)))
+                    break;
+                trimWhitespace(inputBuffer);
+                if (strlen(inputBuffer) > 0)
+                {
+                    strncpy(schedule.routineData.date, inputBuffer, sizeof(schedule.routineData.date) - 1);
+                    schedule.routineData.date[sizeof(schedule.routineData.date) - 1] = '\0';
+                    changed = 1;
+                }
+
+                printf("New Time (%s): ", schedule.routineData.time);
+                if (!readLine(inputBuffer, sizeof(inputBuffer)))
+                    break;
+                trimWhitespace(inputBuffer);
+                if (strlen(inputBuffer) > 0)
                 {
-                    strcpy(currentID, temp_s1);
+                    strncpy(schedule.routineData.time, inputBuffer, sizeof(schedule.routineData.time) - 1);
+                    schedule.routineData.time[sizeof(schedule.routineData.time) - 1] = '\0';
+                    changed = 1;
                 }
-                if (sscanf(trimmedLine, "Department: %99s", temp_s1) == 1)
+
+                printf("New Room (%s): ", schedule.routineData.room);
+                if (!readLine(inputBuffer, sizeof(inputBuffer)))
+                    break;
+                trimWhitespace(inputBuffer);
+                if (strlen(inputBuffer) > 0)
                 {
-                    strcpy(currentDept, temp_s1);
+                    strncpy(schedule.routineData.room, inputBuffer, sizeof(schedule.routineData.room) - 1);
+                    schedule.routineData.room[sizeof(schedule.routineData.room) - 1] = '\0';
+                    changed = 1;
                 }
-                if (strlen(currentID) > 0 && strlen(currentDept) > 0)
+
+                printf("New Faculty (%s): ", schedule.routineData.faculty);
+                if (!readLine(inputBuffer, sizeof(inputBuffer)))
+                    break;
+                trimWhitespace(inputBuffer);
+                if (strlen(inputBuffer) > 0)
                 {
-                    if (strcmp(currentID, deleteID) == 0 && strcmp(currentDept, departmentName) == 0)
-                    {
-                        found = 1;
-                        skipRecord = 1; 
-                    }
+                    strncpy(schedule.routineData.faculty, inputBuffer, sizeof(schedule.routineData.faculty) - 1);
+                    schedule.routineData.faculty[sizeof(schedule.routineData.faculty) - 1] = '\0';
+                    changed = 1;
                 }
             }
-        }
-        if (strlen(recordBuffer) > 0 && !skipRecord)
-        {
-            if (fputs(recordBuffer, tempFile) == EOF)
+            else
             {
-                perror("Error writing last record to temp file");
+                printf("New Details (Current: %s):\n", schedule.otherDetails);
+                if (!readLine(newOtherDetails, sizeof(newOtherDetails)))
+                    break;
+                trimWhitespace(newOtherDetails);
+                if (strlen(newOtherDetails) > 0)
+                {
+                    strncpy(schedule.otherDetails, newOtherDetails, sizeof(schedule.otherDetails) - 1);
+                    schedule.otherDetails[sizeof(schedule.otherDetails) - 1] = '\0';
+                    changed = 1;
+                }
             }
-        }
-        fclose(P_read);
-        fclose(tempFile);
-        if (found)
-        {
-            if (remove(originalFilename) != 0)
+            if (!changed)
             {
-                perror("Error deleting original student file");
-                fprintf(stderr, "Error: Original file could not be deleted. Temp data in '%s'\n", tempFilename);
+                printf("\nNo changes entered. Schedule not updated.\n");
             }
-            else if (rename(tempFilename, originalFilename) != 0)
+            else if (!confirmScheduleClashes(*scheduleFile_ptr, &schedule, recordPos))
             {
-                perror("Error renaming temp file to original");
-                fprintf(stderr, "CRITICAL Error: Original deleted, temp rename failed. Data potentially lost. Temp file is '%s'\n", tempFilename);
-
+                printf("Schedule not updated.\n");
             }
-            else
+            else if (updateScheduleRecord(*scheduleFile_ptr, recordPos, &schedule) >= 0)
             {
-                printf("\nStudent deleted successfully.\n");
+                printf("\nSchedule entry updated successfully.\n");
             }
         }
         else
         {
-            printf("\nStudent with ID '%s' not found in %s department. No changes made.\n", deleteID, departmentName);
-            remove(tempFilename); 
-        }
-        *P_ptr = fopen(originalFilename, "a+");
-        if (*P_ptr == NULL)
-        {
-            perror("FATAL: Could not reopen student file after delete operation");
-            exit(EXIT_FAILURE);
+            printf("\nSchedule entry not found for Intake '%s', Section '%s', Type '%s'.\n", searchIntake, searchSection, searchType);
         }
-        printf("\nOptions:\n1. Delete Another Student\n2. Back to %s Menu\n", departmentName);
-        printf("Enter your choice: ");
+        printf("\nOptions:\n1. Update Another Entry\n2. Back to Schedule Menu\nChoice: ");
         int choice;
-        if (scanf("%d", &choice) != 1)
+        if (scanInput("%d", &choice) != 1)
         {
             choice = 2;
             clearInputBuffer();
         }
         else
         {
-            clearInputBuffer();
+            clearInputBuffer(); 
         }
         if (choice != 1)
-            deleteMore = 0;
+            updateAnother = 0;
     }
 }
 
-void updateStudentById(FILE **P_ptr, const char *departmentName)
+void deleteSchedule(FILE **scheduleFile_ptr)
 {
-    int updateMore = 1;
-    while (updateMore)
+    if (*scheduleFile_ptr == NULL)
     {
-        system("clear || cls");
-        printf("\n--- Update Student Information in %s ---\n", departmentName);
-        printf("Enter Student ID to update: ");
-        char updateID[100];
-        if (!fgets(updateID, sizeof(updateID), stdin))
-        {
-            printf("Input error!\n");
-            continue;
-        }
-        trimWhitespace(updateID);
-
-        if (strlen(updateID) == 0)
-        {
-            printf("Update ID cannot be empty.\n");
-            pressEnterToContinue();
-            continue;
-        }
-
-        const char *originalFilename = "test.txt";
-        const char *tempFilename = "temp_student.tmp";
-
-        FILE *tempFile = fopen(tempFilename, "w");
-        if (tempFile == NULL)
-        {
-            perror("Error creating temporary file for update");
-            pressEnterToContinue();
-            return; 
-        }
-        if (*P_ptr != NULL)
-        {
-            fclose(*P_ptr);
-            *P_ptr = NULL;
-        }
-        FILE *P_read = fopen(originalFilename, "r");
-        if (P_read == NULL)
-        {
-            perror("Error opening student file for reading (update)");
-            fclose(tempFile);
-            remove(tempFilename);
-            *P_ptr = fopen(originalFilename, "a+"); 
-            if (*P_ptr == NULL)
-                exit(EXIT_FAILURE);
-            pressEnterToContinue();
-            return;
-        }
-
-        int found = 0;
-        char line[512];
-        char recordBuffer[2048] = "";
-        int recordMatches = 0; 
-        char name1[100], name2[100], father[100], mother[100];
-        char currentID[100], currentDept[100], intake[100], section[100];
-        char presentAddr[200], permanentAddr[200], blood[20];
-        char mobile[20], backupMobile[20], email[100];
-        recordBuffer[0] = '\0';
-        recordMatches = 0;
-        currentID[0] = '\0';
-        currentDept[0] = '\0'; 
-        while (fgets(line, sizeof(line), P_read))
-        {
-            char trimmedLine[512];
-            strcpy(trimmedLine, line);
-            trimWhitespace(trimmedLine);
-
-            if (strlen(trimmedLine) == 0)
-            { 
-                if (strlen(recordBuffer) > 0)
-                { 
-                    if (recordMatches)
-                    {
-                        found = 1;
-                        char *linePtr = recordBuffer;
-                        char blockLine[512];
-                        name1[0] = '\0';
-                        name2[0] = '\0';
-                        father[0] = '\0';
-                        mother[0] = '\0';
-                        intake[0] = '\0';
-                        section[0] = '\0';
-                        presentAddr[0] = '\0';
-                        permanentAddr[0] = '\0';
-                        blood[0] = '\0';
-                        mobile[0] = '\0';
-                        backupMobile[0] = '\0';
-                        email[0] = '\0';
-                        while (sscanf(linePtr, "%511[^\n]", blockLine) == 1)
-                        {
-                            char *nextNewline = strchr(linePtr, '\n');
-                            char temp_s1[200], temp_s2[100];
-                            if (sscanf(blockLine, "Student Name: %99s %99s", temp_s1, temp_s2) == 2)
-                            {
-                                strcpy(name1, temp_s1);
-                                strcpy(name2, temp_s2);
-                            }
-                            else if (sscanf(blockLine, "Father's name: %99[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(father, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Mother's name: %99[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(mother, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Intake: %99s", temp_s1) == 1)
-                            {
-                                strcpy(intake, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Section: %99s", temp_s1) == 1)
-                            {
-                                strcpy(section, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Present Address: %199[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(presentAddr, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Permanent Address: %199[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(permanentAddr, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Blood Group: %19[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(blood, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Mobile number: %19s", temp_s1) == 1)
-                            {
-                                strcpy(mobile, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Backup Mobile Number: %19s", temp_s1) == 1)
-                            {
-                                strcpy(backupMobile, temp_s1);
-                            }
-                            else if (sscanf(blockLine, "Email: %99[^\n]", temp_s1) == 1)
-                            {
-                                strcpy(email, temp_s1);
-                            }
-                            if (!nextNewline)
-                                break;
-                            linePtr = nextNewline + 1;
-                            if (*linePtr == '\0')
-                                break;
-                        }
-                        system("clear || cls"); 
-                        printf("\n--- Updating Student ID: %s (Dept: %s) ---\n", currentID, currentDept);
-                        printf("--- Enter new info or press Enter to keep current ---\n\n");
-                        char newName1[100], newName2[100], newFather[100], newMother[100];
-                        char newIntake[100], newSection[100], newPresentAddr[200], newPermanentAddr[200];
-                        char newBlood[20], newMobile[20], newBackupMobile[20], newEmail[100];
-                        printf("First Name (%s): ", name1);
-                        if (!fgets(newName1, sizeof(newName1), stdin))
-                            break;
-                        trimWhitespace(newName1);
-                        printf("Last Name (%s): ", name2);
-                        if (!fgets(newName2, sizeof(newName2), stdin))
-                            break;
-                        trimWhitespace(newName2);
-                        printf("Father's Name (%s): ", father);
-                        if (!fgets(newFather, sizeof(newFather), stdin))
-                            break;
-                        trimWhitespace(newFather);
-                        printf("Mother's Name (%s): ", mother);
-                        if (!fgets(newMother, sizeof(newMother), stdin))
-                            break;
-                        trimWhitespace(newMother);
-                        printf("Intake (%s): ", intake);
-                        if (!fgets(newIntake, sizeof(newIntake), stdin))
-                            break;
-                        trimWhitespace(newIntake);
-                        printf("Section (%s): ", section);
-                        if (!fgets(newSection, sizeof(newSection), stdin))
-                            break;
-                        trimWhitespace(newSection);
-                        printf("Present Address (%s): ", presentAddr);
-                        if (!fgets(newPresentAddr, sizeof(newPresentAddr), stdin))
-                            break;
-                        trimWhitespace(newPresentAddr);
-                        printf("Permanent Address (%s): ", permanentAddr);
-                        if (!fgets(newPermanentAddr, sizeof(newPermanentAddr), stdin))
-                            break;
-                        trimWhitespace(newPermanentAddr);
-                        printf("Blood Group (%s): ", blood);
-                        if (!fgets(newBlood, sizeof(newBlood), stdin))
-                            break;
-                        trimWhitespace(newBlood);
-                        printf("Mobile (%s): ", mobile);
-                        if (!fgets(newMobile, sizeof(newMobile), stdin))
-                            break;
-                        trimWhitespace(newMobile);
-                        printf("Backup Mobile (%s): ", backupMobile);
-                        if (!fgets(newBackupMobile, sizeof(newBackupMobile), stdin))
-                            break;
-                        trimWhitespace(newBackupMobile);
-                        printf("Email (%s): ", email);
-                        if (!fgets(newEmail, sizeof(newEmail), stdin))
-                            break;
-                        trimWhitespace(newEmail);
-                        fprintf(tempFile, "Student Name: %s %s\n", (strlen(newName1) > 0) ? newName1 : name1, (strlen(newName2) > 0) ? newName2 : name2);
-                        fprintf(tempFile, "Father's name: %s\n", (strlen(newFather) > 0) ? newFather : father);
-                        fprintf(tempFile, "Mother's name: %s\n", (strlen(newMother) > 0) ? newMother : mother);
-                        fprintf(tempFile, "Student ID: %s\n", currentID);  
-                        fprintf(tempFile, "Department: %s\n", currentDept); 
-                        fprintf(tempFile, "Intake: %s\n", (strlen(newIntake) > 0) ? newIntake : intake);
-                        fprintf(tempFile, "Section: %s\n", (strlen(newSection) > 0) ? newSection : section);
-                        fprintf(tempFile, "Present Address: %s\n", (strlen(newPresentAddr) > 0) ? newPresentAddr : presentAddr);
-                        fprintf(tempFile, "Permanent Address: %s\n", (strlen(newPermanentAddr) > 0) ? newPermanentAddr : permanentAddr);
-                        fprintf(tempFile, "Blood Group: %s\n", (strlen(newBlood) > 0) ? newBlood : blood);
-                        fprintf(tempFile, "Mobile number: %s\n", (strlen(newMobile) > 0) ? newMobile : mobile);
-                        fprintf(tempFile, "Backup Mobile Number: %s\n", (strlen(newBackupMobile) > 0) ? newBackupMobile : backupMobile);
-                        fprintf(tempFile, "Email: %s\n\n", (strlen(newEmail) > 0) ? newEmail : email); 
-                    }
-                    else
-                    {
-                        if (fputs(recordBuffer, tempFile) == EOF)
-                        {
-                            perror("Error writing unchanged record to temp file");
-                        }
-                    }
-                }
-                recordBuffer[0] = '\0';
-                recordMatches = 0;
-                currentID[0] = '\0';
-                currentDept[0] = '\0';
-                continue;
-            }
-            if (strlen(recordBuffer) + strlen(line) < sizeof(recordBuffer))
-            {
-                strcat(recordBuffer, line);
-            }
-            else
-            {
-                fprintf(stderr, "Warning: Record buffer overflow near ID %s during update.\n", currentID);
-            }
-            char temp_s1[100];
-            if (!recordMatches)
-            { 
-                if (sscanf(trimmedLine, "Student ID: %99s", temp_s1) == 1)
-                {
-                    strcpy(currentID, temp_s1);
-                }
-                if (sscanf(trimmedLine, "Department: %99s", temp_s1) == 1)
-                {
-                    strcpy(currentDept, temp_s1);
-                }
-                if (strlen(currentID) > 0 && strlen(currentDept) > 0)
-                {
-                    if (strcmp(currentID, updateID) == 0 && strcmp(currentDept, departmentName) == 0)
-                    {
-                        recordMatches = 1; 
-                    }
-                }
-            }
-        }
-        if (strlen(recordBuffer) > 0)
-        {
-            if (recordMatches)
-            {
-                found = 1;
-                char *linePtr = recordBuffer;
-                char blockLine[512];
-                name1[0] = '\0';
-                name2[0] = '\0';
-                father[0] = '\0';
-                mother[0] = '\0';
-                intake[0] = '\0';
-                section[0] = '\0';
-                presentAddr[0] = '\0';
-                permanentAddr[0] = '\0';
-                blood[0] = '\0';
-                mobile[0] = '\0';
-                backupMobile[0] = '\0';
-                email[0] = '\0';
-                while (sscanf(linePtr, "%511[^\n]", blockLine) == 1)
-                {
-                    char *nextNewline = strchr(linePtr, '\n');
-                    char temp_s1[200], temp_s2[100];
-                    if (sscanf(blockLine, "Student Name: %99s %99s", temp_s1, temp_s2) == 2)
-                    {
-                        strcpy(name1, temp_s1);
-                        strcpy(name2, temp_s2);
-                    }
-                    else if (sscanf(blockLine, "Father's name: %99[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(father, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Mother's name: %99[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(mother, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Intake: %99s", temp_s1) == 1)
-                    {
-                        strcpy(intake, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Section: %99s", temp_s1) == 1)
-                    {
-                        strcpy(section, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Present Address: %199[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(presentAddr, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Permanent Address: %199[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(permanentAddr, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Blood Group: %19[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(blood, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Mobile number: %19s", temp_s1) == 1)
-                    {
-                        strcpy(mobile, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Backup Mobile Number: %19s", temp_s1) == 1)
-                    {
-                        strcpy(backupMobile, temp_s1);
-                    }
-                    else if (sscanf(blockLine, "Email: %99[^\n]", temp_s1) == 1)
-                    {
-                        strcpy(email, temp_s1);
-                    }
-                    if (!nextNewline)
-                        break;
-                    linePtr = nextNewline + 1;
-                    if (*linePtr == '\0')
-                        break;
-                }
-                system("clear || cls");
-                printf("\n--- Updating Student ID: %s (Dept: %s) ---\n", currentID, currentDept);
-                printf("--- Enter new info or press Enter to keep current ---\n\n");
-                char newName1[100], newName2[100], newFather[100], newMother[100], newIntake[100], newSection[100], newPresentAddr[200], newPermanentAddr[200], newBlood[20], newMobile[20], newBackupMobile[20], newEmail[100];
-                printf("First Name (%s): ", name1);
-                if (!fgets(newName1, sizeof(newName1), stdin))
-                    break;
-                trimWhitespace(newName1);
-                printf("Last Name (%s): ", name2);
-                if (!fgets(newName2, sizeof(newName2), stdin))
-                    break;
-                trimWhitespace(newName2);
-                printf("Father's Name (%s): ", father);
-                if (!fgets(newFather, sizeof(newFather), stdin))
-                    break;
-                trimWhitespace(newFather);
-                printf("Mother's Name (%s): ", mother);
-                if (!fgets(newMother, sizeof(newMother), stdin))
-                    break;
-                trimWhitespace(newMother);
-                printf("Intake (%s): ", intake);
-                if (!fgets(newIntake, sizeof(newIntake), stdin))
-                    break;
-                trimWhitespace(newIntake);
-                printf("Section (%s): ", section);
-                if (!fgets(newSection, sizeof(newSection), stdin))
-                    break;
-                trimWhitespace(newSection);
-                printf("Present Address (%s): ", presentAddr);
-                if (!fgets(newPresentAddr, sizeof(newPresentAddr), stdin))
-                    break;
-                trimWhitespace(newPresentAddr);
-                printf("Permanent Address (%s): ", permanentAddr);
-                if (!fgets(newPermanentAddr, sizeof(newPermanentAddr), stdin))
-                    break;
-                trimWhitespace(newPermanentAddr);
-                printf("Blood Group (%s): ", blood);
-                if (!fgets(newBlood, sizeof(newBlood), stdin))
-                    break;
-                trimWhitespace(newBlood);
-                printf("Mobile (%s): ", mobile);
-                if (!fgets(newMobile, sizeof(newMobile), stdin))
-                    break;
-                trimWhitespace(newMobile);
-                printf("Backup Mobile (%s): ", backupMobile);
-                if (!fgets(newBackupMobile, sizeof(newBackupMobile), stdin))
-                    break;
-                trimWhitespace(newBackupMobile);
-                printf("Email (%s): ", email);
-                if (!fgets(newEmail, sizeof(newEmail), stdin))
-                    break;
-                trimWhitespace(newEmail);
-                fprintf(tempFile, "Student Name: %s %s\n", (strlen(newName1) > 0) ? newName1 : name1, (strlen(newName2) > 0) ? newName2 : name2);
-                fprintf(tempFile, "Father's name: %s\n", (strlen(newFather) > 0) ? newFather : father);
-                fprintf(tempFile, "Mother's name: %s\n", (strlen(newMother) > 0) ? newMother : mother);
-                fprintf(tempFile, "Student ID: %s\n", currentID);
-                fprintf(tempFile, "Department: %s\n", currentDept);
-                fprintf(tempFile, "Intake: %s\n", (strlen(newIntake) > 0) ? newIntake : intake);
-                fprintf(tempFile, "Section: %s\n", (strlen(newSection) > 0) ? newSection : section);
-                fprintf(tempFile, "Present Address: %s\n", (strlen(newPresentAddr) > 0) ? newPresentAddr : presentAddr);
-                fprintf(tempFile, "Permanent Address: %s\n", (strlen(newPermanentAddr) > 0) ? newPermanentAddr : permanentAddr);
-                fprintf(tempFile, "Blood Group: %s\n", (strlen(newBlood) > 0) ? newBlood : blood);
-                fprintf(tempFile, "Mobile number: %s\n", (strlen(newMobile) > 0) ? newMobile : mobile);
-                fprintf(tempFile, "Backup Mobile Number: %s\n", (strlen(newBackupMobile) > 0) ? newBackupMobile : backupMobile);
-                fprintf(tempFile, "Email: %s\n\n", (strlen(newEmail) > 0) ? newEmail : email);
-            }
-            else
-            {
-                if (fputs(recordBuffer, tempFile) == EOF)
-                {
-                    perror("Error writing last unchanged record to temp file");
-                }
-            }
-        }
+        reportError("ERROR: Schedule file is not open in deleteSchedule.\n");
+        pressEnterToContinue();
+        return;
+    }
 
-        fclose(P_read);
-        fclose(tempFile);
-        if (found)
+    char deleteIntake[20], deleteSection[20], deleteType[50];
+    int found = 0;
+    int deleteAnother = 1;
+
+    while (deleteAnother)
+    {
+        clearScreen();
+        printf("\n--- Delete Specific Schedule Entry ---\n");
+        printf("Enter Intake of schedule to delete: ");
+        if (!readLine(deleteIntake, sizeof(deleteIntake)))
         {
-            if (remove(originalFilename) != 0)
-            {
-                perror("Error deleting original file during update");
-                fprintf(stderr, "Temp data in '%s'\n", tempFilename);
-            }
-            else if (rename(tempFilename, originalFilename) != 0)
-            {
-                perror("Error renaming temp file during update");
-                fprintf(stderr, "CRITICAL Error: Original deleted, rename failed. Data lost. Temp file '%s'\n", tempFilename);
-            }
-            else
-            {
-                printf("\nStudent updated successfully!\n");
-            }
+            printf("Input error!\n");
+            continue;
         }
-        else
+        trimWhitespace(deleteIntake);
+        printf("Enter Section: ");
+        if (!readLine(deleteSection, sizeof(deleteSection)))
         {
-            printf("\nStudent with ID '%s' not found in %s department. No changes made.\n", updateID, departmentName);
-            remove(tempFilename); 
+            printf("Input error!\n");
+            continue;
         }
-        *P_ptr = fopen(originalFilename, "a+");
-        if (*P_ptr == NULL)
+        trimWhitespace(deleteSection);
+        printf("Enter Schedule Type to delete: ");
+        if (!readLine(deleteType, sizeof(deleteType)))
         {
-            perror("FATAL: Could not reopen student file after update");
-            exit(EXIT_FAILURE);
+            printf("Input error!\n");
+            continue;
         }
-        printf("\nOptions:\n1. Update Another Student\n2. Back to %s Menu\n", departmentName);
-        printf("Enter your choice: ");
+        trimWhitespace(deleteType);
+
+        if (strlen(deleteIntake) == 0 || strlen(deleteSection) == 0 || strlen(deleteType) == 0)
+        {
+            printf("All fields (Intake, Section, Type) required.\n");
+            pressEnterToContinue();
+            continue;
+        }
+        struct AcademicSchedule key;
+        memset(&key, 0, sizeof(key));
+        strcpy(key.intake, deleteIntake);
+        strcpy(key.section, deleteSection);
+        strcpy(key.scheduleType, deleteType);
+        found = deleteScheduleRecords(*scheduleFile_ptr, &key);
+        if (found > 0)
+            printf("\nSchedule entry deleted successfully.\n");
+        else if (found == 0)
+            printf("\nSchedule entry not found. No changes made.\n");
+        printf("\nOptions:\n1. Delete Another Entry\n2. Back to Schedule Menu\nChoice: ");
         int choice;
-        if (scanf("%d", &choice) != 1)
+        if (scanInput("%d", &choice) != 1)
         {
             choice = 2;
             clearInputBuffer();
@@ -2135,1319 +7848,2230 @@ void updateStudentById(FILE **P_ptr, const char *departmentName)
             clearInputBuffer();
         }
         if (choice != 1)
-            updateMore = 0;
+            deleteAnother = 0;
     }
 }
-int isRoutineType(const char *scheduleType)
+
+void viewScheduleClashes(FILE **scheduleFile_ptr)
 {
-    return (strcmp(scheduleType, "Class Routine") == 0 ||
-            strcmp(scheduleType, "Mid Exam Routine") == 0 ||
-            strcmp(scheduleType, "Final Exam Routine") == 0);
+    if (*scheduleFile_ptr == NULL)
+    {
+        reportError("ERROR: Schedule file is not open in viewScheduleClashes.\n");
+        pressEnterToContinue();
+        return;
+    }
+    struct ScheduleClash *clashes;
+
+    clearScreen();
+    printf("\n--- Room and Faculty Clash Report ---\n\n");
+    long count = collectScheduleClashes(*scheduleFile_ptr, &clashes);
+    if (count < 0)
+        return;
+    if (count == 0)
+        printf("No room or faculty is booked twice at the same time.\n");
+    for (long i = 0; i < count; i++)
+        printScheduleClash(&clashes[i], 1);
+    if (count > 0)
+        printf("\n%ld clash%s found.\n", count, count == 1 ? "" : "es");
+    free(clashes);
 }
 
-void manageAcademicSchedules(FILE **scheduleFile_ptr)
+void viewTimetable(FILE **scheduleFile_ptr)
 {
-    int scheduleRunning = 1;
+    if (*scheduleFile_ptr == NULL)
+    {
+        reportError("ERROR: Schedule file is not open in viewTimetable.\n");
+        pressEnterToContinue();
+        return;
+    }
+    char room[20], faculty[100], day[30], when[64];
+    long long ranges[8][2];
+    struct TimetableEntry *entries;
+
+    clearScreen();
+    printf("\n--- Room, Faculty and Day Timetable ---\n");
+    printf("Room (blank for any): ");
+    if (!readLine(room, sizeof(room)))
+        return;
+    trimWhitespace(room);
+    printf("Faculty (blank for any): ");
+    if (!readLine(faculty, sizeof(faculty)))
+        return;
+    trimWhitespace(faculty);
+    printf("Day or date (blank for all): ");
+    if (!readLine(day, sizeof(day)))
+        return;
+    trimWhitespace(day);
+    if (timetableRanges(day, ranges) == 0)
+    {
+        printf("'%s' is not a weekday or a date.\n", day);
+        return;
+    }
+    long count = fetchTimetable(*scheduleFile_ptr, room, faculty, day, &entries);
+    if (count < 0)
+        return;
+    if (count == 0)
+    {
+        printf("\nNo routine entries found matching criteria.\n");
+        return;
+    }
+    printf("\n%-24s %-8s %-8s %-20s %-10s %s\n", "When", "Intake", "Section", "Type", "Room", "Faculty");
+    for (long i = 0; i < count; i++)
+    {
+        const struct AcademicSchedule *schedule = &entries[i].schedule;
+        formatBookingTime(entries[i].start, entries[i].end, when, sizeof(when));
+        printf("%-24s %-8s %-8s %-20s %-10s %s\n", when, schedule->intake, schedule->section, schedule->scheduleType,
+               schedule->routineData.room, schedule->routineData.faculty);
+    }
+    printf("\n%ld entr%s found.\n", count, count == 1 ? "y" : "ies");
+    free(entries);
+}
+
+void viewFacultyLoad(FILE **scheduleFile_ptr)
+{
+    if (*scheduleFile_ptr == NULL)
+    {
+        reportError("ERROR: Schedule file is not open in viewFacultyLoad.\n");
+        pressEnterToContinue();
+        return;
+    }
+    char faculty[100];
+    struct FacultyLoad *loads;
+
+    clearScreen();
+    printf("\n--- Faculty Teaching Load ---\n");
+    printf("Faculty (blank for all): ");
+    if (!readLine(faculty, sizeof(faculty)))
+        return;
+    trimWhitespace(faculty);
+    long count = collectFacultyLoad(*scheduleFile_ptr, faculty, &loads);
+    if (count < 0)
+        return;
+    if (count == 0)
+    {
+        printf("\nNo weekly classes found matching criteria.\n");
+        return;
+    }
+    printf("\n%-40s %8s %12s\n", "Faculty", "Classes", "Hours/Week");
+    for (long i = 0; i < count; i++)
+        printf("%-40s %8ld %12.2f\n", loads[i].faculty, loads[i].classes, loads[i].minutes / 60.0);
+    free(loads);
+}
+
+void manageResults(FILE **resultFile_ptr)
+{
+    int resultRunning = 1;
     int select;
-    while (scheduleRunning)
+    while (resultRunning)
     {
-        system("clear || cls");
-        printf("\n\n--- Academic Schedule Management ---\n");
-        printf("1. Add New Schedule Entry\n");
-        printf("2. View All Schedules for Intake & Section\n");
-        printf("3. Update Specific Schedule Entry\n");
-        printf("4. Delete Specific Schedule Entry\n");
-        printf("5. Back to Main Menu\n");
-        printf("\nEnter Choice: ");
+        clearScreen();
+        printf("\n\n--- Result Publication Management ---\n");
+        printf("1. Add Student Result\n");
+        printf("2. View Individual Result\n");
+        printf("3. View Merit List\n");
+        printf("4. Update Student Result\n");
+        printf("5. Delete Student Result\n");
+        printf("6. Import Results from CSV\n");
+        printf("7. GPA Statistics\n");
+        printf("8. Back to Main Menu\n");
+        printf("\nEnter Choice (1-8): ");
 
-        if (scanf("%d", &select) != 1)
+        if (scanInput("%d", &select) != 1)
         {
-            printf("Invalid input. Please enter a number (1-5).\n");
+            printf("Invalid input.\n");
             clearInputBuffer();
             pressEnterToContinue();
             continue;
         }
-        clearInputBuffer(); 
-        if (*scheduleFile_ptr == NULL)
+        clearInputBuffer();
+        if (*resultFile_ptr == NULL)
         {
-            fprintf(stderr, "ERROR: Schedule file pointer is NULL in manageAcademicSchedules.\n");
-            *scheduleFile_ptr = fopen("schedules.dat", "rb+");
-            if (*scheduleFile_ptr == NULL)
-                *scheduleFile_ptr = fopen("schedules.dat", "wb+");
-            if (*scheduleFile_ptr == NULL)
+            reportError("ERROR: Result file pointer is NULL in manageResults.\n");
+            *resultFile_ptr = fopen("results.dat", "rb+");
+            if (*resultFile_ptr == NULL)
+                *resultFile_ptr = fopen("results.dat", "wb+");
+            if (*resultFile_ptr == NULL)
             {
-                perror("FATAL: Schedule file is inaccessible");
+                reportSystemError("FATAL: Result file inaccessible");
                 exit(EXIT_FAILURE);
             }
-            printf("INFO: Schedule file pointer was reopened.\n");
+            printf("INFO: Result file pointer was reopened.\n");
         }
 
+        static const char *const resultOperations[] = {NULL, "addResult", "viewIndividualResult", "viewResultList",
+                                                       "updateResult", "deleteResult", "importResults",
+                                                       "viewResultStatistics"};
+        struct OperationTimer timer;
+        const char *operation = select >= 1 && select <= 7 ? resultOperations[select] : NULL;
+        if (operation != NULL)
+            beginOperation(&timer, operation);
         switch (select)
         {
         case 1:
-            addSchedule(scheduleFile_ptr);
+            addResult(resultFile_ptr);
             break;
         case 2:
-            viewSchedule(scheduleFile_ptr);
+            viewIndividualResult(resultFile_ptr);
             break;
         case 3:
-            updateSchedule(scheduleFile_ptr);
+            viewResultList(resultFile_ptr);
             break;
         case 4:
-            deleteSchedule(scheduleFile_ptr);
+            updateResult(resultFile_ptr);
             break;
         case 5:
-            scheduleRunning = 0;
+            deleteResult(resultFile_ptr);
+            break;
+        case 6:
+            importResults(resultFile_ptr);
+            break;
+        case 7:
+            viewResultStatistics(resultFile_ptr);
+            break;
+        case 8:
+            resultRunning = 0;
             break;
         default:
-            printf("Invalid choice (%d). Please enter 1-5.\n", select);
+            printf("Invalid choice (%d). Please enter 1-8.\n", select);
             break;
         }
-        if (scheduleRunning && select >= 1 && select <= 4)
+        if (operation != NULL)
+            endOperation(&timer);
+        if (resultRunning && select >= 1 && select <= 7)
         {
             pressEnterToContinue();
         }
     }
 }
 
-void addSchedule(FILE **scheduleFile_ptr)
+void addResult(FILE **resultFile_ptr)
 {
-    if (*scheduleFile_ptr == NULL)
+    if (*resultFile_ptr == NULL)
     {
-        fprintf(stderr, "ERROR: Schedule file is not open in addSchedule.\n");
+        reportError("ERROR: Result file is not open in addResult.\n");
         pressEnterToContinue();
         return;
     }
-    struct AcademicSchedule schedule;
-    int addMore = 1;
+    struct StudentResult result, existing;
+    int addMore = 1, exists;
     while (addMore)
     {
-        system("clear || cls");
-        printf("\n--- Add New Academic Schedule Entry ---\n");
-        memset(&schedule, 0, sizeof(struct AcademicSchedule));
-
-        printf("Enter Intake: ");
-        if (!fgets(schedule.intake, sizeof(schedule.intake), stdin))
-        {
-            printf("Input error!\n");
-            continue;
-        }
-        trimWhitespace(schedule.intake);
-
-        printf("Enter Section: ");
-        if (!fgets(schedule.section, sizeof(schedule.section), stdin))
-        {
-            printf("Input error!\n");
-            continue;
-        }
-        trimWhitespace(schedule.section);
-        printf("Select Schedule Type:\n");
-        printf("  1. Class Routine\n");
-        printf("  2. Mid Exam Routine\n");
-        printf("  3. Final Exam Routine\n");
-        printf("  4. Result Publication Date\n");
-        printf("  5. Other Event\n");
-        printf("Enter choice (1-5): ");
-        int typeChoice;
-        if (scanf("%d", &typeChoice) != 1 || typeChoice < 1 || typeChoice > 5)
-        {
-            printf("Invalid type choice. Defaulting to 'Other Event'.\n");
-            strcpy(schedule.scheduleType, "Other Event");
-            clearInputBuffer();
-        }
-        else
-        {
-            clearInputBuffer(); 
-            switch (typeChoice)
-            {
-            case 1:
-                strcpy(schedule.scheduleType, "Class Routine");
-                break;
-            case 2:
-                strcpy(schedule.scheduleType, "Mid Exam Routine");
-                break;
-            case 3:
-                strcpy(schedule.scheduleType, "Final Exam Routine");
-                break;
-            case 4:
-                strcpy(schedule.scheduleType, "Result Publication Date");
-                break;
-            case 5:
-                strcpy(schedule.scheduleType, "Other Event");
-                break;
-            }
-        }
-        if (isRoutineType(schedule.scheduleType))
-        {
-            printf("\n--- Enter %s Details ---\n", schedule.scheduleType);
-            printf("Day(s) (e.g., Sunday or Mon-Wed): ");
-            if (!fgets(schedule.routineData.day, sizeof(schedule.routineData.day), stdin))
-            {
-                printf("Input error!\n");
-                continue;
-            }
-            trimWhitespace(schedule.routineData.day);
-
-            printf("Date(s) (e.g., 25/12/2023 or TBA): ");
-            if (!fgets(schedule.routineData.date, sizeof(schedule.routineData.date), stdin))
-            {
-                printf("Input error!\n");
-                continue;
-            }
-            trimWhitespace(schedule.routineData.date);
-
-            printf("Time (e.g., 10:00 AM - 11:30 AM): ");
-            if (!fgets(schedule.routineData.time, sizeof(schedule.routineData.time), stdin))
-            {
-                printf("Input error!\n");
-                continue;
-            }
-            trimWhitespace(schedule.routineData.time);
-
-            printf("Room/Platform (e.g., 501 or Online): ");
-            if (!fgets(schedule.routineData.room, sizeof(schedule.routineData.room), stdin))
-            {
-                printf("Input error!\n");
-                continue;
-            }
-            trimWhitespace(schedule.routineData.room);
-
-            printf("Faculty/Instructor (e.g., Dr. Smith or TBA): ");
-            if (!fgets(schedule.routineData.faculty, sizeof(schedule.routineData.faculty), stdin))
-            {
-                printf("Input error!\n");
-                continue;
-            }
-            trimWhitespace(schedule.routineData.faculty);
+        clearScreen();
+        printf("\n--- Add New Student Result ---\n");
+        memset(&result, 0, sizeof(struct StudentResult));
 
-            schedule.otherDetails[0] = '\0'; 
-        }
-        else
-        { 
-            printf("Enter Details for '%s':\n", schedule.scheduleType);
-            if (!fgets(schedule.otherDetails, sizeof(schedule.otherDetails), stdin))
-            {
-                printf("Input error!\n");
-                continue;
-            }
-            trimWhitespace(schedule.otherDetails);
-            schedule.routineData.day[0] = '\0';
-            schedule.routineData.date[0] = '\0';
-            schedule.routineData.time[0] = '\0';
-            schedule.routineData.room[0] = '\0';
-            schedule.routineData.faculty[0] = '\0';
-        }
-        int isValid = 1;
-        if (strlen(schedule.intake) == 0)
-        {
-            printf("Error: Intake is required.\n");
-            isValid = 0;
-        }
-        if (strlen(schedule.section) == 0)
-        {
-            printf("Error: Section is required.\n");
-            isValid = 0;
-        }
-        if (strlen(schedule.scheduleType) == 0)
-        {
-            printf("Error: Schedule Type is required.\n");
-            isValid = 0;
-        }
-        if (isRoutineType(schedule.scheduleType))
+        printf("Enter Student ID: ");
+        if (!readLine(result.studentID, sizeof(result.studentID)))
+            continue;
+        trimWhitespace(result.studentID);
+        printf("Enter Student Name: ");
+        if (!readLine(result.name, sizeof(result.name)))
+            continue;
+        trimWhitespace(result.name);
+        printf("Enter Intake: ");
+        if (!readLine(result.intake, sizeof(result.intake)))
+            continue;
+        trimWhitespace(result.intake);
+        printf("Enter Section: ");
+        if (!readLine(result.section, sizeof(result.section)))
+            continue;
+        trimWhitespace(result.section);
+
+        printf("Enter GPA (0.0-4.0): ");
+        while (scanInput("%f", &result.gpa) != 1 || result.gpa < 0.0 || result.gpa > 4.0)
         {
-            if (strlen(schedule.routineData.day) == 0 || strlen(schedule.routineData.time) == 0 || strlen(schedule.routineData.room) == 0)
-            {
-                printf("Error: For routine types, Day, Time, and Room are required.\n");
-                isValid = 0;
-            }
+            printf("Invalid GPA. Enter 0.0-4.0: ");
+            clearInputBuffer(); 
         }
-        else
+        clearInputBuffer(); 
+
+        calculateGrade(result.gpa, result.grade);
+
+        if (strlen(result.studentID) == 0 || strlen(result.name) == 0 || strlen(result.intake) == 0 || strlen(result.section) == 0)
         {
-            if (strlen(schedule.otherDetails) == 0)
-            {
-                printf("Error: Details are required for this schedule type.\n");
-                isValid = 0;
-            }
+            printf("\nError: All fields (ID, Name, Intake, Section) are required.\n");
         }
-
-        if (isValid)
+        else if ((exists = fetchResultRecord(*resultFile_ptr, &result, &existing, NULL)) != 0)
         {
-            if (fseek(*scheduleFile_ptr, 0, SEEK_END) != 0)
-            {
-                perror("Error seeking to end of schedule file");
-            }
-            else
-            {
-                size_t written = fwrite(&schedule, sizeof(struct AcademicSchedule), 1, *scheduleFile_ptr);
-                fflush(*scheduleFile_ptr); 
-
-                if (written == 1)
-                {
-                    printf("\nSchedule entry added successfully.\n");
-                }
-                else
-                {
-                    perror("\nError writing schedule entry");
-                    clearerr(*scheduleFile_ptr);
-                }
-            }
+            if (exists > 0)
+                printf("\nError: A result for this ID, intake and section already exists. Use Update instead.\n");
         }
-        else
+        else if (saveResult(*resultFile_ptr, -1, NULL, &result))
         {
-            printf("Schedule not added due to missing required fields.\n");
+            printf("\nResult added successfully. Grade: %s\n", result.grade);
         }
-
-        printf("\nOptions:\n1. Add Another Entry\n2. Back to Schedule Menu\nChoice: ");
+        printf("\nOptions:\n1. Add Another Result\n2. Back to Result Menu\nChoice: ");
         int choice;
-        if (scanf("%d", &choice) != 1)
+        if (scanInput("%d", &choice) != 1)
         {
-            choice = 2; 
+            choice = 2;
             clearInputBuffer();
         }
         else
         {
-            clearInputBuffer(); 
+            clearInputBuffer();
         }
         if (choice != 1)
             addMore = 0;
     }
 }
 
-void viewSchedule(FILE **scheduleFile_ptr)
+void viewIndividualResult(FILE **resultFile_ptr)
 {
-    if (*scheduleFile_ptr == NULL)
+    if (*resultFile_ptr == NULL)
     {
-        fprintf(stderr, "ERROR: Schedule file is not open in viewSchedule.\n");
+        reportError("ERROR: Result file is not open in viewIndividualResult.\n");
         pressEnterToContinue();
         return;
     }
-    struct AcademicSchedule schedule;
-    struct AcademicSchedule foundSchedules[200]; 
-    int count = 0;
-    char searchIntake[20], searchSection[20];
-    int printedFlags[200] = {0}; 
-    const char *displayOrder[] = {
-        "Class Routine", "Mid Exam Routine", "Final Exam Routine",
-        "Result Publication Date", "Other Event", NULL};
+    struct StudentResult result;
+    char searchID[20], searchIntake[20], searchSection[20];
+    int found = 0;
 
-    system("clear || cls");
-    printf("\n--- View All Schedules for Intake & Section ---\n");
+    clearScreen();
+    printf("\n--- View Individual Student Result ---\n");
+    printf("Enter Student ID: ");
+    if (!readLine(searchID, sizeof(searchID)))
+        return;
+    trimWhitespace(searchID);
     printf("Enter Intake: ");
-    if (!fgets(searchIntake, sizeof(searchIntake), stdin))
-    {
-        printf("Input error!\n");
+    if (!readLine(searchIntake, sizeof(searchIntake)))
         return;
-    }
     trimWhitespace(searchIntake);
     printf("Enter Section: ");
-    if (!fgets(searchSection, sizeof(searchSection), stdin))
-    {
-        printf("Input error!\n");
+    if (!readLine(searchSection, sizeof(searchSection)))
         return;
-    }
     trimWhitespace(searchSection);
 
-    if (strlen(searchIntake) == 0 || strlen(searchSection) == 0)
+    if (strlen(searchID) == 0 || strlen(searchIntake) == 0 || strlen(searchSection) == 0)
     {
-        printf("Intake and Section required.\n");
+        printf("All search fields required.\n");
         return;
     }
 
-    rewind(*scheduleFile_ptr);
-    clearerr(*scheduleFile_ptr); 
-
-    count = 0; 
-    while (count < 200 && fread(&schedule, sizeof(struct AcademicSchedule), 1, *scheduleFile_ptr) == 1)
-    {
-        if (strcmp(schedule.intake, searchIntake) == 0 && strcmp(schedule.section, searchSection) == 0)
-        {
-            if (strlen(schedule.scheduleType) < sizeof(schedule.scheduleType) - 1)
-            {
-                foundSchedules[count++] = schedule;
-            }
-            else
-            {
-                fprintf(stderr, "Warning: Skipping potentially corrupt schedule record (long type field) at offset %ld.\n", ftell(*scheduleFile_ptr) - sizeof(struct AcademicSchedule));
-            }
-        }
-    }
-    if (ferror(*scheduleFile_ptr))
+    struct StudentResult key;
+    memset(&key, 0, sizeof(key));
+    strcpy(key.studentID, searchID);
+    strcpy(key.intake, searchIntake);
+    strcpy(key.section, searchSection);
+    printf("\n--- Result Details ---\n");
+    found = fetchResultRecord(*resultFile_ptr, &key, &result, NULL);
+    if (found > 0)
     {
-        perror("Error reading schedule file");
-        clearerr(*scheduleFile_ptr);
+        printf("\nStudent ID: %s\nName: %s\nIntake: %s\nSection: %s\nGPA: %.2f\nGrade: %s\n",
+               result.studentID, result.name, result.intake, result.section, result.gpa, result.grade);
+        printf("-----------------------------------\n");
     }
+    else if (found == 0)
+        printf("\nNo result found matching criteria.\n");
+}
 
-    if (count > 0)
+void viewResultList(FILE **resultFile_ptr)
+{
+    if (*resultFile_ptr == NULL)
     {
-        printf("\n\n***********************************************************************\n");
-        printf("         ACADEMIC SCHEDULE - Intake: %s, Section: %s\n", searchIntake, searchSection);
-        printf("***********************************************************************\n");
-        for (int orderIdx = 0; displayOrder[orderIdx] != NULL; ++orderIdx)
-        {
-            const char *currentType = displayOrder[orderIdx];
-            int typeFoundInSection = 0;
-
-            for (int i = 0; i < count; ++i)
-            {
-                if (!printedFlags[i] && strcmp(foundSchedules[i].scheduleType, currentType) == 0)
-                {
-                    if (!typeFoundInSection)
-                    { 
-                        printf("\n+---------------------------------------------------------------------+\n");
-                        printf("| %-67s |\n", currentType);
-                        printf("+---------------------------------------------------------------------+\n");
-                        typeFoundInSection = 1;
-                    }
-                    if (isRoutineType(currentType))
-                    {
-                        printf("| Day: %-61s |\n", foundSchedules[i].routineData.day);
-                        printf("| Date: %-60s |\n", foundSchedules[i].routineData.date);
-                        printf("| Time: %-60s |\n", foundSchedules[i].routineData.time);
-                        printf("| Room: %-60s |\n", foundSchedules[i].routineData.room);
-                        printf("| Faculty: %-57s |\n", foundSchedules[i].routineData.faculty);
-                    }
-                    else
-                    {
-                        printf("| Details: %-58.58s |\n", foundSchedules[i].otherDetails);
-                        if (strlen(foundSchedules[i].otherDetails) > 58)
-                        {
-                            printf("| %-67s |\n", "... (details may be longer)");
-                        }
-                    }
-                    printf("|---------------------------------------------------------------------|\n"); 
-                    printedFlags[i] = 1;
-                }
-            }
-            if (typeFoundInSection)
-            { 
-
-            }
-        }
-        int othersFoundHeader = 0;
-        for (int i = 0; i < count; ++i)
-        {
-            if (!printedFlags[i])
-            {
-                if (!othersFoundHeader)
-                {
-                    printf("\n+---------------------------------------------------------------------+\n");
-                    printf("| %-67s |\n", "Other Schedule Entries");
-                    printf("+---------------------------------------------------------------------+\n");
-                    othersFoundHeader = 1;
-                }
-                printf("| Type: %-60s |\n", foundSchedules[i].scheduleType);
-                if (isRoutineType(foundSchedules[i].scheduleType))
-                {
-                    printf("| Day: %-61s |\n", foundSchedules[i].routineData.day);
-                    printf("| Date: %-60s |\n", foundSchedules[i].routineData.date);
-                    printf("| Time: %-60s |\n", foundSchedules[i].routineData.time);
-                    printf("| Room: %-60s |\n", foundSchedules[i].routineData.room);
-                    printf("| Faculty: %-57s |\n", foundSchedules[i].routineData.faculty);
-                }
-                else
-                {
-                    printf("| Details: %-58.58s |\n", foundSchedules[i].otherDetails);
-                    if (strlen(foundSchedules[i].otherDetails) > 58)
-                    {
-                        printf("| %-67s |\n", "... (details may be longer)");
-                    }
-                }
-                printf("|---------------------------------------------------------------------|\n");
-                printedFlags[i] = 1;
-            }
-        }
+        reportError("ERROR: Result file is not open in viewResultList.\n");
+        pressEnterToContinue();
+        return;
+    }
+    char searchIntake[20], searchSection[20], topText[20];
+    struct RankedResult *ranked;
 
+    clearScreen();
+    printf("\n--- Merit List by Intake & Section ---\n");
+    printf("Enter Intake: ");
+    if (!readLine(searchIntake, sizeof(searchIntake)))
+        return;
+    trimWhitespace(searchIntake);
+    printf("Enter Section (blank for all sections): ");
+    if (!readLine(searchSection, sizeof(searchSection)))
+        return;
+    trimWhitespace(searchSection);
+    printf("Show top (blank for everyone): ");
+    if (!readLine(topText, sizeof(topText)))
+        return;
+    trimWhitespace(topText);
 
-        printf("\n***********************************************************************\n");
+    char *end;
+    long topK = strlen(topText) > 0 ? strtol(topText, &end, 10) : 0;
+    if (strlen(searchIntake) == 0)
+    {
+        printf("Intake required.\n");
+        return;
     }
+    if (strlen(topText) > 0 && (*end != '\0' || topK <= 0))
+    {
+        printf("Invalid number '%s'.\n", topText);
+        return;
+    }
+    int allSections = strlen(searchSection) == 0;
+    long count = rankResults(*resultFile_ptr, searchIntake, allSections ? NULL : searchSection, topK, &ranked);
+    if (count < 0)
+        return;
+
+    if (allSections)
+        printf("\n--- Merit List for Intake: %s, All Sections ---\n\n", searchIntake);
     else
+        printf("\n--- Merit List for Intake: %s, Section: %s ---\n\n", searchIntake, searchSection);
+    printf("%-6s %-15s %-25s %-8s %-8s %-8s\n", "Rank", "Student ID", "Name", "Section", "GPA", "Grade");
+    printf("----------------------------------------------------------------------------\n");
+    for (long i = 0; i < count; i++)
     {
-        printf("\nNo schedules found matching Intake '%s' and Section '%s'.\n", searchIntake, searchSection);
+        const struct StudentResult *r = &ranked[i].result;
+        printf("%-6ld %-15s %-25s %-8s %-8.2f %-8s\n", ranked[i].rank, r->studentID, r->name, r->section, r->gpa, r->grade);
     }
+    printf("----------------------------------------------------------------------------\n");
+    if (count == 0)
+        printf("\nNo results found matching criteria.\n");
+    free(ranked);
 }
 
-void updateSchedule(FILE **scheduleFile_ptr)
+void updateResult(FILE **resultFile_ptr)
 {
-    if (*scheduleFile_ptr == NULL)
+    if (*resultFile_ptr == NULL)
     {
-        fprintf(stderr, "ERROR: Schedule file is not open in updateSchedule.\n");
+        reportError("ERROR: Result file is not open in updateResult.\n");
         pressEnterToContinue();
         return;
     }
-
-    struct AcademicSchedule schedule; 
-    char searchIntake[20], searchSection[20], searchType[50];
+    struct StudentResult result; 
+    char searchID[20], searchIntake[20], searchSection[20];
     int found = 0;
-    long recordPos = -1; 
+    long recordPos = -1;
+    float newGPA;
     int updateAnother = 1;
 
     while (updateAnother)
     {
-        system("clear || cls");
-        printf("\n--- Update Specific Schedule Entry ---\n");
-        printf("Enter Intake of the schedule to update: ");
-        if (!fgets(searchIntake, sizeof(searchIntake), stdin))
-        {
-            printf("Input error!\n");
+        clearScreen();
+        printf("\n--- Update Student Result ---\n");
+        printf("Enter Student ID: ");
+        if (!readLine(searchID, sizeof(searchID)))
+            continue;
+        trimWhitespace(searchID);
+        printf("Enter Intake: ");
+        if (!readLine(searchIntake, sizeof(searchIntake)))
             continue;
-        }
         trimWhitespace(searchIntake);
-
         printf("Enter Section: ");
-        if (!fgets(searchSection, sizeof(searchSection), stdin))
-        {
-            printf("Input error!\n");
+        if (!readLine(searchSection, sizeof(searchSection)))
             continue;
-        }
         trimWhitespace(searchSection);
 
-        printf("Enter Schedule Type to update: ");
-        if (!fgets(searchType, sizeof(searchType), stdin))
-        {
-            printf("Input error!\n");
-            continue;
-        }
-        trimWhitespace(searchType);
-
-        if (strlen(searchIntake) == 0 || strlen(searchSection) == 0 || strlen(searchType) == 0)
-        {
-            printf("All search fields (Intake, Section, Type) are required.\n");
-            pressEnterToContinue();
-            continue;
-        }
-
-        rewind(*scheduleFile_ptr);
-        clearerr(*scheduleFile_ptr);
-
-        found = 0;
-        recordPos = -1;
-        while ((recordPos = ftell(*scheduleFile_ptr)) != -1 &&
-               fread(&schedule, sizeof(struct AcademicSchedule), 1, *scheduleFile_ptr) == 1)
-        {
-            if (strcmp(schedule.intake, searchIntake) == 0 &&
-                strcmp(schedule.section, searchSection) == 0 &&
-                strcmp(schedule.scheduleType, searchType) == 0)
-            {
-                found = 1;
-                break; 
-            }
-        }
-        if (!found && ferror(*scheduleFile_ptr))
+        if (strlen(searchID) == 0 || strlen(searchIntake) == 0 || strlen(searchSection) == 0)
         {
-            perror("Error reading schedule file during update search");
-            clearerr(*scheduleFile_ptr);
+            printf("All search fields required.\n");
             pressEnterToContinue();
             continue;
         }
 
-        if (found)
-        {
-            printf("\n--- Found Schedule Entry ---");
-            printf("\nIntake: %s, Section: %s, Type: %s", schedule.intake, schedule.section, schedule.scheduleType);
-
-            if (isRoutineType(schedule.scheduleType))
-            {
-                printf("\nCurrent Day: %s", schedule.routineData.day);
-                printf("\nCurrent Date: %s", schedule.routineData.date);
-                printf("\nCurrent Time: %s", schedule.routineData.time);
-                printf("\nCurrent Room: %s", schedule.routineData.room);
-                printf("\nCurrent Faculty: %s", schedule.routineData.faculty);
-            }
-            else
-            {
-                printf("\nCurrent Details:\n%s", schedule.otherDetails);
-            }
-
-            printf("\n\n--- Enter New Details (Press Enter to keep current) ---\n");
-            struct RoutineInfo newRoutineData; 
-            char newOtherDetails[500];
-            char inputBuffer[512]; 
-            int changed = 0;
-            if (isRoutineType(schedule.scheduleType))
-            {
-                printf("New Day (%s): ", schedule.routineData.day);
-                if (!fgets(inputBuffer, sizeof(inputBuffer), stdin))
-                    break;
-                trimWhitespace(inputBuffer);
-                if (strlen(inputBuffer) > 0)
-                {
-                    strncpy(schedule.routineData.day, inputBuffer, sizeof(schedule.routineData.day) - 1);
-                    schedule.routineData.day[sizeof(schedule.routineData.day) - 1] = '\0';
-                    changed = 1;
-                }
-
-                printf("New Date (%s): ", schedule.routineData.date);
-                if (!fgets(inputBuffer, sizeof(inputBuffer), stdin))
-                    break;
-                trimWhitespace(inputBuffer);
-                if (strlen(inputBuffer) > 0)
-                {
-                    strncpy(schedule.routineData.date, inputBuffer, sizeof(schedule.routineData.date) - 1);
-                    schedule.routineData.date[sizeof(schedule.routineData.date) - 1] = '\0';
-                    changed = 1;
-                }
-
-                printf("New Time (%s): ", schedule.routineData.time);
-                if (!fgets(inputBuffer, sizeof(inputBuffer), stdin))
-                    break;
-                trimWhitespace(inputBuffer);
-                if (strlen(inputBuffer) > 0)
-                {
-                    strncpy(schedule.routineData.time, inputBuffer, sizeof(schedule.routineData.time) - 1);
-                    schedule.routineData.time[sizeof(schedule.routineData.time) - 1] = '\0';
-                    changed = 1;
-                }
-
-                printf("New Room (%s): ", schedule.routineData.room);
-                if (!fgets(inputBuffer, sizeof(inputBuffer), stdin))
-                    break;
-                trimWhitespace(inputBuffer);
-                if (strlen(inputBuffer) > 0)
-                {
-                    strncpy(schedule.routineData.room, inputBuffer, sizeof(schedule.routineData.room) - 1);
-                    schedule.routineData.room[sizeof(schedule.routineData.room) - 1] = '\0';
-                    changed = 1;
-                }
+        struct StudentResult key;
+        memset(&key, 0, sizeof(key));
+        strcpy(key.studentID, searchID);
+        strcpy(key.intake, searchIntake);
+        strcpy(key.section, searchSection);
+        recordPos = -1;
+        found = fetchResultRecord(*resultFile_ptr, &key, &result, &recordPos);
+        if (found < 0)
+        {
+            pressEnterToContinue();
+            continue;
+        }
 
-                printf("New Faculty (%s): ", schedule.routineData.faculty);
-                if (!fgets(inputBuffer, sizeof(inputBuffer), stdin))
-                    break;
-                trimWhitespace(inputBuffer);
-                if (strlen(inputBuffer) > 0)
-                {
-                    strncpy(schedule.routineData.faculty, inputBuffer, sizeof(schedule.routineData.faculty) - 1);
-                    schedule.routineData.faculty[sizeof(schedule.routineData.faculty) - 1] = '\0';
-                    changed = 1;
-                }
-            }
-            else
+        if (found)
+        {
+            printf("\n--- Found Result ---\n");
+            printf("Student: %s (%s)\n", result.name, result.studentID);
+            printf("Current GPA: %.2f, Grade: %s\n", result.gpa, result.grade);
+            printf("\nEnter New GPA (0.0 - 4.0): ");
+            while (scanInput("%f", &newGPA) != 1 || newGPA < 0.0 || newGPA > 4.0)
             {
-                printf("New Details (Current: %s):\n", schedule.otherDetails);
-                if (!fgets(newOtherDetails, sizeof(newOtherDetails), stdin))
-                    break;
-                trimWhitespace(newOtherDetails);
-                if (strlen(newOtherDetails) > 0)
-                {
-                    strncpy(schedule.otherDetails, newOtherDetails, sizeof(schedule.otherDetails) - 1);
-                    schedule.otherDetails[sizeof(schedule.otherDetails) - 1] = '\0';
-                    changed = 1;
-                }
+                printf("Invalid GPA (0.0-4.0): ");
+                clearInputBuffer();
             }
-            if (changed)
-            {
-                if (fseek(*scheduleFile_ptr, recordPos, SEEK_SET) != 0)
-                {
-                    perror("Error seeking back to record position for update");
-                }
-                else
-                {
-                    size_t written = fwrite(&schedule, sizeof(struct AcademicSchedule), 1, *scheduleFile_ptr);
-                    fflush(*scheduleFile_ptr); 
+            clearInputBuffer(); 
 
-                    if (written == 1)
-                    {
-                        printf("\nSchedule entry updated successfully.\n");
-                    }
-                    else
-                    {
-                        perror("\nError writing updated schedule entry");
-                        clearerr(*scheduleFile_ptr);
-                    }
-                }
-            }
-            else
+            struct StudentResult original = result;
+            result.gpa = newGPA;
+            calculateGrade(result.gpa, result.grade);
+            if (saveResult(*resultFile_ptr, recordPos, &original, &result))
             {
-                printf("\nNo changes entered. Schedule not updated.\n");
+                printf("\nResult updated. New GPA: %.2f, Grade: %s\n", result.gpa, result.grade);
             }
         }
         else
         {
-            printf("\nSchedule entry not found for Intake '%s', Section '%s', Type '%s'.\n", searchIntake, searchSection, searchType);
+            printf("\nResult not found for ID %s, Intake %s, Section %s.\n", searchID, searchIntake, searchSection);
         }
-        printf("\nOptions:\n1. Update Another Entry\n2. Back to Schedule Menu\nChoice: ");
+        printf("\nOptions:\n1. Update Another Result\n2. Back to Result Menu\nChoice: ");
         int choice;
-        if (scanf("%d", &choice) != 1)
+        if (scanInput("%d", &choice) != 1)
         {
             choice = 2;
             clearInputBuffer();
         }
         else
         {
-            clearInputBuffer(); 
+            clearInputBuffer();
         }
         if (choice != 1)
             updateAnother = 0;
     }
 }
 
-void deleteSchedule(FILE **scheduleFile_ptr)
+void deleteResult(FILE **resultFile_ptr)
 {
-    if (*scheduleFile_ptr == NULL)
+    if (*resultFile_ptr == NULL)
     {
-        fprintf(stderr, "ERROR: Schedule file is not open in deleteSchedule.\n");
+        reportError("ERROR: Result file is not open in deleteResult.\n");
         pressEnterToContinue();
         return;
     }
-
-    struct AcademicSchedule schedule; 
-    char deleteIntake[20], deleteSection[20], deleteType[50];
+    char deleteID[20], deleteIntake[20], deleteSection[20];
     int found = 0;
     int deleteAnother = 1;
 
-    const char *originalFilename = "schedules.dat";
-    const char *tempFilename = "temp_schedules.tmp";
-
     while (deleteAnother)
     {
-        system("clear || cls");
-        printf("\n--- Delete Specific Schedule Entry ---\n");
-        printf("Enter Intake of schedule to delete: ");
-        if (!fgets(deleteIntake, sizeof(deleteIntake), stdin))
-        {
-            printf("Input error!\n");
+        clearScreen();
+        printf("\n--- Delete Student Result ---\n");
+        printf("Enter Student ID: ");
+        if (!readLine(deleteID, sizeof(deleteID)))
+            continue;
+        trimWhitespace(deleteID);
+        printf("Enter Intake: ");
+        if (!readLine(deleteIntake, sizeof(deleteIntake)))
             continue;
-        }
         trimWhitespace(deleteIntake);
         printf("Enter Section: ");
-        if (!fgets(deleteSection, sizeof(deleteSection), stdin))
-        {
-            printf("Input error!\n");
+        if (!readLine(deleteSection, sizeof(deleteSection)))
             continue;
-        }
         trimWhitespace(deleteSection);
-        printf("Enter Schedule Type to delete: ");
-        if (!fgets(deleteType, sizeof(deleteType), stdin))
-        {
-            printf("Input error!\n");
-            continue;
-        }
-        trimWhitespace(deleteType);
 
-        if (strlen(deleteIntake) == 0 || strlen(deleteSection) == 0 || strlen(deleteType) == 0)
+        if (strlen(deleteID) == 0 || strlen(deleteIntake) == 0 || strlen(deleteSection) == 0)
         {
-            printf("All fields (Intake, Section, Type) required.\n");
+            printf("All fields required.\n");
             pressEnterToContinue();
             continue;
         }
-        if (fclose(*scheduleFile_ptr) != 0)
-        {
-            perror("Warning: Error closing main schedule file before delete");
-        }
-        *scheduleFile_ptr = NULL; 
-        FILE *scheduleFile_r = fopen(originalFilename, "rb");
-        FILE *tempScheduleFile_w = fopen(tempFilename, "wb");
-
-        if (scheduleFile_r == NULL || tempScheduleFile_w == NULL)
-        {
-            if (scheduleFile_r == NULL)
-                perror("Error opening original schedule file for reading (delete)");
-            if (tempScheduleFile_w == NULL)
-                perror("Error creating temporary schedule file (delete)");
-            if (scheduleFile_r)
-                fclose(scheduleFile_r);
-            if (tempScheduleFile_w)
-                fclose(tempScheduleFile_w);
-            remove(tempFilename);
-            *scheduleFile_ptr = fopen(originalFilename, "rb+");
-            if (*scheduleFile_ptr == NULL)
-                *scheduleFile_ptr = fopen(originalFilename, "wb+");
-            if (*scheduleFile_ptr == NULL)
-            {
-                perror("FATAL: Could not reopen schedule file");
-                exit(EXIT_FAILURE);
-            }
-            pressEnterToContinue();
-            return; 
-        }
-        found = 0; 
-        while (fread(&schedule, sizeof(struct AcademicSchedule), 1, scheduleFile_r) == 1)
-        {
-            if (strcmp(schedule.intake, deleteIntake) == 0 &&
-                strcmp(schedule.section, deleteSection) == 0 &&
-                strcmp(schedule.scheduleType, deleteType) == 0)
-            {
-                found = 1; 
-            }
-            else
-            {
-                if (fwrite(&schedule, sizeof(struct AcademicSchedule), 1, tempScheduleFile_w) != 1)
-                {
-                    perror("Error writing record to temp schedule file");
-                    break;
-                }
-            }
-        }
-        if (ferror(scheduleFile_r))
+        struct StudentResult key;
+        memset(&key, 0, sizeof(key));
+        strcpy(key.studentID, deleteID);
+        strcpy(key.intake, deleteIntake);
+        strcpy(key.section, deleteSection);
+        found = deleteResultRecord(*resultFile_ptr, &key);
+        if (found > 0)
+            printf("\nResult deleted successfully.\n");
+        else if (found == 0)
+            printf("\nResult not found. No changes made.\n");
+        printf("\nOptions:\n1. Delete Another Result\n2. Back to Result Menu\nChoice: ");
+        int choice;
+        if (scanInput("%d", &choice) != 1)
         {
-            perror("Error reading from original schedule file during delete");
+            choice = 2;
+            clearInputBuffer();
         }
-        fclose(scheduleFile_r);
-        fclose(tempScheduleFile_w);
-        if (found)
+        else
         {
-            if (remove(originalFilename) != 0)
-            {
-                perror("Error deleting original schedule file");
-                fprintf(stderr, "Temp data in '%s'\n", tempFilename);
-            }
-            else if (rename(tempFilename, originalFilename) != 0)
-            {
-                perror("Error renaming temp schedule file");
-                fprintf(stderr, "CRITICAL Error: Original deleted, rename failed. Data lost. Temp file '%s'\n", tempFilename);
-            }
-            else
-            {
-                printf("\nSchedule entry deleted successfully.\n");
-            }
+            clearInputBuffer();
         }
+        if (choice != 1)
+            deleteAnother = 0;
+    }
+}
+
+void importResults(FILE **resultFile_ptr)
+{
+    char path[512], mode[10];
+    clearScreen();
+    printf("\n--- Import Results from CSV ---\n");
+    printf("CSV file path (columns id, name, intake, section, gpa): ");
+    if (!readLine(path, sizeof(path)))
+        return;
+    trimWhitespace(path);
+    printf("Replace results that already exist? (y/n): ");
+    if (!readLine(mode, sizeof(mode)))
+        return;
+    trimWhitespace(mode);
+    if (strlen(path) == 0)
+    {
+        printf("No file given.\n");
+        return;
+    }
+    long added, updated, rejected;
+    int upsert = mode[0] == 'y' || mode[0] == 'Y';
+    if (importResultCsv(*resultFile_ptr, path, upsert, stdout, &added, &updated, &rejected))
+        printf("\nImported results: %ld added, %ld updated, %ld rows rejected.\n", added, updated, rejected);
+    else
+        printf("\nImport failed; no new results were added.\n");
+}
+
+void viewResultStatistics(FILE **resultFile_ptr)
+{
+    if (*resultFile_ptr == NULL)
+    {
+        reportError("ERROR: Result file is not open in viewResultStatistics.\n");
+        pressEnterToContinue();
+        return;
+    }
+    char searchIntake[20], searchSection[20];
+    char labels[GPA_HISTOGRAM_BUCKETS][16];
+    long long buckets[GPA_HISTOGRAM_BUCKETS], largest = 0;
+    struct GpaStats stats;
+
+    clearScreen();
+    printf("\n--- GPA Statistics by Intake & Section ---\n");
+    printf("Enter Intake: ");
+    if (!readLine(searchIntake, sizeof(searchIntake)))
+        return;
+    trimWhitespace(searchIntake);
+    printf("Enter Section (blank for all sections): ");
+    if (!readLine(searchSection, sizeof(searchSection)))
+        return;
+    trimWhitespace(searchSection);
+    if (strlen(searchIntake) == 0)
+    {
+        printf("Intake required.\n");
+        return;
+    }
+    int allSections = strlen(searchSection) == 0;
+    int found = collectGpaStats(*resultFile_ptr, searchIntake, allSections ? NULL : searchSection, &stats);
+    if (found < 0)
+        return;
+    if (found == 0)
+    {
+        printf("\nNo results found matching criteria.\n");
+        return;
+    }
+
+    if (allSections)
+        printf("\n--- GPA Statistics for Intake: %s, All Sections ---\n\n", searchIntake);
+    else
+        printf("\n--- GPA Statistics for Intake: %s, Section: %s ---\n\n", searchIntake, searchSection);
+    printf("Results: %lld\nMean GPA: %.2f\nMedian GPA: %.2f\nStandard Deviation: %.2f\n", stats.count,
+           stats.sum / 100.0 / stats.count, gpaStatsMedian(&stats), gpaStatsDeviation(&stats));
+    printf("\nGrade Distribution:\n");
+    for (int g = 0; g < GRADE_COUNT; g++)
+        printf("  %-3s %8lld  %5.1f%%\n", gradeNames[g], stats.grades[g], 100.0 * stats.grades[g] / stats.count);
+    gpaStatsHistogram(&stats, buckets, labels);
+    for (int i = 0; i < GPA_HISTOGRAM_BUCKETS; i++)
+        largest = buckets[i] > largest ? buckets[i] : largest;
+    printf("\nGPA Histogram:\n");
+    for (int i = 0; i < GPA_HISTOGRAM_BUCKETS; i++)
+    {
+        int width = (int)(buckets[i] * 40 / largest);
+        printf("  %-9s %8lld%s%.*s\n", labels[i], buckets[i], width > 0 ? "  " : "", width,
+               "########################################");
+    }
+}
+
+static const char *const departmentNames[] = {"CSE", "EEE", "BBA", "ENGLISH", NULL};
+static int commandError(const struct CommandContext *ctx, const char *format, ...)
+{
+    va_list args;
+    reportError("error\t%ld\t%s%s%s\t", ctx->line, ctx->area, ctx->action ? " " : "", ctx->action ? ctx->action : "");
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+    return 1;
+}
+
+static void commandWarning(const struct CommandContext *ctx, const char *format, ...)
+{
+    va_list args;
+    reportError("warning\t%ld\t%s%s%s\t", ctx->line, ctx->area, ctx->action ? " " : "", ctx->action ? ctx->action : "");
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+// Writes text as one TSV field: tabs, newlines and backslashes are escaped so every record stays one line.
+static void putTsv(const char *text, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (text[i] == '\t')
+            fputs("\\t", stdout);
+        else if (text[i] == '\n')
+            fputs("\\n", stdout);
+        else if (text[i] == '\\')
+            fputs("\\\\", stdout);
         else
+            putchar(text[i]);
+    }
+}
+
+static void printTsvRow(const char *const *fields, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (i > 0)
+            putchar('\t');
+        putTsv(fields[i], strlen(fields[i]));
+    }
+    putchar('\n');
+}
+
+static void printCommandOk(const struct CommandContext *ctx, const char *const *fields, int count)
+{
+    printf("ok\t%s %s", ctx->area, ctx->action);
+    for (int i = 0; i < count; i++)
+    {
+        putchar('\t');
+        putTsv(fields[i], strlen(fields[i]));
+    }
+    putchar('\n');
+}
+
+static const char *commandOption(const struct CommandContext *ctx, const char *name)
+{
+    for (int i = 0; i + 1 < ctx->argc; i += 2)
+    {
+        if (strcmp(ctx->argv[i] + 2, name) == 0)
+            return ctx->argv[i + 1];
+    }
+    return NULL;
+}
+
+static int isListed(const char *const *list, const char *name)
+{
+    for (int i = 0; list[i] != NULL; i++)
+    {
+        if (strcmp(list[i], name) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+// Options must come as "--name value" pairs and name one of the words in allowed.
+static int checkCommandOptions(const struct CommandContext *ctx, const char *allowed)
+{
+    for (int i = 0; i < ctx->argc; i += 2)
+    {
+        const char *name = ctx->argv[i] + 2;
+        size_t len = strlen(name);
+        const char *word = allowed;
+        int known = 0;
+        if (strncmp(ctx->argv[i], "--", 2) != 0 || len == 0 || i + 1 >= ctx->argc)
         {
-            printf("\nSchedule entry not found. No changes made.\n");
-            remove(tempFilename); 
+            commandError(ctx, "expected --option value, got '%s'", ctx->argv[i]);
+            return 0;
         }
-        *scheduleFile_ptr = fopen(originalFilename, "rb+"); 
-        if (*scheduleFile_ptr == NULL)
-            *scheduleFile_ptr = fopen(originalFilename, "wb+");
-        if (*scheduleFile_ptr == NULL)
+        while (!known && (word = strstr(word, name)) != NULL)
         {
-            perror("FATAL: Could not reopen schedule file after delete");
-            exit(EXIT_FAILURE);
+            known = (word == allowed || word[-1] == ' ') && (word[len] == ' ' || word[len] == '\0');
+            word += len > 0 ? len : 1;
         }
-        printf("\nOptions:\n1. Delete Another Entry\n2. Back to Schedule Menu\nChoice: ");
-        int choice;
-        if (scanf("%d", &choice) != 1)
+        if (!known)
         {
-            choice = 2;
-            clearInputBuffer();
+            commandError(ctx, "unknown option --%s (accepts: %s)", name, allowed);
+            return 0;
         }
-        else
+    }
+    return 1;
+}
+
+// Copies an option into a fixed-width field; a missing option leaves dest as it was.
+static int copyOption(const struct CommandContext *ctx, const char *name, char *dest, size_t destSize)
+{
+    const char *value = commandOption(ctx, name);
+    if (value == NULL)
+        return 1;
+    if (strlen(value) >= destSize)
+    {
+        commandError(ctx, "--%s is longer than %zu characters", name, destSize - 1);
+        return 0;
+    }
+    strcpy(dest, value);
+    return 1;
+}
+
+static int requireOptions(const struct CommandContext *ctx, const char *const *names)
+{
+    for (int i = 0; names[i] != NULL; i++)
+    {
+        const char *value = commandOption(ctx, names[i]);
+        if (value == NULL || *value == '\0')
         {
-            clearInputBuffer();
+            commandError(ctx, "--%s is required", names[i]);
+            return 0;
         }
-        if (choice != 1)
-            deleteAnother = 0;
     }
+    return 1;
+}
+
+static int parseGpaOption(const struct CommandContext *ctx, float *gpa)
+{
+    const char *text = commandOption(ctx, "gpa");
+    char *end;
+    double value = text ? strtod(text, &end) : -1.0;
+    if (text == NULL || end == text || *end != '\0' || value < 0.0 || value > 4.0)
+    {
+        commandError(ctx, "--gpa must be a number from 0.0 to 4.0");
+        return 0;
+    }
+    *gpa = (float)value;
+    return 1;
 }
 
+static void printStudentRow(const struct StudentRecord *student)
+{
+    struct StudentRecordView view;
+    studentRecordView(student, &view);
+    for (int f = 0; f < STUDENT_FIELD_COUNT; f++)
+    {
+        if (f > 0)
+            putchar('\t');
+        putTsv(view.field[f].ptr, view.field[f].len);
+    }
+    putchar('\n');
+}
+
+static int findCommandStudent(struct CommandContext *ctx, struct StudentRecord *student, long long *recordNumber)
+{
+    static const char *const required[] = {"dept", "id", NULL};
+    if (!requireOptions(ctx, required))
+        return 0;
+    const char *dept = commandOption(ctx, "dept");
+    const char *id = commandOption(ctx, "id");
+    int found = fetchStudentRecord(ctx->students, dept, id, student, recordNumber);
+    if (found < 0)
+    {
+        commandError(ctx, "student index is unavailable");
+        return 0;
+    }
+    if (found == 0)
+    {
+        commandError(ctx, "student '%s' not found in %s", id, dept);
+        return 0;
+    }
+    return 1;
+}
+
+// Applies a student write to the session table if a search has loaded it, so the next search neither misses
+// the change nor reloads. original is NULL for an insert and student NULL for a delete; a write the table
+// cannot take drops it, and the next search loads it afresh.
+static void syncCommandTable(struct CommandContext *ctx, const struct StudentRecord *original,
+                             const struct StudentRecord *student, long long recordNumber)
+{
+    struct StudentTable *table = &ctx->names;
+    struct StudentRecordView view;
+    if (!table->loaded)
+        return;
+    long row = original != NULL ? studentTableFind(table, original->department, original->studentID) : -1;
+    if (student != NULL)
+        studentRecordView(student, &view);
+    int kept;
+    if (original == NULL)
+        kept = studentTableAppend(table, &view, recordNumber) >= 0;
+    else if (row < 0)
+        kept = 0;
+    else if (student == NULL)
+    {
+        studentTableRemove(table, row);
+        kept = 1;
+    }
+    else
+        kept = studentTableReplace(table, row, &view);
+    if (kept)
+        stampStudentTable(table);
+    else
+        table->loaded = 0;
+}
+
+static int studentAddCommand(struct CommandContext *ctx)
+{
+    static const char *const required[] = {"dept", "id", "name", NULL};
+    const char *values[STUDENT_FIELD_COUNT];
+    struct StudentRecord student, existing;
+
+    if (!requireOptions(ctx, required))
+        return 1;
+    for (int f = 0; f < STUDENT_FIELD_COUNT; f++)
+    {
+        values[f] = commandOption(ctx, studentColumns[f]);
+        if (values[f] == NULL)
+            values[f] = "";
+    }
+    if (!isListed(departmentNames, values[FIELD_DEPARTMENT]))
+        return commandError(ctx, "unknown department '%s'", values[FIELD_DEPARTMENT]);
+    if (fillStudentValues(&student, values) > 0)
+        return commandError(ctx, "student details are too long");
+    int found = fetchStudentRecord(ctx->students, values[FIELD_DEPARTMENT], values[FIELD_ID], &existing, NULL);
+    if (found != 0)
+        return commandError(ctx, found > 0 ? "student ID already exists in this department" : "student index is unavailable");
+    long long recordNumber = insertStudentRecord(ctx->students, &student);
+    if (recordNumber < 0)
+        return commandError(ctx, "could not write student data");
+    syncCommandTable(ctx, NULL, &student, recordNumber);
+    const char *key[] = {values[FIELD_DEPARTMENT], values[FIELD_ID]};
+    printCommandOk(ctx, key, 2);
+    return 0;
+}
+
+static int studentGetCommand(struct CommandContext *ctx)
+{
+    struct StudentRecord student;
+    if (!findCommandStudent(ctx, &student, NULL))
+        return 1;
+    printTsvRow(studentColumns, STUDENT_FIELD_COUNT);
+    printStudentRow(&student);
+    return 0;
+}
 
-void manageResults(FILE **resultFile_ptr)
+// Lists a department through the roster index: a full (dept, intake, section) key, or a prefix of it.
+static int studentListCommand(struct CommandContext *ctx)
 {
-    int resultRunning = 1;
-    int select;
-    while (resultRunning)
+    static const char *const required[] = {"dept", NULL};
+    char key[ROSTER_KEY_SIZE];
+    struct RosterIndex roster;
+    long long *recordNumbers = NULL;
+    struct StudentMap map;
+    const struct StudentRecord *records;
+    long long count;
+
+    if (!requireOptions(ctx, required))
+        return 1;
+    const char *dept = commandOption(ctx, "dept");
+    const char *intake = commandOption(ctx, "intake");
+    const char *section = commandOption(ctx, "section");
+    if (section != NULL && intake == NULL)
+        return commandError(ctx, "--section needs --intake");
+    int n = section != NULL  ? snprintf(key, sizeof(key), "%s|%s|%s", dept, intake, section)
+            : intake != NULL ? snprintf(key, sizeof(key), "%s|%s|", dept, intake)
+                             : snprintf(key, sizeof(key), "%s|", dept);
+    if (n < 0 || n >= (int)sizeof(key))
+        return commandError(ctx, "filter is too long");
+    if (!openRosterIndex(&roster, ctx->students))
+        return commandError(ctx, "roster index is unavailable");
+    long long matched = rosterIndexCollect(&roster, key, section == NULL, &recordNumbers);
+    closeRosterIndex(&roster);
+    if (matched < 0 || !mapStudentStore(ctx->students, &map, POSIX_MADV_RANDOM, &records, &count))
     {
-        system("clear || cls");
-        printf("\n\n--- Result Publication Management ---\n");
-        printf("1. Add Student Result\n");
-        printf("2. View Individual Result\n");
-        printf("3. View Result List\n");
-        printf("4. Update Student Result\n");
-        printf("5. Delete Student Result\n");
-        printf("6. Back to Main Menu\n");
-        printf("\nEnter Choice (1-6): ");
+        free(recordNumbers);
+        return commandError(ctx, "could not read student records");
+    }
+    hotPath.recordsScanned += matched;
+    printTsvRow(studentColumns, STUDENT_FIELD_COUNT);
+    for (long long i = 0; i < matched; i++)
+    {
+        if (recordNumbers[i] < count && records[recordNumbers[i]].state == STUDENT_RECORD_LIVE)
+            printStudentRow(&records[recordNumbers[i]]);
+    }
+    unmapStudentFile(&map);
+    free(recordNumbers);
+    return 0;
+}
 
-        if (scanf("%d", &select) != 1)
-        {
-            printf("Invalid input.\n");
-            clearInputBuffer();
-            pressEnterToContinue();
-            continue;
-        }
-        clearInputBuffer();
-        if (*resultFile_ptr == NULL)
-        {
-            fprintf(stderr, "ERROR: Result file pointer is NULL in manageResults.\n");
-            *resultFile_ptr = fopen("results.dat", "rb+");
-            if (*resultFile_ptr == NULL)
-                *resultFile_ptr = fopen("results.dat", "wb+");
-            if (*resultFile_ptr == NULL)
-            {
-                perror("FATAL: Result file inaccessible");
-                exit(EXIT_FAILURE);
-            }
-            printf("INFO: Result file pointer was reopened.\n");
-        }
+// Matches names through the session's student table and its trigram index, so a batch pays for one load.
+static int studentSearchCommand(struct CommandContext *ctx)
+{
+    static const char *const required[] = {"dept", "name", NULL};
+    struct StudentTable *table = &ctx->names;
+    struct StudentRecord student;
+    unsigned int *rows;
 
-        switch (select)
-        {
-        case 1:
-            addResult(resultFile_ptr);
-            break;
-        case 2:
-            viewIndividualResult(resultFile_ptr);
-            break;
-        case 3:
-            viewResultList(resultFile_ptr);
-            break;
-        case 4:
-            updateResult(resultFile_ptr);
-            break;
-        case 5:
-            deleteResult(resultFile_ptr);
-            break;
-        case 6:
-            resultRunning = 0;
-            break;
-        default:
-            printf("Invalid choice (%d). Please enter 1-6.\n", select);
-            break;
-        }
-        if (resultRunning && select >= 1 && select <= 5)
+    if (!requireOptions(ctx, required))
+        return 1;
+    const char *dept = commandOption(ctx, "dept");
+    const char *needle = commandOption(ctx, "name");
+    if (!ensureStudentTable(table, ctx->students))
+        return commandError(ctx, "could not read student records");
+    long matched = searchStudentNames(table, findStudentCode(table, dept), needle, &rows);
+    if (matched < 0)
+        return commandError(ctx, "out of memory while searching student names");
+    printTsvRow(studentColumns, STUDENT_FIELD_COUNT);
+    for (long m = 0; m < matched; m++)
+    {
+        if (!readStudentRow(table, ctx->students, (long)rows[m], &student))
         {
-            pressEnterToContinue();
+            free(rows);
+            table->loaded = 0;
+            return commandError(ctx, "student table is out of date; it will be reloaded");
         }
+        printStudentRow(&student);
     }
+    free(rows);
+    return 0;
 }
 
-void addResult(FILE **resultFile_ptr)
+static int studentUpdateCommand(struct CommandContext *ctx)
 {
-    if (*resultFile_ptr == NULL)
+    const char *values[STUDENT_FIELD_COUNT];
+    struct StudentRecord original, student;
+    long long recordNumber;
+
+    if (!findCommandStudent(ctx, &original, &recordNumber))
+        return 1;
+    for (int f = 0; f < STUDENT_FIELD_COUNT; f++)
     {
-        fprintf(stderr, "ERROR: Result file is not open in addResult.\n");
-        pressEnterToContinue();
-        return;
+        values[f] = commandOption(ctx, studentColumns[f]);
+        if (values[f] == NULL || f == FIELD_DEPARTMENT || f == FIELD_ID)
+            values[f] = (const char *)&original + studentRecordLayout[f].offset;
     }
-    struct StudentResult result;
-    int addMore = 1;
-    while (addMore)
+    if (fillStudentValues(&student, values) > 0)
+        return commandError(ctx, "student details are too long");
+    const char *key[] = {values[FIELD_DEPARTMENT], values[FIELD_ID], "unchanged"};
+    if (memcmp(&student, &original, sizeof(student)) == 0)
     {
-        system("clear || cls");
-        printf("\n--- Add New Student Result ---\n");
-        memset(&result, 0, sizeof(struct StudentResult));
+        printCommandOk(ctx, key, 3);
+        return 0;
+    }
+    int written = updateStudentRecord(ctx->students, recordNumber, &original, &student);
+    if (written <= 0)
+        return commandError(ctx, written == 0 ? "student changed while being updated" : "could not write student data");
+    syncCommandTable(ctx, &original, &student, recordNumber);
+    printCommandOk(ctx, key, 2);
+    return 0;
+}
 
-        printf("Enter Student ID: ");
-        if (!fgets(result.studentID, sizeof(result.studentID), stdin))
-            continue;
-        trimWhitespace(result.studentID);
-        printf("Enter Student Name: ");
-        if (!fgets(result.name, sizeof(result.name), stdin))
-            continue;
-        trimWhitespace(result.name);
-        printf("Enter Intake: ");
-        if (!fgets(result.intake, sizeof(result.intake), stdin))
-            continue;
-        trimWhitespace(result.intake);
-        printf("Enter Section: ");
-        if (!fgets(result.section, sizeof(result.section), stdin))
-            continue;
-        trimWhitespace(result.section);
+static int studentDeleteCommand(struct CommandContext *ctx)
+{
+    struct StudentRecord student;
+    long long recordNumber;
+    if (!findCommandStudent(ctx, &student, &recordNumber))
+        return 1;
+    if (!tombstoneStudentRecord(ctx->students, recordNumber, &student))
+        return commandError(ctx, "could not delete student");
+    syncCommandTable(ctx, &student, NULL, recordNumber);
+    const char *key[] = {student.department, student.studentID};
+    printCommandOk(ctx, key, 2);
+    return 0;
+}
 
-        printf("Enter GPA (0.0-4.0): ");
-        while (scanf("%f", &result.gpa) != 1 || result.gpa < 0.0 || result.gpa > 4.0)
-        {
-            printf("Invalid GPA. Enter 0.0-4.0: ");
-            clearInputBuffer(); 
-        }
-        clearInputBuffer(); 
+static int studentCompactCommand(struct CommandContext *ctx)
+{
+    const char *text = commandOption(ctx, "threshold");
+    char *end = NULL;
+    double threshold = text ? strtod(text, &end) : STUDENT_COMPACT_THRESHOLD;
+    if (text != NULL && (end == text || *end != '\0' || threshold < 0.0 || threshold > 1.0))
+        return commandError(ctx, "--threshold must be a number from 0 to 1");
+    int compacted = compactStudentStore(&ctx->students, threshold);
+    if (compacted != 0)
+        ctx->names.loaded = 0; // record numbers moved; the next search reloads
+    if (compacted < 0)
+        return commandError(ctx, "compaction failed");
+    const char *outcome[] = {compacted ? "compacted" : "skipped"};
+    printCommandOk(ctx, outcome, 1);
+    return 0;
+}
 
-        calculateGrade(result.gpa, result.grade);
+static int studentImportCommand(struct CommandContext *ctx)
+{
+    static const char *const required[] = {"dept", "file", NULL};
+    if (!requireOptions(ctx, required))
+        return 1;
+    const char *dept = commandOption(ctx, "dept");
+    if (!isListed(departmentNames, dept))
+        return commandError(ctx, "unknown department '%s'", dept);
+    long imported, rejected;
+    int ok = importStudentCsv(ctx->students, dept, commandOption(ctx, "file"), stderr, &imported, &rejected);
+    ctx->names.loaded = 0;
+    if (!ok)
+        return commandError(ctx, "import failed; no students were added");
+    char importedText[32], rejectedText[32];
+    snprintf(importedText, sizeof(importedText), "%ld", imported);
+    snprintf(rejectedText, sizeof(rejectedText), "%ld", rejected);
+    const char *counts[] = {importedText, rejectedText};
+    printCommandOk(ctx, counts, 2);
+    return 0;
+}
 
-        if (strlen(result.studentID) == 0 || strlen(result.name) == 0 || strlen(result.intake) == 0 || strlen(result.section) == 0)
-        {
-            printf("\nError: All fields (ID, Name, Intake, Section) are required.\n");
-        }
-        else
+static int studentReindexCommand(struct CommandContext *ctx)
+{
+    if (!rebuildStudentIndex(ctx->students) || !rebuildRosterIndex(ctx->students))
+        return commandError(ctx, "could not rebuild student indexes");
+    printCommandOk(ctx, NULL, 0);
+    return 0;
+}
+
+static void printScheduleRow(const struct AcademicSchedule *schedule)
+{
+    const char *fields[] = {schedule->intake, schedule->section, schedule->scheduleType,
+                            schedule->routineData.day, schedule->routineData.date, schedule->routineData.time,
+                            schedule->routineData.room, schedule->routineData.faculty, schedule->otherDetails};
+    printTsvRow(fields, 9);
+}
+
+// Applies the detail options that suit the entry's type; routine entries carry no free-text details.
+static int copyScheduleOptions(const struct CommandContext *ctx, struct AcademicSchedule *schedule)
+{
+    if (isRoutineType(schedule->scheduleType))
+    {
+        if (commandOption(ctx, "details") != NULL)
         {
-            if (fseek(*resultFile_ptr, 0, SEEK_END) != 0)
-            {
-                perror("Error seeking result file for add");
-            }
-            else
-            {
-                size_t written = fwrite(&result, sizeof(struct StudentResult), 1, *resultFile_ptr);
-                fflush(*resultFile_ptr); 
-                if (written == 1)
-                {
-                    printf("\nResult added successfully. Grade: %s\n", result.grade);
-                }
-                else
-                {
-                    perror("\nError writing result");
-                    clearerr(*resultFile_ptr);
-                }
-            }
+            commandError(ctx, "--details does not apply to '%s'", schedule->scheduleType);
+            return 0;
         }
-        printf("\nOptions:\n1. Add Another Result\n2. Back to Result Menu\nChoice: ");
-        int choice;
-        if (scanf("%d", &choice) != 1)
+        return copyOption(ctx, "day", schedule->routineData.day, sizeof(schedule->routineData.day)) &&
+               copyOption(ctx, "date", schedule->routineData.date, sizeof(schedule->routineData.date)) &&
+               copyOption(ctx, "time", schedule->routineData.time, sizeof(schedule->routineData.time)) &&
+               copyOption(ctx, "room", schedule->routineData.room, sizeof(schedule->routineData.room)) &&
+               copyOption(ctx, "faculty", schedule->routineData.faculty, sizeof(schedule->routineData.faculty));
+    }
+    static const char *const routineOnly[] = {"day", "date", "time", "room", "faculty", NULL};
+    for (int i = 0; routineOnly[i] != NULL; i++)
+    {
+        if (commandOption(ctx, routineOnly[i]) != NULL)
         {
-            choice = 2;
-            clearInputBuffer();
+            commandError(ctx, "--%s only applies to routine types", routineOnly[i]);
+            return 0;
         }
+    }
+    return copyOption(ctx, "details", schedule->otherDetails, sizeof(schedule->otherDetails));
+}
+
+static int scheduleKeyOptions(const struct CommandContext *ctx, struct AcademicSchedule *key, int withType)
+{
+    static const char *const required[] = {"intake", "section", "type", NULL};
+    static const char *const requiredWithoutType[] = {"intake", "section", NULL};
+    memset(key, 0, sizeof(*key));
+    if (!requireOptions(ctx, withType ? required : requiredWithoutType) ||
+        !copyOption(ctx, "intake", key->intake, sizeof(key->intake)) ||
+        !copyOption(ctx, "section", key->section, sizeof(key->section)) ||
+        (withType && !copyOption(ctx, "type", key->scheduleType, sizeof(key->scheduleType))))
+        return 0;
+    if (withType && !isListed(scheduleTypes, key->scheduleType))
+    {
+        commandError(ctx, "unknown schedule type '%s'", key->scheduleType);
+        return 0;
+    }
+    return 1;
+}
+
+// Applies --on-clash to the bookings schedule would overlap: "reject" (the default) fails the command on the
+// first one, "warn" reports each on stderr and lets the write go ahead. Returns 1 to go ahead.
+static int checkScheduleClashes(const struct CommandContext *ctx, const struct AcademicSchedule *schedule, long recordPos)
+{
+    struct ScheduleClash *clashes;
+    char when[64];
+    const char *mode = commandOption(ctx, "on-clash");
+    if (mode != NULL && strcmp(mode, "reject") != 0 && strcmp(mode, "warn") != 0)
+    {
+        commandError(ctx, "--on-clash must be reject or warn");
+        return 0;
+    }
+    int warn = mode != NULL && strcmp(mode, "warn") == 0;
+    long count = findScheduleClashes(ctx->schedules, schedule, recordPos, &clashes);
+    if (count < 0)
+    {
+        commandError(ctx, "could not check for room and faculty clashes");
+        return 0;
+    }
+    for (long i = 0; i < count && (warn || i == 0); i++)
+    {
+        const struct ScheduleClash *clash = &clashes[i];
+        const struct AcademicSchedule *other = &clash->entries[1];
+        const char *kind = clash->kind == BOOKING_ROOM ? "room" : "faculty";
+        formatBookingTime(clash->start, clash->end, when, sizeof(when));
+        if (warn)
+            commandWarning(ctx, "%s '%s' is also booked %s by intake %s section %s (%s)", kind,
+                           bookingName(schedule, clash->kind), when, other->intake, other->section, other->scheduleType);
         else
-        {
-            clearInputBuffer();
-        }
-        if (choice != 1)
-            addMore = 0;
+            commandError(ctx, "%s '%s' is already booked %s by intake %s section %s (%s)%s", kind,
+                         bookingName(schedule, clash->kind), when, other->intake, other->section, other->scheduleType,
+                         count > 1 ? "; more clashes follow, see schedule clashes" : "");
     }
+    free(clashes);
+    return warn || count == 0;
 }
 
-void viewIndividualResult(FILE **resultFile_ptr)
+static int scheduleAddCommand(struct CommandContext *ctx)
 {
-    if (*resultFile_ptr == NULL)
+    struct AcademicSchedule schedule;
+    if (!scheduleKeyOptions(ctx, &schedule, 1) || !copyScheduleOptions(ctx, &schedule))
+        return 1;
+    const char *problem = checkSchedule(&schedule);
+    if (problem != NULL)
+        return commandError(ctx, "%s", problem);
+    if (!checkScheduleClashes(ctx, &schedule, -1))
+        return 1;
+    if (insertScheduleRecord(ctx->schedules, &schedule) < 0)
+        return commandError(ctx, "could not write schedule entry");
+    const char *key[] = {schedule.intake, schedule.section, schedule.scheduleType};
+    printCommandOk(ctx, key, 3);
+    return 0;
+}
+
+static int scheduleListCommand(struct CommandContext *ctx)
+{
+    static const char *const columns[] = {"intake", "section", "type", "day", "date", "time", "room", "faculty", "details"};
+    struct AcademicSchedule key, *schedules;
+
+    if (!scheduleKeyOptions(ctx, &key, 0))
+        return 1;
+    long count = fetchScheduleRecords(ctx->schedules, &key, 0, &schedules, NULL);
+    if (count < 0)
+        return commandError(ctx, "could not read schedule file");
+    printTsvRow(columns, 9);
+    for (long i = 0; i < count; i++)
+        printScheduleRow(&schedules[i]);
+    free(schedules);
+    return 0;
+}
+
+static int scheduleUpdateCommand(struct CommandContext *ctx)
+{
+    struct AcademicSchedule key, schedule;
+    long recordPos;
+    if (!scheduleKeyOptions(ctx, &key, 1))
+        return 1;
+    int found = findScheduleRecord(ctx->schedules, &key, &schedule, &recordPos);
+    if (found <= 0)
+        return commandError(ctx, found == 0 ? "schedule entry not found" : "could not read schedule file");
+    if (!copyScheduleOptions(ctx, &schedule))
+        return 1;
+    const char *problem = checkSchedule(&schedule);
+    if (problem != NULL)
+        return commandError(ctx, "%s", problem);
+    if (!checkScheduleClashes(ctx, &schedule, recordPos))
+        return 1;
+    if (updateScheduleRecord(ctx->schedules, recordPos, &schedule) < 0)
+        return commandError(ctx, "could not write schedule entry");
+    const char *fields[] = {key.intake, key.section, key.scheduleType};
+    printCommandOk(ctx, fields, 3);
+    return 0;
+}
+
+// "schedule clashes": one row per pair of entries booking the same room or faculty at overlapping times.
+static int scheduleClashesCommand(struct CommandContext *ctx)
+{
+    static const char *const columns[] = {"kind", "name", "time", "intake", "section", "type",
+                                          "other_intake", "other_section", "other_type"};
+    struct ScheduleClash *clashes;
+    char when[64];
+    long count = collectScheduleClashes(ctx->schedules, &clashes);
+    if (count < 0)
+        return commandError(ctx, "could not read schedule file");
+    printTsvRow(columns, 9);
+    for (long i = 0; i < count; i++)
     {
-        fprintf(stderr, "ERROR: Result file is not open in viewIndividualResult.\n");
-        pressEnterToContinue();
-        return;
+        const struct AcademicSchedule *first = &clashes[i].entries[0], *other = &clashes[i].entries[1];
+        formatBookingTime(clashes[i].start, clashes[i].end, when, sizeof(when));
+        const char *fields[] = {clashes[i].kind == BOOKING_ROOM ? "room" : "faculty", bookingName(first, clashes[i].kind),
+                                when, first->intake, first->section, first->scheduleType,
+                                other->intake, other->section, other->scheduleType};
+        printTsvRow(fields, 9);
     }
-    struct StudentResult result;
-    char searchID[20], searchIntake[20], searchSection[20];
-    int found = 0;
+    free(clashes);
+    return 0;
+}
 
-    system("clear || cls");
-    printf("\n--- View Individual Student Result ---\n");
-    printf("Enter Student ID: ");
-    if (!fgets(searchID, sizeof(searchID), stdin))
-        return;
-    trimWhitespace(searchID);
-    printf("Enter Intake: ");
-    if (!fgets(searchIntake, sizeof(searchIntake), stdin))
-        return;
-    trimWhitespace(searchIntake);
-    printf("Enter Section: ");
-    if (!fgets(searchSection, sizeof(searchSection), stdin))
-        return;
-    trimWhitespace(searchSection);
+// "schedule timetable": the routine entries matching --room, --faculty and --day, in time order.
+static int scheduleTimetableCommand(struct CommandContext *ctx)
+{
+    static const char *const columns[] = {"when", "intake", "section", "type", "day", "date", "time", "room", "faculty"};
+    struct TimetableEntry *entries;
+    long long ranges[8][2];
+    char when[64];
+    const char *day = commandOption(ctx, "day");
+    if (day != NULL && timetableRanges(day, ranges) == 0)
+        return commandError(ctx, "--day must name a weekday or a date");
+    long count = fetchTimetable(ctx->schedules, commandOption(ctx, "room"), commandOption(ctx, "faculty"), day, &entries);
+    if (count < 0)
+        return commandError(ctx, "could not read schedule file");
+    printTsvRow(columns, 9);
+    for (long i = 0; i < count; i++)
+    {
+        const struct AcademicSchedule *schedule = &entries[i].schedule;
+        formatBookingTime(entries[i].start, entries[i].end, when, sizeof(when));
+        const char *fields[] = {when, schedule->intake, schedule->section, schedule->scheduleType,
+                                schedule->routineData.day, schedule->routineData.date, schedule->routineData.time,
+                                schedule->routineData.room, schedule->routineData.faculty};
+        printTsvRow(fields, 9);
+    }
+    free(entries);
+    return 0;
+}
 
-    if (strlen(searchID) == 0 || strlen(searchIntake) == 0 || strlen(searchSection) == 0)
+// "schedule load": weekly classes and teaching hours per faculty, busiest first.
+static int scheduleLoadCommand(struct CommandContext *ctx)
+{
+    static const char *const columns[] = {"faculty", "classes", "hours"};
+    struct FacultyLoad *loads;
+    char classes[24], hours[24];
+    long count = collectFacultyLoad(ctx->schedules, commandOption(ctx, "faculty"), &loads);
+    if (count < 0)
+        return commandError(ctx, "could not read schedule file");
+    printTsvRow(columns, 3);
+    for (long i = 0; i < count; i++)
     {
-        printf("All search fields required.\n");
-        return;
+        snprintf(classes, sizeof(classes), "%ld", loads[i].classes);
+        snprintf(hours, sizeof(hours), "%.2f", loads[i].minutes / 60.0);
+        const char *fields[] = {loads[i].faculty, classes, hours};
+        printTsvRow(fields, 3);
     }
+    free(loads);
+    return 0;
+}
 
-    rewind(*resultFile_ptr);
-    clearerr(*resultFile_ptr);
-    printf("\n--- Result Details ---\n");
-    while (fread(&result, sizeof(struct StudentResult), 1, *resultFile_ptr) == 1)
+static int scheduleDeleteCommand(struct CommandContext *ctx)
+{
+    struct AcademicSchedule key;
+    if (!scheduleKeyOptions(ctx, &key, 1))
+        return 1;
+    int removed = deleteScheduleRecords(ctx->schedules, &key);
+    if (removed <= 0)
+        return commandError(ctx, removed == 0 ? "schedule entry not found" : "could not delete schedule entry");
+    const char *fields[] = {key.intake, key.section, key.scheduleType};
+    printCommandOk(ctx, fields, 3);
+    return 0;
+}
+
+static void printResultRow(const struct StudentResult *result)
+{
+    char gpa[16];
+    snprintf(gpa, sizeof(gpa), "%.2f", result->gpa);
+    const char *fields[] = {result->studentID, result->name, result->intake, result->section, gpa, result->grade};
+    printTsvRow(fields, 6);
+}
+
+static void printResultHeader(void)
+{
+    static const char *const columns[] = {"id", "name", "intake", "section", "gpa", "grade"};
+    printTsvRow(columns, 6);
+}
+
+static int resultKeyOptions(const struct CommandContext *ctx, struct StudentResult *key, int withId)
+{
+    static const char *const required[] = {"id", "intake", "section", NULL};
+    memset(key, 0, sizeof(*key));
+    return requireOptions(ctx, withId ? required : required + 1) &&
+           copyOption(ctx, "id", key->studentID, sizeof(key->studentID)) &&
+           copyOption(ctx, "intake", key->intake, sizeof(key->intake)) &&
+           copyOption(ctx, "section", key->section, sizeof(key->section));
+}
+
+static int resultAddCommand(struct CommandContext *ctx)
+{
+    static const char *const required[] = {"name", NULL};
+    struct StudentResult result;
+    if (!resultKeyOptions(ctx, &result, 1) || !requireOptions(ctx, required) ||
+        !copyOption(ctx, "name", result.name, sizeof(result.name)) || !parseGpaOption(ctx, &result.gpa))
+        return 1;
+    calculateGrade(result.gpa, result.grade);
+    struct StudentResult existing;
+    int exists = fetchResultRecord(ctx->results, &result, &existing, NULL);
+    if (exists != 0)
+        return commandError(ctx, exists > 0 ? "result already exists; use result update" : "could not read result file");
+    if (!saveResult(ctx->results, -1, NULL, &result))
+        return commandError(ctx, "could not write result");
+    const char *fields[] = {result.studentID, result.intake, result.section, result.grade};
+    printCommandOk(ctx, fields, 4);
+    return 0;
+}
+
+static int resultGetCommand(struct CommandContext *ctx)
+{
+    struct StudentResult key, result;
+    if (!resultKeyOptions(ctx, &key, 1))
+        return 1;
+    int found = fetchResultRecord(ctx->results, &key, &result, NULL);
+    if (found <= 0)
+        return commandError(ctx, found == 0 ? "result not found" : "could not read result file");
+    printResultHeader();
+    printResultRow(&result);
+    return 0;
+}
+
+static int resultListCommand(struct CommandContext *ctx)
+{
+    struct StudentResult key, result;
+    if (!resultKeyOptions(ctx, &key, 0))
+        return 1;
+    rewindData(ctx->results);
+    clearerr(ctx->results);
+    printResultHeader();
+    while (readData(&result, sizeof(result), 1, ctx->results) == 1)
     {
-        if (strcmp(result.studentID, searchID) == 0 &&
-            strcmp(result.intake, searchIntake) == 0 &&
-            strcmp(result.section, searchSection) == 0)
-        {
-            found = 1;
-            printf("\nStudent ID: %s\nName: %s\nIntake: %s\nSection: %s\nGPA: %.2f\nGrade: %s\n",
-                   result.studentID, result.name, result.intake, result.section, result.gpa, result.grade);
-            printf("-----------------------------------\n");
-            break;
-        }
+        hotPath.recordsScanned++;
+        if (strcmp(result.intake, key.intake) == 0 && strcmp(result.section, key.section) == 0)
+            printResultRow(&result);
     }
-    if (ferror(*resultFile_ptr))
+    if (ferror(ctx->results))
     {
-        perror("Error reading result file");
-        clearerr(*resultFile_ptr);
+        clearerr(ctx->results);
+        return commandError(ctx, "could not read result file");
     }
-    if (!found)
-        printf("\nNo result found matching criteria.\n");
+    return 0;
 }
 
-void viewResultList(FILE **resultFile_ptr)
+static int resultRankCommand(struct CommandContext *ctx)
 {
-    if (*resultFile_ptr == NULL)
+    static const char *const required[] = {"intake", NULL};
+    static const char *const columns[] = {"rank", "id", "name", "intake", "section", "gpa", "grade"};
+    struct RankedResult *ranked;
+    if (!requireOptions(ctx, required))
+        return 1;
+    const char *top = commandOption(ctx, "top");
+    char *end = NULL;
+    long topK = top != NULL ? strtol(top, &end, 10) : 0;
+    if (top != NULL && (end == top || *end != '\0' || topK <= 0))
+        return commandError(ctx, "--top must be a positive number");
+    long count = rankResults(ctx->results, commandOption(ctx, "intake"), commandOption(ctx, "section"), topK, &ranked);
+    if (count < 0)
+        return commandError(ctx, "could not read result file");
+    printTsvRow(columns, 7);
+    for (long i = 0; i < count; i++)
     {
-        fprintf(stderr, "ERROR: Result file is not open in viewResultList.\n");
-        pressEnterToContinue();
-        return;
+        const struct StudentResult *r = &ranked[i].result;
+        char rank[24], gpa[16];
+        snprintf(rank, sizeof(rank), "%ld", ranked[i].rank);
+        snprintf(gpa, sizeof(gpa), "%.2f", r->gpa);
+        const char *fields[] = {rank, r->studentID, r->name, r->intake, r->section, gpa, r->grade};
+        printTsvRow(fields, 7);
     }
-    struct StudentResult result;
-    char searchIntake[20], searchSection[20];
-    int found = 0;
+    free(ranked);
+    return 0;
+}
+
+static int resultUpdateCommand(struct CommandContext *ctx)
+{
+    struct StudentResult key, result;
+    long recordPos;
+    float gpa;
+    if (!resultKeyOptions(ctx, &key, 1) || !parseGpaOption(ctx, &gpa))
+        return 1;
+    int found = fetchResultRecord(ctx->results, &key, &result, &recordPos);
+    if (found <= 0)
+        return commandError(ctx, found == 0 ? "result not found" : "could not read result file");
+    struct StudentResult original = result;
+    result.gpa = gpa;
+    calculateGrade(result.gpa, result.grade);
+    if (!saveResult(ctx->results, recordPos, &original, &result))
+        return commandError(ctx, "could not write result");
+    const char *fields[] = {result.studentID, result.intake, result.section, result.grade};
+    printCommandOk(ctx, fields, 4);
+    return 0;
+}
+
+static int resultDeleteCommand(struct CommandContext *ctx)
+{
+    struct StudentResult key;
+    if (!resultKeyOptions(ctx, &key, 1))
+        return 1;
+    int removed = deleteResultRecord(ctx->results, &key);
+    if (removed <= 0)
+        return commandError(ctx, removed == 0 ? "result not found" : "could not delete result");
+    const char *fields[] = {key.studentID, key.intake, key.section};
+    printCommandOk(ctx, fields, 3);
+    return 0;
+}
 
-    system("clear || cls");
-    printf("\n--- View Result List by Intake & Section ---\n");
-    printf("Enter Intake: ");
-    if (!fgets(searchIntake, sizeof(searchIntake), stdin))
-        return;
-    trimWhitespace(searchIntake);
-    printf("Enter Section: ");
-    if (!fgets(searchSection, sizeof(searchSection), stdin))
-        return;
-    trimWhitespace(searchSection);
+static int resultImportCommand(struct CommandContext *ctx)
+{
+    static const char *const required[] = {"file", NULL};
+    if (!requireOptions(ctx, required))
+        return 1;
+    const char *mode = commandOption(ctx, "mode");
+    if (mode != NULL && strcmp(mode, "insert") != 0 && strcmp(mode, "upsert") != 0)
+        return commandError(ctx, "--mode must be insert or upsert");
+    long added, updated, rejected;
+    int upsert = mode != NULL && strcmp(mode, "upsert") == 0;
+    if (!importResultCsv(ctx->results, commandOption(ctx, "file"), upsert, stderr, &added, &updated, &rejected))
+        return commandError(ctx, "import failed; no new results were added");
+    char counts[3][32];
+    snprintf(counts[0], sizeof(counts[0]), "%ld", added);
+    snprintf(counts[1], sizeof(counts[1]), "%ld", updated);
+    snprintf(counts[2], sizeof(counts[2]), "%ld", rejected);
+    const char *fields[] = {counts[0], counts[1], counts[2]};
+    printCommandOk(ctx, fields, 3);
+    return 0;
+}
 
-    if (strlen(searchIntake) == 0 || strlen(searchSection) == 0)
+// "result stats": one "stat<TAB>value" row per figure, read from results.agg rather than results.dat.
+static int resultStatsCommand(struct CommandContext *ctx)
+{
+    static const char *const required[] = {"intake", NULL};
+    static const char *const columns[] = {"stat", "value"};
+    char labels[GPA_HISTOGRAM_BUCKETS][16];
+    long long buckets[GPA_HISTOGRAM_BUCKETS];
+    char name[32], value[32];
+    struct GpaStats stats;
+    if (!requireOptions(ctx, required))
+        return 1;
+    int found = collectGpaStats(ctx->results, commandOption(ctx, "intake"), commandOption(ctx, "section"), &stats);
+    if (found <= 0)
+        return commandError(ctx, found == 0 ? "no results for that intake and section" : "could not read result statistics");
+    const char *fields[] = {name, value};
+    double figures[] = {stats.sum / 100.0 / stats.count, gpaStatsMedian(&stats), gpaStatsDeviation(&stats)};
+    static const char *const figureNames[] = {"mean", "median", "stddev"};
+    printTsvRow(columns, 2);
+    snprintf(name, sizeof(name), "count");
+    snprintf(value, sizeof(value), "%lld", stats.count);
+    printTsvRow(fields, 2);
+    for (int i = 0; i < 3; i++)
     {
-        printf("Intake and Section required.\n");
-        return;
+        snprintf(name, sizeof(name), "%s", figureNames[i]);
+        snprintf(value, sizeof(value), "%.2f", figures[i]);
+        printTsvRow(fields, 2);
     }
-
-    rewind(*resultFile_ptr);
-    clearerr(*resultFile_ptr);
-    printf("\n--- Result List for Intake: %s, Section: %s ---\n\n", searchIntake, searchSection);
-    printf("%-15s %-25s %-8s %-8s\n", "Student ID", "Name", "GPA", "Grade");
-    printf("-------------------------------------------------------------\n");
-    while (fread(&result, sizeof(struct StudentResult), 1, *resultFile_ptr) == 1)
+    for (int g = 0; g < GRADE_COUNT; g++)
     {
-        if (strcmp(result.intake, searchIntake) == 0 && strcmp(result.section, searchSection) == 0)
-        {
-            found = 1;
-            printf("%-15s %-25s %-8.2f %-8s\n", result.studentID, result.name, result.gpa, result.grade);
-        }
+        snprintf(name, sizeof(name), "grade %s", gradeNames[g]);
+        snprintf(value, sizeof(value), "%lld", stats.grades[g]);
+        printTsvRow(fields, 2);
     }
-    if (ferror(*resultFile_ptr))
+    gpaStatsHistogram(&stats, buckets, labels);
+    for (int i = 0; i < GPA_HISTOGRAM_BUCKETS; i++)
     {
-        perror("Error reading result file");
-        clearerr(*resultFile_ptr);
+        snprintf(name, sizeof(name), "gpa %.15s", labels[i]);
+        snprintf(value, sizeof(value), "%lld", buckets[i]);
+        printTsvRow(fields, 2);
     }
-    printf("-------------------------------------------------------------\n");
-    if (!found)
-        printf("\nNo results found matching criteria.\n");
+    return 0;
 }
 
-void updateResult(FILE **resultFile_ptr)
+// "<area> export": streams the whole store, or the rows matching --dept/--intake/--section, as CSV or JSONL
+// to stdout or --out. Only a file export prints an ok line, so stdout stays pure data otherwise.
+static int exportCommand(struct CommandContext *ctx)
 {
-    if (*resultFile_ptr == NULL)
+    struct ExportFilter filter = {commandOption(ctx, "dept"), commandOption(ctx, "intake"), commandOption(ctx, "section")};
+    struct ExportWriter writer;
+    const char *format = commandOption(ctx, "format");
+    const char *outPath = commandOption(ctx, "out");
+    int ok;
+
+    if (format != NULL && strcmp(format, "csv") != 0 && strcmp(format, "jsonl") != 0)
+        return commandError(ctx, "--format must be csv or jsonl");
+    if (filter.department != NULL && !isListed(departmentNames, filter.department))
+        return commandError(ctx, "unknown department '%s'", filter.department);
+    FILE *out = outPath != NULL ? fopen(outPath, "wb") : stdout;
+    if (out == NULL)
+        return commandError(ctx, "could not create '%s': %s", outPath, strerror(errno));
+    ok = openExportWriter(&writer, out, format != NULL && strcmp(format, "jsonl") == 0 ? EXPORT_JSONL : EXPORT_CSV);
+    if (ok)
+        ok = strcmp(ctx->area, "student") == 0    ? exportStudents(ctx->students, &filter, &writer)
+             : strcmp(ctx->area, "schedule") == 0 ? exportSchedules(ctx->schedules, &filter, &writer)
+                                                  : exportResults(ctx->results, &filter, &writer);
+    ok = closeExportWriter(&writer) && ok;
+    if (out != stdout && fclose(out) != 0)
+        ok = 0;
+    if (!ok)
+        return commandError(ctx, "export failed");
+    if (out != stdout)
     {
-        fprintf(stderr, "ERROR: Result file is not open in updateResult.\n");
-        pressEnterToContinue();
-        return;
+        char rows[32];
+        snprintf(rows, sizeof(rows), "%lld", writer.rows);
+        const char *fields[] = {outPath, rows};
+        printCommandOk(ctx, fields, 2);
     }
-    struct StudentResult result; 
-    char searchID[20], searchIntake[20], searchSection[20];
-    int found = 0;
-    long recordPos = -1;
-    float newGPA;
-    int updateAnother = 1;
+    return 0;
+}
 
-    while (updateAnother)
+#define STUDENT_FIELD_OPTIONS "name father mother intake section present permanent blood mobile backup email"
+#define SCHEDULE_DETAIL_OPTIONS "day date time room faculty details"
+static const struct CommandSpec commandSpecs[] = {
+    {"student", "add", "dept id " STUDENT_FIELD_OPTIONS, studentAddCommand},
+    {"student", "get", "dept id", studentGetCommand},
+    {"student", "list", "dept intake section", studentListCommand},
+    {"student", "search", "dept name", studentSearchCommand},
+    {"student", "update", "dept id " STUDENT_FIELD_OPTIONS, studentUpdateCommand},
+    {"student", "delete", "dept id", studentDeleteCommand},
+    {"student", "compact", "threshold", studentCompactCommand},
+    {"student", "reindex", "", studentReindexCommand},
+    {"student", "import", "dept file", studentImportCommand},
+    {"student", "export", "format dept intake section out", exportCommand},
+    {"schedule", "add", "intake section type on-clash " SCHEDULE_DETAIL_OPTIONS, scheduleAddCommand},
+    {"schedule", "list", "intake section", scheduleListCommand},
+    {"schedule", "update", "intake section type on-clash " SCHEDULE_DETAIL_OPTIONS, scheduleUpdateCommand},
+    {"schedule", "delete", "intake section type", scheduleDeleteCommand},
+    {"schedule", "clashes", "", scheduleClashesCommand},
+    {"schedule", "timetable", "room faculty day", scheduleTimetableCommand},
+    {"schedule", "load", "faculty", scheduleLoadCommand},
+    {"schedule", "export", "format intake section out", exportCommand},
+    {"result", "add", "id name intake section gpa", resultAddCommand},
+    {"result", "get", "id intake section", resultGetCommand},
+    {"result", "list", "intake section", resultListCommand},
+    {"result", "rank", "intake section top", resultRankCommand},
+    {"result", "update", "id intake section gpa", resultUpdateCommand},
+    {"result", "delete", "id intake section", resultDeleteCommand},
+    {"result", "import", "file mode", resultImportCommand},
+    {"result", "stats", "intake section", resultStatsCommand},
+    {"result", "export", "format intake section out", exportCommand},
+    {NULL, NULL, NULL, NULL}};
+
+// "stats" prints the counters gathered so far in this process, which is mostly useful as the last line of a
+// batch; "stats reset" zeroes them.
+static int statsCommand(struct CommandContext *ctx)
+{
+    if (ctx->action != NULL && strcmp(ctx->action, "reset") == 0 && ctx->argc == 0)
     {
-        system("clear || cls");
-        printf("\n--- Update Student Result ---\n");
-        printf("Enter Student ID: ");
-        if (!fgets(searchID, sizeof(searchID), stdin))
-            continue;
-        trimWhitespace(searchID);
-        printf("Enter Intake: ");
-        if (!fgets(searchIntake, sizeof(searchIntake), stdin))
-            continue;
-        trimWhitespace(searchIntake);
-        printf("Enter Section: ");
-        if (!fgets(searchSection, sizeof(searchSection), stdin))
-            continue;
-        trimWhitespace(searchSection);
+        resetOperationStats();
+        printCommandOk(ctx, NULL, 0);
+        return 0;
+    }
+    if (ctx->action != NULL)
+        return commandError(ctx, "usage: stats [reset]");
+    writeOperationStats(stdout);
+    return 0;
+}
 
-        if (strlen(searchID) == 0 || strlen(searchIntake) == 0 || strlen(searchSection) == 0)
-        {
-            printf("All search fields required.\n");
-            pressEnterToContinue();
-            continue;
-        }
+int isCommandWord(const char *word)
+{
+    return strcmp(word, "student") == 0 || strcmp(word, "schedule") == 0 || strcmp(word, "result") == 0 ||
+           strcmp(word, "batch") == 0 || strcmp(word, "stats") == 0;
+}
 
-        rewind(*resultFile_ptr);
-        clearerr(*resultFile_ptr);
+// Opens the data file a command's area works on the first time a command needs it.
+static FILE *commandDataFile(struct CommandContext *ctx)
+{
+    FILE **file = strcmp(ctx->area, "student") == 0    ? &ctx->students
+                  : strcmp(ctx->area, "schedule") == 0 ? &ctx->schedules
+                                                       : &ctx->results;
+    if (*file == NULL)
+    {
+        *file = file == &ctx->students ? openStudentData()
+                : file == &ctx->schedules ? openScheduleStore(SCHEDULE_DATA_FILE)
+                                          : openDataFile("results.dat");
+        if (*file == NULL)
+            reportSystemError("Error opening data file");
+    }
+    return *file;
+}
 
-        found = 0;
-        recordPos = -1;
-        while ((recordPos = ftell(*resultFile_ptr)) != -1 &&
-               fread(&result, sizeof(struct StudentResult), 1, *resultFile_ptr) == 1)
-        {
-            if (strcmp(result.studentID, searchID) == 0 &&
-                strcmp(result.intake, searchIntake) == 0 &&
-                strcmp(result.section, searchSection) == 0)
-            {
-                found = 1;
-                printf("\n--- Found Result ---\n");
-                printf("Student: %s (%s)\n", result.name, result.studentID);
-                printf("Current GPA: %.2f, Grade: %s\n", result.gpa, result.grade);
-                break; 
-            }
-        }
-        if (!found && ferror(*resultFile_ptr))
-        {
-            perror("Error reading result file during update search");
-            clearerr(*resultFile_ptr);
-            pressEnterToContinue();
+// Runs one "<area> <action> [--option value]..." command. Returns 0 on success, 1 on failure.
+int runCommand(struct CommandContext *ctx, int argc, char *argv[])
+{
+    ctx->area = argv[0];
+    ctx->action = argc > 1 ? argv[1] : NULL;
+    ctx->argc = argc > 2 ? argc - 2 : 0;
+    ctx->argv = argv + 2;
+    if (strcmp(ctx->area, "stats") == 0)
+        return statsCommand(ctx);
+    for (const struct CommandSpec *spec = commandSpecs; spec->area != NULL; spec++)
+    {
+        if (ctx->action == NULL || strcmp(spec->area, ctx->area) != 0 || strcmp(spec->action, ctx->action) != 0)
             continue;
-        }
+        if (!checkCommandOptions(ctx, spec->options))
+            return 1;
+        if (commandDataFile(ctx) == NULL)
+            return commandError(ctx, "data file is unavailable");
+        struct OperationTimer timer;
+        char operation[48];
+        snprintf(operation, sizeof(operation), "%s %s", spec->area, spec->action);
+        beginOperation(&timer, operation);
+        int status = spec->run(ctx);
+        endOperation(&timer);
+        return status;
+    }
+    return commandError(ctx, "unknown command (areas: student, schedule, result; see README)");
+}
 
-        if (found)
-        {
-            printf("\nEnter New GPA (0.0 - 4.0): ");
-            while (scanf("%f", &newGPA) != 1 || newGPA < 0.0 || newGPA > 4.0)
+// Splits line in place into words. Double quotes group words, and inside them \" and \\ are escapes.
+// Returns the word count, or -1 for an unterminated quote or too many words.
+static int splitCommandLine(char *line, char *argv[], int maxArgs)
+{
+    int argc = 0;
+    char *in = line;
+    hotPath.parseCalls++;
+    while (1)
+    {
+        while (isspace((unsigned char)*in))
+            in++;
+        if (*in == '\0' || *in == '#')
+            return argc;
+        if (argc == maxArgs)
+            return -1;
+        char *out = in;
+        int quoted = 0;
+        argv[argc++] = out;
+        while (*in != '\0' && (quoted || !isspace((unsigned char)*in)))
+        {
+            if (*in == '"')
             {
-                printf("Invalid GPA (0.0-4.0): ");
-                clearInputBuffer();
+                quoted = !quoted;
+                in++;
             }
-            clearInputBuffer(); 
-
-            result.gpa = newGPA;
-            calculateGrade(result.gpa, result.grade);
-            if (fseek(*resultFile_ptr, recordPos, SEEK_SET) != 0)
+            else if (*in == '\\' && quoted && (in[1] == '"' || in[1] == '\\'))
             {
-                perror("Error seeking for result update");
+                *out++ = in[1];
+                in += 2;
             }
             else
             {
-                size_t written = fwrite(&result, sizeof(struct StudentResult), 1, *resultFile_ptr);
-                fflush(*resultFile_ptr); 
-                if (written == 1)
-                {
-                    printf("\nResult updated. New GPA: %.2f, Grade: %s\n", result.gpa, result.grade);
-                }
-                else
-                {
-                    perror("\nError writing result update");
-                    clearerr(*resultFile_ptr);
-                }
+                *out++ = *in++;
             }
         }
-        else
+        if (quoted)
+            return -1;
+        if (*in != '\0')
+            in++;
+        *out = '\0';
+    }
+}
+
+// Runs one command per line, continuing past failures. Returns 0 only if every command succeeded.
+int runCommandFile(struct CommandContext *ctx, FILE *input)
+{
+    char line[COMMAND_LINE_SIZE];
+    char *argv[COMMAND_MAX_ARGS];
+    int status = 0;
+    while (fgets(line, sizeof(line), input) != NULL)
+    {
+        ctx->line++;
+        ctx->area = "batch";
+        ctx->action = NULL;
+        size_t len = strlen(line);
+        if (len == sizeof(line) - 1 && line[len - 1] != '\n')
+        {
+            status = commandError(ctx, "line longer than %d characters", COMMAND_LINE_SIZE - 2);
+            int ch;
+            while ((ch = fgetc(input)) != '\n' && ch != EOF)
+                ;
+            continue;
+        }
+        int argc = splitCommandLine(line, argv, COMMAND_MAX_ARGS);
+        if (argc < 0)
+            status = commandError(ctx, "unterminated quote or too many words");
+        else if (argc > 0 && runCommand(ctx, argc, argv) != 0)
+            status = 1;
+    }
+    return status;
+}
+
+// Command mode takes the admin password from PROJECT_SHOW_PASSWORD, or from the key file named by
+// PROJECT_SHOW_KEY_FILE (default project_show.key), instead of prompting for it.
+int commandAuthorized(void)
+{
+    char buffer[64];
+    const char *password = getenv(PASSWORD_ENV);
+    if (password == NULL)
+    {
+        const char *keyPath = getenv(KEY_FILE_ENV);
+        FILE *keyFile = fopen(keyPath != NULL ? keyPath : DEFAULT_KEY_FILE, "r");
+        if (keyFile != NULL)
         {
-            printf("\nResult not found for ID %s, Intake %s, Section %s.\n", searchID, searchIntake, searchSection);
+            if (fgets(buffer, sizeof(buffer), keyFile) != NULL)
+                password = buffer;
+            fclose(keyFile);
         }
-        printf("\nOptions:\n1. Update Another Result\n2. Back to Result Menu\nChoice: ");
-        int choice;
-        if (scanf("%d", &choice) != 1)
+    }
+    if (password == NULL)
+        return 0;
+    char *end;
+    errno = 0;
+    long long value = strtoll(password, &end, 10);
+    while (isspace((unsigned char)*end))
+        end++;
+    return errno == 0 && end != password && *end == '\0' && value == ADMIN_PASSWORD;
+}
+
+// The maintenance flags that read out or rewrite the data files authenticate the same way as command mode.
+int flagAuthorized(const char *flag)
+{
+    if (commandAuthorized())
+        return 1;
+    reportError("Error: %s needs the admin password; set %s or provide a key file.\n", flag, PASSWORD_ENV);
+    return 0;
+}
+
+// Entry point for "student ...", "schedule ...", "result ..." and "batch [file]": no prompts, no screen
+// clears, TSV on stdout, "error<TAB>line<TAB>command<TAB>message" on stderr.
+int runCommandMode(int argc, char *argv[])
+{
+    struct CommandContext ctx;
+    int status;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.area = argv[0];
+    if (!commandAuthorized())
+        return commandError(&ctx, "set %s or provide a key file to authenticate", PASSWORD_ENV);
+    noticesToStderr = 1;
+    if (strcmp(argv[0], "batch") == 0)
+    {
+        int fromStdin = argc < 2 || strcmp(argv[1], "-") == 0;
+        FILE *input = fromStdin ? stdin : fopen(argv[1], "r");
+        if (input == NULL)
         {
-            choice = 2;
-            clearInputBuffer();
+            reportSystemError("Error opening command file");
+            status = 1;
         }
         else
         {
-            clearInputBuffer();
+            status = runCommandFile(&ctx, input);
+            if (!fromStdin)
+                fclose(input);
         }
-        if (choice != 1)
-            updateAnother = 0;
     }
+    else
+    {
+        status = runCommand(&ctx, argc, argv);
+    }
+    freeStudentTable(&ctx.names);
+    if (ctx.students != NULL)
+        fclose(ctx.students);
+    if (ctx.schedules != NULL)
+        fclose(ctx.schedules);
+    if (ctx.results != NULL)
+        fclose(ctx.results);
+    return status;
 }
 
-void deleteResult(FILE **resultFile_ptr)
+static double elapsedSeconds(const struct timespec *start, const struct timespec *end)
 {
-    if (*resultFile_ptr == NULL)
+    return (double)(end->tv_sec - start->tv_sec) + (double)(end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// The per-line sscanf chain the student functions used before the shared parser, kept as the benchmark baseline.
+static long countStudentsLegacy(FILE *file)
+{
+    char line[512];
+    char trimmedLine[512];
+    char temp_s1[200], temp_s2[100];
+    long records = 0;
+    int readingRecord = 0;
+    rewind(file);
+    while (fgets(line, sizeof(line), file))
     {
-        fprintf(stderr, "ERROR: Result file is not open in deleteResult.\n");
-        pressEnterToContinue();
-        return;
+        strcpy(trimmedLine, line);
+        trimWhitespace(trimmedLine);
+        if (strlen(trimmedLine) == 0)
+        {
+            if (readingRecord)
+                records++;
+            readingRecord = 0;
+            continue;
+        }
+        readingRecord = 1;
+        int matched = sscanf(trimmedLine, "Student Name: %99s %99s", temp_s1, temp_s2) == 2
+                      || sscanf(trimmedLine, "Father's name: %99[^\n]", temp_s1) == 1
+                      || sscanf(trimmedLine, "Mother's name: %99[^\n]", temp_s1) == 1
+                      || sscanf(trimmedLine, "Student ID: %99s", temp_s1) == 1
+                      || sscanf(trimmedLine, "Department: %99s", temp_s1) == 1
+                      || sscanf(trimmedLine, "Intake: %99s", temp_s1) == 1
+                      || sscanf(trimmedLine, "Section: %99s", temp_s1) == 1
+                      || sscanf(trimmedLine, "Present Address: %199[^\n]", temp_s1) == 1
+                      || sscanf(trimmedLine, "Permanent Address: %199[^\n]", temp_s1) == 1
+                      || sscanf(trimmedLine, "Blood Group: %19[^\n]", temp_s1) == 1
+                      || sscanf(trimmedLine, "Mobile number: %19s", temp_s1) == 1
+                      || sscanf(trimmedLine, "Backup Mobile Number: %19s", temp_s1) == 1
+                      || sscanf(trimmedLine, "Email: %99[^\n]", temp_s1) == 1;
+        (void)matched;
     }
-    struct StudentResult result;
-    char deleteID[20], deleteIntake[20], deleteSection[20];
-    int found = 0;
-    int deleteAnother = 1;
+    if (readingRecord)
+        records++;
+    clearerr(file);
+    return records;
+}
 
-    const char *originalFilename = "results.dat";
-    const char *tempFilename = "temp_results.tmp";
+static long countStudentsScanner(FILE *file)
+{
+    struct StudentScanner scanner;
+    struct StudentRecordView record;
+    long records = 0;
+    if (!openStudentScanner(&scanner, file))
+        return -1;
+    while (nextStudentRecord(&scanner, &record))
+        records++;
+    closeStudentScanner(&scanner);
+    return records;
+}
 
-    while (deleteAnother)
+int benchmarkStudentParser(const char *filename)
+{
+    FILE *file = fopen(filename, "r");
+    if (file == NULL)
     {
-        system("clear || cls");
-        printf("\n--- Delete Student Result ---\n");
-        printf("Enter Student ID: ");
-        if (!fgets(deleteID, sizeof(deleteID), stdin))
-            continue;
-        trimWhitespace(deleteID);
-        printf("Enter Intake: ");
-        if (!fgets(deleteIntake, sizeof(deleteIntake), stdin))
-            continue;
-        trimWhitespace(deleteIntake);
-        printf("Enter Section: ");
-        if (!fgets(deleteSection, sizeof(deleteSection), stdin))
-            continue;
-        trimWhitespace(deleteSection);
+        reportSystemError("Error opening student file for benchmark");
+        return 1;
+    }
+    const int passes = 5;
+    const char *labels[2] = {"sscanf chain", "shared parser"};
+    long (*counters[2])(FILE *) = {countStudentsLegacy, countStudentsScanner};
 
-        if (strlen(deleteID) == 0 || strlen(deleteIntake) == 0 || strlen(deleteSection) == 0)
-        {
-            printf("All fields required.\n");
-            pressEnterToContinue();
-            continue;
-        }
-        if (fclose(*resultFile_ptr) != 0)
-        { 
-        }
-        *resultFile_ptr = NULL;
+    printf("Parsing '%s', %d passes each\n", filename, passes);
+    for (int i = 0; i < 2; i++)
+    {
+        struct timespec start, end;
+        long records = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int pass = 0; pass < passes; pass++)
+            records = counters[i](file);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double seconds = elapsedSeconds(&start, &end);
+        double rate = seconds > 0 ? (double)records * passes / seconds : 0.0;
+        printf("%-15s %10ld records  %8.3f s  %12.0f records/sec\n", labels[i], records, seconds, rate);
+    }
+    fclose(file);
+    return 0;
+}
 
-        FILE *resultFile_r = fopen(originalFilename, "rb");
-        FILE *tempFile_w = fopen(tempFilename, "wb");
+static unsigned int benchRandom(unsigned int *state)
+{
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
 
-        if (resultFile_r == NULL || tempFile_w == NULL)
+// Writes test.txt, schedules.dat and results.dat for a synthetic university of the given size in the
+// current directory. Intakes grow with the student count so rosters stay realistically sized.
+int generateBenchData(long students, unsigned int seed)
+{
+    static const char *const firstNames[] = {"Abdul", "Nusrat", "Rahim", "Farhana", "Tanvir", "Sadia", "Imran", "Mim",
+                                             "Arif", "Sumaiya", "Hasan", "Tasnim", "Rakib", "Jannat", "Shakil", "Anika"};
+    static const char *const lastNames[] = {"Rahman", "Hossain", "Islam", "Ahmed", "Khan", "Chowdhury", "Sarkar", "Das",
+                                            "Akter", "Uddin", "Mia", "Begum", "Roy", "Saha", "Karim", "Haque"};
+    static const char *const cities[] = {"Dhaka", "Chattogram", "Sylhet", "Khulna", "Rajshahi", "Barishal"};
+    static const char *const bloodGroups[] = {"A+", "A-", "B+", "B-", "O+", "O-", "AB+", "AB-"};
+    static const char *const days[] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday"};
+    const char *paths[] = {STUDENT_TEXT_FILE, STUDENT_DATA_FILE, SCHEDULE_DATA_FILE, "results.dat"};
+    struct stat info;
+    struct timespec start, end;
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (stat(paths[i], &info) == 0)
         {
-            if (resultFile_r == NULL)
-                perror("Error opening original results file (delete)");
-            if (tempFile_w == NULL)
-                perror("Error creating temp results file (delete)");
-            if (resultFile_r)
-                fclose(resultFile_r);
-            if (tempFile_w)
-                fclose(tempFile_w);
-            remove(tempFilename);
-
-            *resultFile_ptr = fopen(originalFilename, "rb+");
-            if (*resultFile_ptr == NULL)
-                *resultFile_ptr = fopen(originalFilename, "wb+");
-            if (*resultFile_ptr == NULL)
-                exit(EXIT_FAILURE);
-            pressEnterToContinue();
-            return;
+            reportError("Error: %s already exists; generate into an empty directory.\n", paths[i]);
+            return 1;
         }
+    }
+    FILE *text = fopen(STUDENT_TEXT_FILE, "w");
+    FILE *schedules = fopen(SCHEDULE_DATA_FILE, "wb");
+    FILE *results = fopen("results.dat", "wb");
+    if (text == NULL || schedules == NULL || results == NULL)
+    {
+        reportSystemError("Error creating benchmark data files");
+        return 1;
+    }
+    setvbuf(text, NULL, _IOFBF, EXPORT_BUFFER_SIZE);
+    setvbuf(results, NULL, _IOFBF, EXPORT_BUFFER_SIZE);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    int intakes = 10 + (int)(students / 20000);
+    unsigned int state = seed != 0 ? seed : 1;
+    char buffers[STUDENT_FIELD_COUNT][100];
+    char formatted[4096];
+    struct ScheduleFileHeader scheduleHeader;
+    initScheduleHeader(&scheduleHeader);
+    int ok = fwrite(&scheduleHeader, sizeof(scheduleHeader), 1, schedules) == 1;
+    for (long i = 0; ok && i < students; i++)
+    {
+        const char *values[STUDENT_FIELD_COUNT];
+        const char *first = firstNames[benchRandom(&state) % 16];
+        const char *last = lastNames[benchRandom(&state) % 16];
+        const char *father = firstNames[benchRandom(&state) % 16];
+        const char *city = cities[benchRandom(&state) % 6];
+        struct StudentRecord student;
+        struct StudentRecordView view;
+        struct StudentResult result;
+
+        snprintf(buffers[FIELD_NAME], 100, "%s %s", first, last);
+        snprintf(buffers[FIELD_FATHER], 100, "%s %s", father, last);
+        snprintf(buffers[FIELD_MOTHER], 100, "%s %s", firstNames[benchRandom(&state) % 16], lastNames[benchRandom(&state) % 16]);
+        snprintf(buffers[FIELD_ID], 100, "%ld", 20000000L + i);
+        snprintf(buffers[FIELD_INTAKE], 100, "%u", 40 + benchRandom(&state) % (unsigned int)intakes);
+        snprintf(buffers[FIELD_SECTION], 100, "%u", 1 + benchRandom(&state) % 5);
+        snprintf(buffers[FIELD_PRESENT_ADDRESS], 100, "House %u, Road %u, %s", benchRandom(&state) % 200,
+                 benchRandom(&state) % 30, city);
+        snprintf(buffers[FIELD_PERMANENT_ADDRESS], 100, "Village %u, %s", benchRandom(&state) % 500,
+                 cities[benchRandom(&state) % 6]);
+        snprintf(buffers[FIELD_MOBILE], 100, "017%08u", benchRandom(&state) % 100000000);
+        snprintf(buffers[FIELD_BACKUP_MOBILE], 100, "018%08u", benchRandom(&state) % 100000000);
+        snprintf(buffers[FIELD_EMAIL], 100, "s%ld@bubt.edu", 20000000L + i);
+        for (int f = 0; f < STUDENT_FIELD_COUNT; f++)
+            values[f] = buffers[f];
+        values[FIELD_DEPARTMENT] = departmentNames[benchRandom(&state) % 4];
+        values[FIELD_BLOOD_GROUP] = bloodGroups[benchRandom(&state) % 8];
+        fillStudentValues(&student, values);
+        studentRecordView(&student, &view);
+        size_t len = formatStudentRecord(formatted, sizeof(formatted), &view);
+        ok = len > 0 && fwrite(formatted, 1, len, text) == len && fputc('\n', text) != EOF;
+
+        memset(&result, 0, sizeof(result));
+        snprintf(result.studentID, sizeof(result.studentID), "%.19s", buffers[FIELD_ID]);
+        snprintf(result.name, sizeof(result.name), "%s", buffers[FIELD_NAME]);
+        snprintf(result.intake, sizeof(result.intake), "%.19s", buffers[FIELD_INTAKE]);
+        snprintf(result.section, sizeof(result.section), "%.19s", buffers[FIELD_SECTION]);
+        result.gpa = (float)(200 + benchRandom(&state) % 201) / 100.0f;
+        calculateGrade(result.gpa, result.grade);
+        ok = ok && fwrite(&result, sizeof(result), 1, results) == 1;
+    }
 
-        found = 0;
-        while (fread(&result, sizeof(struct StudentResult), 1, resultFile_r) == 1)
+    // One entry of every schedule type for each intake and section.
+    long scheduleCount = 0;
+    for (int intake = 0; ok && intake < intakes; intake++)
+    {
+        for (int section = 1; ok && section <= 5; section++)
         {
-            if (strcmp(result.studentID, deleteID) == 0 &&
-                strcmp(result.intake, deleteIntake) == 0 &&
-                strcmp(result.section, deleteSection) == 0)
-            {
-                found = 1; 
-            }
-            else
+            for (int type = 0; ok && scheduleTypes[type] != NULL; type++)
             {
-                if (fwrite(&result, sizeof(struct StudentResult), 1, tempFile_w) != 1)
+                struct AcademicSchedule schedule;
+                memset(&schedule, 0, sizeof(schedule));
+                snprintf(schedule.intake, sizeof(schedule.intake), "%d", 40 + intake);
+                snprintf(schedule.section, sizeof(schedule.section), "%d", section);
+                snprintf(schedule.scheduleType, sizeof(schedule.scheduleType), "%s", scheduleTypes[type]);
+                if (isRoutineType(schedule.scheduleType))
                 {
-                    perror("Error writing to temp results file");
-                    break;
+                    struct RoutineInfo *routine = &schedule.routineData;
+                    snprintf(routine->day, sizeof(routine->day), "%s", days[benchRandom(&state) % 5]);
+                    snprintf(routine->date, sizeof(routine->date), "2026-%02u-%02u", 1 + benchRandom(&state) % 12,
+                             1 + benchRandom(&state) % 28);
+                    snprintf(routine->time, sizeof(routine->time), "%02u:00", 8 + benchRandom(&state) % 9);
+                    snprintf(routine->room, sizeof(routine->room), "%u", 200 + benchRandom(&state) % 400);
+                    snprintf(routine->faculty, sizeof(routine->faculty), "%s %s", firstNames[benchRandom(&state) % 16],
+                             lastNames[benchRandom(&state) % 16]);
+                }
+                else
+                {
+                    snprintf(schedule.otherDetails, sizeof(schedule.otherDetails), "%s for intake %d section %d",
+                             schedule.scheduleType, 40 + intake, section);
                 }
+                ok = appendScheduleRecord(schedules, &schedule);
+                scheduleCount++;
             }
         }
-        if (ferror(resultFile_r))
-            perror("Error reading original results file (delete)");
+    }
+    if (fclose(text) != 0 || fclose(schedules) != 0 || fclose(results) != 0)
+        ok = 0;
+    if (!ok)
+    {
+        reportSystemError("Error writing benchmark data");
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("Generated %ld students (%s), %ld schedules and %ld results in %.2f s\n", students, STUDENT_TEXT_FILE,
+           scheduleCount, students, elapsedSeconds(&start, &end));
+    return 0;
+}
 
-        fclose(resultFile_r);
-        fclose(tempFile_w);
+enum BenchOperation
+{
+    BENCH_STUDENT_LIST,
+    BENCH_STUDENT_GET,
+    BENCH_STUDENT_SEARCH,
+    BENCH_STUDENT_ROSTER,
+    BENCH_STUDENT_ADD,
+    BENCH_STUDENT_UPDATE,
+    BENCH_STUDENT_DELETE,
+    BENCH_SCHEDULE_LIST,
+    BENCH_SCHEDULE_ADD,
+    BENCH_SCHEDULE_UPDATE,
+    BENCH_SCHEDULE_DELETE,
+    BENCH_RESULT_GET,
+    BENCH_RESULT_LIST,
+    BENCH_RESULT_ADD,
+    BENCH_RESULT_UPDATE,
+    BENCH_RESULT_DELETE,
+    BENCH_OPERATION_COUNT
+};
 
-        if (found)
+// Keys sampled evenly from the data files, so reads hit records that exist.
+struct BenchSample
+{
+    long students, schedules, results;
+    struct StudentRecord student[BENCH_SAMPLES];
+    struct AcademicSchedule schedule[BENCH_SAMPLES];
+    struct StudentResult result[BENCH_SAMPLES];
+};
+
+static void sampleBenchData(struct CommandContext *ctx, struct BenchSample *sample)
+{
+    struct StudentMap map;
+    const struct StudentRecord *records;
+    long long count;
+    sample->students = sample->schedules = sample->results = 0;
+    if (mapStudentStore(ctx->students, &map, POSIX_MADV_RANDOM, &records, &count))
+    {
+        for (long long i = 0; i < count && sample->students < BENCH_SAMPLES; i += count / BENCH_SAMPLES + 1)
         {
-            if (remove(originalFilename) != 0)
-            {
-                perror("Error deleting original results file");
-                fprintf(stderr, "Temp data in '%s'\n", tempFilename);
-            }
-            else if (rename(tempFilename, originalFilename) != 0)
-            {
-                perror("Error renaming temp results file");
-                fprintf(stderr, "CRITICAL Error: Original deleted, rename failed. Data lost. Temp file '%s'\n", tempFilename);
-            }
-            else
-            {
-                printf("\nResult deleted successfully.\n");
-            }
+            if (records[i].state == STUDENT_RECORD_LIVE)
+                sample->student[sample->students++] = records[i];
         }
-        else
+        unmapStudentFile(&map);
+    }
+    size_t pos, first;
+    if (mapScheduleStore(ctx->schedules, &map, POSIX_MADV_RANDOM, &first))
+    {
+        struct AcademicSchedule schedule;
+        long long n = 0;
+        int got;
+        for (pos = first; nextScheduleRecord(&map, &pos, &schedule, NULL) != 0;)
+            n++;
+        long long i = 0;
+        for (pos = first; sample->schedules < BENCH_SAMPLES && (got = nextScheduleRecord(&map, &pos, &schedule, NULL)) != 0; i++)
+        {
+            if (got > 0 && i % (n / BENCH_SAMPLES + 1) == 0)
+                sample->schedule[sample->schedules++] = schedule;
+        }
+        unmapStudentFile(&map);
+    }
+    if (mapStudentFile(ctx->results, &map, POSIX_MADV_RANDOM))
+    {
+        long long n = (long long)(map.length / sizeof(struct StudentResult));
+        for (long long i = 0; i < n && sample->results < BENCH_SAMPLES; i += n / BENCH_SAMPLES + 1)
         {
-            printf("\nResult not found. No changes made.\n");
-            remove(tempFilename);
+            if (!FIXED_RECORD_DEAD(&((const struct StudentResult *)map.data)[i]))
+                sample->result[sample->results++] = ((const struct StudentResult *)map.data)[i];
         }
+        unmapStudentFile(&map);
+    }
+}
 
+// The command line for iteration i of op. Writes add, update and delete the same "BENCH<i>" keys, so a full
+// run leaves the data as it found it apart from tombstones. Returns 0 if op has nothing to sample.
+static int benchCommandLine(char *line, size_t size, int op, long i, const struct BenchSample *sample)
+{
+    const struct StudentRecord *s = &sample->student[sample->students > 0 ? i % sample->students : 0];
+    const struct AcademicSchedule *c = &sample->schedule[sample->schedules > 0 ? i % sample->schedules : 0];
+    const struct StudentResult *r = &sample->result[sample->results > 0 ? i % sample->results : 0];
+    char firstName[100] = "";
+
+    if ((op <= BENCH_STUDENT_ROSTER && sample->students == 0) || (op == BENCH_SCHEDULE_LIST && sample->schedules == 0) ||
+        ((op == BENCH_RESULT_GET || op == BENCH_RESULT_LIST) && sample->results == 0))
+        return 0;
+    sscanf(s->name, "%99s", firstName);
+    switch (op)
+    {
+    case BENCH_STUDENT_LIST:
+        return snprintf(line, size, "student list --dept %s", s->department) > 0;
+    case BENCH_STUDENT_GET:
+        return snprintf(line, size, "student get --dept %s --id %s", s->department, s->studentID) > 0;
+    case BENCH_STUDENT_SEARCH:
+        return snprintf(line, size, "student search --dept %s --name %s", s->department, firstName) > 0;
+    case BENCH_STUDENT_ROSTER:
+        return snprintf(line, size, "student list --dept %s --intake %s --section %s", s->department, s->intake,
+                        s->section) > 0;
+    case BENCH_STUDENT_ADD:
+        return snprintf(line, size, "student add --dept CSE --id BENCH%ld --name \"Bench Student\" --intake 99 --section 1", i) > 0;
+    case BENCH_STUDENT_UPDATE:
+        return snprintf(line, size, "student update --dept CSE --id BENCH%ld --mobile 01700000000", i) > 0;
+    case BENCH_STUDENT_DELETE:
+        return snprintf(line, size, "student delete --dept CSE --id BENCH%ld", i) > 0;
+    case BENCH_SCHEDULE_LIST:
+        return snprintf(line, size, "schedule list --intake %s --section %s", c->intake, c->section) > 0;
+    case BENCH_SCHEDULE_ADD:
+        return snprintf(line, size, "schedule add --intake BENCH%ld --section 1 --type \"Other Event\" --details bench", i) > 0;
+    case BENCH_SCHEDULE_UPDATE:
+        return snprintf(line, size, "schedule update --intake BENCH%ld --section 1 --type \"Other Event\" --details updated", i) > 0;
+    case BENCH_SCHEDULE_DELETE:
+        return snprintf(line, size, "schedule delete --intake BENCH%ld --section 1 --type \"Other Event\"", i) > 0;
+    case BENCH_RESULT_GET:
+        return snprintf(line, size, "result get --id %s --intake %s --section %s", r->studentID, r->intake, r->section) > 0;
+    case BENCH_RESULT_LIST:
+        return snprintf(line, size, "result list --intake %s --section %s", r->intake, r->section) > 0;
+    case BENCH_RESULT_ADD:
+        return snprintf(line, size, "result add --id BENCH%ld --name Bench --intake 99 --section 1 --gpa 3.5", i) > 0;
+    case BENCH_RESULT_UPDATE:
+        return snprintf(line, size, "result update --id BENCH%ld --intake 99 --section 1 --gpa 3.0", i) > 0;
+    case BENCH_RESULT_DELETE:
+        return snprintf(line, size, "result delete --id BENCH%ld --intake 99 --section 1", i) > 0;
+    }
+    return 0;
+}
 
-        *resultFile_ptr = fopen(originalFilename, "rb+");
-        if (*resultFile_ptr == NULL)
-            *resultFile_ptr = fopen(originalFilename, "wb+");
-        if (*resultFile_ptr == NULL)
-        {
-            perror("FATAL: Could not reopen result file after delete");
-            exit(EXIT_FAILURE);
-        }
-
+static int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
 
-        printf("\nOptions:\n1. Delete Another Result\n2. Back to Result Menu\nChoice: ");
-        int choice;
-        if (scanf("%d", &choice) != 1)
-        {
-            choice = 2;
-            clearInputBuffer();
-        }
-        else
-        {
-            clearInputBuffer();
+// Times every student, schedule and result operation through the command dispatcher against the data in
+// the current directory, iterations times each (lists a twentieth as often), with their output discarded.
+int runBenchmark(long iterations)
+{
+    static const char *const labels[BENCH_OPERATION_COUNT] = {
+        "student list", "student get", "student search", "student roster", "student add", "student update",
+        "student delete", "schedule list", "schedule add", "schedule update", "schedule delete", "result get",
+        "result list", "result add", "result update", "result delete"};
+    struct CommandContext ctx;
+    struct BenchSample *sample = malloc(sizeof(struct BenchSample));
+    double *latencies = malloc((size_t)iterations * sizeof(double));
+    char line[COMMAND_LINE_SIZE];
+    char *argv[COMMAND_MAX_ARGS];
+    struct timespec start, end;
+    struct rusage usage;
+
+    memset(&ctx, 0, sizeof(ctx));
+    noticesToStderr = 1;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ctx.students = openStudentData();
+    ctx.schedules = openScheduleStore(SCHEDULE_DATA_FILE);
+    ctx.results = openDataFile("results.dat");
+    FILE *devNull = fopen("/dev/null", "w");
+    int savedStdout = dup(STDOUT_FILENO);
+    if (sample == NULL || latencies == NULL || ctx.students == NULL || ctx.schedules == NULL || ctx.results == NULL ||
+        devNull == NULL || savedStdout < 0)
+    {
+        reportSystemError("Error setting up benchmark");
+        return 1;
+    }
+    sampleBenchData(&ctx, sample);
+    // Warm every index the timed operations read or patch, and the search table, so a stale index is rebuilt
+    // here rather than inside the first timed operation.
+    fflush(stdout);
+    dup2(fileno(devNull), STDOUT_FILENO);
+    static const int warmOps[] = {BENCH_STUDENT_GET, BENCH_STUDENT_ROSTER, BENCH_STUDENT_SEARCH, BENCH_SCHEDULE_LIST,
+                                  BENCH_RESULT_GET};
+    for (size_t w = 0; w < sizeof(warmOps) / sizeof(warmOps[0]); w++)
+    {
+        int warmArgc = benchCommandLine(line, sizeof(line), warmOps[w], 0, sample) ? splitCommandLine(line, argv, COMMAND_MAX_ARGS) : 0;
+        if (warmArgc > 0)
+            runCommand(&ctx, warmArgc, argv);
+    }
+    struct ClashIndex clashIndex;
+    struct ResultStats resultStats;
+    if (openClashIndex(&clashIndex, ctx.schedules))
+        closeClashIndex(&clashIndex);
+    if (openResultStats(&resultStats, ctx.results))
+        closeResultStats(&resultStats);
+    fflush(stdout);
+    dup2(savedStdout, STDOUT_FILENO);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("Setup (open, convert, index) %.3f s; %ld students, %ld schedules, %ld results sampled\n\n",
+           elapsedSeconds(&start, &end), sample->students, sample->schedules, sample->results);
+    printf("%-16s %8s %12s %10s %10s %8s\n", "operation", "ops", "ops/sec", "p50 ms", "p99 ms", "failed");
+
+    for (int op = 0; op < BENCH_OPERATION_COUNT; op++)
+    {
+        int isList = op == BENCH_STUDENT_LIST || op == BENCH_STUDENT_SEARCH || op == BENCH_SCHEDULE_LIST ||
+                     op == BENCH_RESULT_LIST;
+        long runs = isList ? iterations / 20 + 1 : iterations;
+        long done = 0, failed = 0;
+        double total = 0.0;
+        fflush(stdout);
+        dup2(fileno(devNull), STDOUT_FILENO);
+        for (long i = 0; i < runs; i++)
+        {
+            if (!benchCommandLine(line, sizeof(line), op, i, sample))
+                break;
+            int argc = splitCommandLine(line, argv, COMMAND_MAX_ARGS);
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            if (argc <= 0 || runCommand(&ctx, argc, argv) != 0)
+                failed++;
+            fflush(stdout);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            latencies[done] = elapsedSeconds(&start, &end);
+            total += latencies[done++];
+        }
+        fflush(stdout);
+        dup2(savedStdout, STDOUT_FILENO);
+        if (done == 0)
+        {
+            printf("%-16s %8s\n", labels[op], "skipped");
+            continue;
         }
-        if (choice != 1)
-            deleteAnother = 0;
+        qsort(latencies, (size_t)done, sizeof(double), compareDoubles);
+        printf("%-16s %8ld %12.0f %10.3f %10.3f %8ld\n", labels[op], done, total > 0 ? (double)done / total : 0.0,
+               latencies[(done - 1) / 2] * 1000.0, latencies[(done - 1) * 99 / 100] * 1000.0, failed);
     }
+    getrusage(RUSAGE_SELF, &usage);
+    printf("\nPeak RSS %ld KB\n", usage.ru_maxrss);
+
+    close(savedStdout);
+    fclose(devNull);
+    freeStudentTable(&ctx.names);
+    if (ctx.students != NULL)
+        fclose(ctx.students);
+    if (ctx.schedules != NULL)
+        fclose(ctx.schedules);
+    if (ctx.results != NULL)
+        fclose(ctx.results);
+    free(latencies);
+    free(sample);
+    return 0;
 }